@@ -94,6 +94,19 @@ base_uint<BITS>& base_uint<BITS>::operator/=(const base_uint& b)
         throw uint_error("Division by zero");
     if (div_bits > num_bits) // the result is certainly 0.
         return *this;
+    // EXOSIS BEGIN
+    if (div_bits <= 32) {
+        // Single word divisor (averaging and retargeting), divide one word at a time.
+        const uint64_t d = div.pn[0];
+        uint64_t rem = 0;
+        for (int i = WIDTH - 1; i >= 0; i--) {
+            const uint64_t n = (rem << 32) | num.pn[i];
+            pn[i] = n / d;
+            rem = n % d;
+        }
+        return *this;
+    }
+    // EXOSIS END
     int shift = num_bits - div_bits;
     div <<= shift; // shift so that div and num align.
     while (shift >= 0) {
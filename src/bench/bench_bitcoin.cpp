@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 
 #include <crypto/sha256.h>
+#include <crypto/x16r.h>
 #include <key.h>
 #include <util/system.h>
 #include <util/strencodings.h>
@@ -63,6 +64,7 @@ int main(int argc, char** argv)
     const fs::path bench_datadir{SetDataDir()};
 
     SHA256AutoDetect();
+    X16RAutoDetect();
     ECC_Start();
     SetupEnvironment();
 
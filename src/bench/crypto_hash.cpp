@@ -9,12 +9,14 @@
 #include <hash.h>
 #include <random.h>
 #include <uint256.h>
+#include <primitives/block.h>
 #include <util/time.h>
 #include <crypto/ripemd160.h>
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
+#include <crypto/x16r.h>
 
 /* Number of bytes to hash per iteration */
 static const uint64_t BUFFER_SIZE = 1000*1000;
@@ -78,6 +80,43 @@ static void SipHash_32b(benchmark::State& state)
     }
 }
 
+static void TimeTravel_BlockHeader(benchmark::State& state)
+{
+    // Header sync and block index loading hash headers with ever changing block times
+    CBlockHeader header;
+    header.nVersion = ALGO_EXOSIS;
+    header.nTime = 1538556426;
+    while (state.KeepRunning()) {
+        ++header.nTime;
+        header.GetHash();
+    }
+}
+
+static void X16R_BlockHeader(benchmark::State& state)
+{
+    CBlockHeader header;
+    header.nVersion = ALGO_X16R;
+    header.hashPrevBlock = uint256S("fedcba98765432100123456789abcdeffedcba98765432100123456789abcdef");
+    const X16RHasher hasher(header.hashPrevBlock);
+    while (state.KeepRunning()) {
+        header.GetPoWHash(hasher);
+        header.nNonce++;
+    }
+}
+
+static void X16R_BlockHeader_Lanes(benchmark::State& state)
+{
+    CBlockHeader header;
+    header.nVersion = ALGO_X16R;
+    header.hashPrevBlock = uint256S("fedcba98765432100123456789abcdeffedcba98765432100123456789abcdef");
+    const X16RHasher hasher(header.hashPrevBlock);
+    uint256 powHashes[X16R_LANES];
+    while (state.KeepRunning()) {
+        header.GetPoWHashes(hasher, powHashes);
+        header.nNonce += X16R_LANES;
+    }
+}
+
 static void FastRandom_32bit(benchmark::State& state)
 {
     FastRandomContext rng(true);
@@ -102,5 +141,8 @@ BENCHMARK(SHA512, 330);
 BENCHMARK(SHA256_32b, 4700 * 1000);
 BENCHMARK(SipHash_32b, 40 * 1000 * 1000);
 BENCHMARK(SHA256D64_1024, 7400);
+BENCHMARK(TimeTravel_BlockHeader, 60 * 1000);
+BENCHMARK(X16R_BlockHeader, 60 * 1000);
+BENCHMARK(X16R_BlockHeader_Lanes, 15 * 1000);
 BENCHMARK(FastRandom_32bit, 110 * 1000 * 1000);
 BENCHMARK(FastRandom_1bit, 440 * 1000 * 1000);
@@ -0,0 +1,101 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <streams.h>
+#include <version.h>
+
+#include <vector>
+
+// Blocks and coins dominated by 100000 coin outputs, which go through the
+// masternode collateral check on every (de)serialization.
+
+static CScript RandomP2PKH(FastRandomContext& ctx)
+{
+    const std::vector<unsigned char> vchHash = ctx.randbytes(20);
+    return CScript() << OP_DUP << OP_HASH160 << vchHash << OP_EQUALVERIFY << OP_CHECKSIG;
+}
+
+static CPubKey RandomPubKey(FastRandomContext& ctx)
+{
+    std::vector<unsigned char> vch = ctx.randbytes(CPubKey::COMPRESSED_PUBLIC_KEY_SIZE);
+    vch[0] = 0x02;
+    return CPubKey(vch);
+}
+
+static CBlock CollateralBlock()
+{
+    FastRandomContext ctx(true);
+    CBlock block;
+    for (int i = 0; i < 200; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(ctx.rand256(), 0);
+        for (int o = 0; o < 10; o++) {
+            if (o % 2) {
+                tx.vout.emplace_back(100000 * COIN, RandomP2PKH(ctx), "10.0.0.1", RandomPubKey(ctx));
+            } else {
+                tx.vout.emplace_back(100000 * COIN, RandomP2PKH(ctx));
+            }
+        }
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+    return block;
+}
+
+static void SerializeCollateralBlock(benchmark::State& state)
+{
+    const CBlock block = CollateralBlock();
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+
+    while (state.KeepRunning()) {
+        stream << block;
+        stream.clear();
+    }
+}
+
+static void DeserializeCollateralBlock(benchmark::State& state)
+{
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << CollateralBlock();
+    const size_t nSize = stream.size();
+    char a = '\0';
+    stream.write(&a, 1); // Prevent compaction
+
+    while (state.KeepRunning()) {
+        CBlock block;
+        stream >> block;
+        bool rewound = stream.Rewind(nSize);
+        assert(rewound);
+    }
+}
+
+static void SerializeCollateralCoins(benchmark::State& state)
+{
+    const CBlock block = CollateralBlock();
+    std::vector<Coin> vCoins;
+    for (const CTransactionRef& tx : block.vtx) {
+        for (const CTxOut& txout : tx->vout) {
+            vCoins.emplace_back(CTxOut(txout), 1, false);
+        }
+    }
+    CDataStream stream(SER_DISK, 0);
+
+    while (state.KeepRunning()) {
+        for (const Coin& coin : vCoins) {
+            stream << coin;
+        }
+        for (Coin& coin : vCoins) {
+            stream >> coin;
+        }
+        assert(stream.empty());
+    }
+}
+
+BENCHMARK(SerializeCollateralBlock, 150);
+BENCHMARK(DeserializeCollateralBlock, 50);
+BENCHMARK(SerializeCollateralCoins, 50);
@@ -143,6 +143,21 @@ public:
         return true;
     }
 
+    // EXOSIS BEGIN
+    /// Same as Get() but also moves the item to the front, so that the
+    /// least recently used item is pruned first
+    bool GetAndRefresh(const K& key, V& value)
+    {
+        map_it it = mapIndex.find(key);
+        if(it == mapIndex.end()) {
+            return false;
+        }
+        listItems.splice(listItems.begin(), listItems, it->second);
+        value = it->second->value;
+        return true;
+    }
+    // EXOSIS END
+
     void Erase(const K& key)
     {
         map_it it = mapIndex.find(key);
@@ -168,6 +168,10 @@ enum BlockStatus: uint32_t {
     BLOCK_FAILED_MASK        =   BLOCK_FAILED_VALID | BLOCK_FAILED_CHILD,
 
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
+
+    // EXOSIS BEGIN
+    BLOCK_POW_VERIFIED      =   256, //!< header proof-of-work was verified, no need to recompute it when loading the block index
+    // EXOSIS END
 };
 
 /** The block chain is a tree shaped structure starting with the
@@ -315,6 +319,9 @@ public:
         block.nNonce         = nNonce;
         // EXOSIS BEGIN
         block.nMoneySupply   = nMoneySupply;
+        // We already know the identity hash, spare the TimeTravel evaluation
+        if (phashBlock)
+            block.hashCache.Set(BEGIN(block.nVersion), *phashBlock);
         // EXOSIS END
         return block;
     }
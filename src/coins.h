@@ -13,6 +13,9 @@
 #include <memusage.h>
 #include <serialize.h>
 #include <uint256.h>
+// EXOSIS BEGIN
+#include <util/hasher.h>
+// EXOSIS END
 
 #include <assert.h>
 #include <stdint.h>
@@ -77,28 +80,33 @@ public:
     }
 
     size_t DynamicMemoryUsage() const {
-        return memusage::DynamicUsage(out.scriptPubKey);
+        // EXOSIS BEGIN
+        //return memusage::DynamicUsage(out.scriptPubKey);
+        return RecursiveDynamicUsage(out);
+        // EXOSIS END
     }
 };
 
-class SaltedOutpointHasher
-{
-private:
-    /** Salt */
-    const uint64_t k0, k1;
-
-public:
-    SaltedOutpointHasher();
-
-    /**
-     * This *must* return size_t. With Boost 1.46 on 32-bit systems the
-     * unordered_map will behave unpredictably if the custom hasher returns a
-     * uint64_t, resulting in failures when syncing the chain (#4634).
-     */
-    size_t operator()(const COutPoint& id) const {
-        return SipHashUint256Extra(k0, k1, id.hash, id.n);
-    }
-};
+// EXOSIS BEGIN
+//class SaltedOutpointHasher
+//{
+//private:
+//    /** Salt */
+//    const uint64_t k0, k1;
+//
+//public:
+//    SaltedOutpointHasher();
+//
+//    /**
+//     * This *must* return size_t. With Boost 1.46 on 32-bit systems the
+//     * unordered_map will behave unpredictably if the custom hasher returns a
+//     * uint64_t, resulting in failures when syncing the chain (#4634).
+//     */
+//    size_t operator()(const COutPoint& id) const {
+//        return SipHashUint256Extra(k0, k1, id.hash, id.n);
+//    }
+//};
+// EXOSIS END
 
 struct CCoinsCacheEntry
 {
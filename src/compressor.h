@@ -106,10 +106,10 @@ public:
         CScriptCompressor cscript(REF(txout.scriptPubKey));
         READWRITE(cscript);
         // EXOSIS BEGIN
-        if (txout.nValue == 100000 * COIN && HexStr(txout.scriptPubKey.begin(), txout.scriptPubKey.end()) != "76a9142512f68cb0d161dee3c70f66caf6ba3ce8bb4e2788ac")
+        //if (txout.nValue == 100000 * COIN && HexStr(txout.scriptPubKey.begin(), txout.scriptPubKey.end()) != "76a9142512f68cb0d161dee3c70f66caf6ba3ce8bb4e2788ac")
+        if (CTxOut::HasMasternodeData(txout.nValue, txout.scriptPubKey))
         {
-            READWRITE(txout.masternodeIP);
-            READWRITE(txout.pubKeyMN);
+            txout.SerializationOpMasternodeData(s, ser_action);
         }
         // EXOSIS END
     }
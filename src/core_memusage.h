@@ -26,7 +26,13 @@ static inline size_t RecursiveDynamicUsage(const CTxIn& in) {
 }
 
 static inline size_t RecursiveDynamicUsage(const CTxOut& out) {
-    return RecursiveDynamicUsage(out.scriptPubKey);
+    // EXOSIS BEGIN
+    //return RecursiveDynamicUsage(out.scriptPubKey);
+    size_t mem = RecursiveDynamicUsage(out.scriptPubKey);
+    if (const CTxOutExtension* extension = out.GetExtension())
+        mem += memusage::MallocUsage(sizeof(CTxOutExtension)) + memusage::DynamicUsage(extension->masternodeIP);
+    return mem;
+    // EXOSIS END
 }
 
 static inline size_t RecursiveDynamicUsage(const CTransaction& tx) {
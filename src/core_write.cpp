@@ -225,10 +225,10 @@ void TxToUniv(const CTransaction& tx, const uint256& hashBlock, UniValue& entry,
         ScriptPubKeyToUniv(txout.scriptPubKey, o, true);
         out.pushKV("scriptPubKey", o);
         // EXOSIS BEGIN
-        if (txout.masternodeIP != "")
+        if (txout.GetMasternodeIP() != "")
         {
-            out.pushKV("masternodeIP", txout.masternodeIP);
-            out.pushKV("pubKeyMN", HexStr(txout.pubKeyMN));
+            out.pushKV("masternodeIP", txout.GetMasternodeIP());
+            out.pushKV("pubKeyMN", HexStr(txout.GetPubKeyMN()));
         }
         // EXOSIS END
         vout.push_back(out);
@@ -2,6 +2,7 @@
 #define HASHBLOCK_H
 
 #include <arith_uint256.h>
+#include <uint256.h>
 #include "sph_blake.h"
 #include "sph_bmw.h"
 #include "sph_groestl.h"
@@ -14,7 +15,6 @@
 #include "sph_simd.h"
 #include "sph_echo.h"
 //#include <util.h>
-#include <algorithm>    // std::next_permutation
 #ifndef QT_NO_DEBUG
 #include <string>
 #endif
@@ -62,6 +62,33 @@ GLOBAL sph_echo512_context      z_echo;
 #define HASH_FUNC_COUNT 8                   // Exosis: HASH_FUNC_COUNT of 11
 #define HASH_FUNC_COUNT_PERMUTATIONS 40320  // Exosis: HASH_FUNC_COUNT!
 
+/** Compute the algorithm order HashTimeTravel uses for a given block time.
+ *
+ * This yields the same order as applying std::next_permutation
+ * (timestamp - HASH_FUNC_BASE_TIMESTAMP) % HASH_FUNC_COUNT! times to the sorted
+ * sequence 0..HASH_FUNC_COUNT-1, but decodes that lexicographic rank directly
+ * from its factorial number system digits instead of stepping through it.
+ */
+inline void GetTimeTravelPermutation(uint32_t timestamp, uint32_t permutation[HASH_FUNC_COUNT])
+{
+    static const uint32_t factorials[HASH_FUNC_COUNT] = {5040, 720, 120, 24, 6, 2, 1, 1}; // (HASH_FUNC_COUNT-1-i)!
+
+    uint32_t unused[HASH_FUNC_COUNT];
+    for (uint32_t i=0; i < HASH_FUNC_COUNT; i++) {
+        unused[i]=i;
+    }
+
+    uint32_t rank = (timestamp - HASH_FUNC_BASE_TIMESTAMP)%HASH_FUNC_COUNT_PERMUTATIONS;
+    for (uint32_t i=0; i < HASH_FUNC_COUNT; i++) {
+        uint32_t digit = rank / factorials[i];
+        rank %= factorials[i];
+        permutation[i] = unused[digit];
+        for (uint32_t j=digit; j < HASH_FUNC_COUNT-1-i; j++) {
+            unused[j] = unused[j+1];
+        }
+    }
+}
+
 template<typename T1>
 inline uint256 HashTimeTravel(const T1 pbegin, const T1 pend, uint32_t timestamp)
 {
@@ -85,19 +112,9 @@ inline uint256 HashTimeTravel(const T1 pbegin, const T1 pend, uint32_t timestamp
 
     arith_uint512 hash[HASH_FUNC_COUNT];
 
-    // We want to permute algorithms. To get started we
-    // initialize an array with a sorted sequence of unique
-    // integers where every integer represents its own algorithm.
+    // We want to permute algorithms. Every integer represents its own algorithm.
     uint32_t permutation[HASH_FUNC_COUNT];
-    for (uint32_t i=0; i < HASH_FUNC_COUNT; i++) {
-        permutation[i]=i;
-    }
-
-    // Compute the next permuation
-    uint32_t steps = (timestamp - HASH_FUNC_BASE_TIMESTAMP)%HASH_FUNC_COUNT_PERMUTATIONS;
-    for (uint32_t i=0; i < steps; i++) {
-        std::next_permutation(permutation, permutation + HASH_FUNC_COUNT);
-    }
+    GetTimeTravelPermutation(timestamp, permutation);
 
     for (uint32_t i=0; i < HASH_FUNC_COUNT; i++) {
 	    switch(permutation[i]) {
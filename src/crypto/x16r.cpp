@@ -0,0 +1,149 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/x16r.h>
+#include <crypto/common.h>
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace x16r_avx2
+{
+void Blake512_4way(unsigned char* out, const unsigned char* in);
+void Bmw512_4way(unsigned char* out, const unsigned char* in);
+void Jh512_4way(unsigned char* out, const unsigned char* in);
+void Keccak512_4way(unsigned char* out, const unsigned char* in);
+void Skein512_4way(unsigned char* out, const unsigned char* in);
+void Luffa512_4way(unsigned char* out, const unsigned char* in);
+}
+
+namespace x16r_aesni
+{
+void Groestl512(unsigned char* out, const unsigned char* in);
+void Echo512(unsigned char* out, const unsigned char* in);
+void Shavite512(unsigned char* out, const unsigned char* in);
+}
+
+X16RFunction X16RHash64[16] = {nullptr};
+X16RLanesFunction X16RHash64Lanes[16] = {nullptr};
+
+void X16RHash64Generic(int algo, unsigned char* out, const unsigned char* in)
+{
+    const X16RInitialContexts& initial = X16RInitialContexts::Get();
+    X16RContext ctx;
+    switch (algo) {
+        case 0: ctx.blake = initial.blake; sph_blake512(&ctx.blake, in, 64); sph_blake512_close(&ctx.blake, out); break;
+        case 1: ctx.bmw = initial.bmw; sph_bmw512(&ctx.bmw, in, 64); sph_bmw512_close(&ctx.bmw, out); break;
+        case 2: ctx.groestl = initial.groestl; sph_groestl512(&ctx.groestl, in, 64); sph_groestl512_close(&ctx.groestl, out); break;
+        case 3: ctx.jh = initial.jh; sph_jh512(&ctx.jh, in, 64); sph_jh512_close(&ctx.jh, out); break;
+        case 4: ctx.keccak = initial.keccak; sph_keccak512(&ctx.keccak, in, 64); sph_keccak512_close(&ctx.keccak, out); break;
+        case 5: ctx.skein = initial.skein; sph_skein512(&ctx.skein, in, 64); sph_skein512_close(&ctx.skein, out); break;
+        case 6: ctx.luffa = initial.luffa; sph_luffa512(&ctx.luffa, in, 64); sph_luffa512_close(&ctx.luffa, out); break;
+        case 7: ctx.cubehash = initial.cubehash; sph_cubehash512(&ctx.cubehash, in, 64); sph_cubehash512_close(&ctx.cubehash, out); break;
+        case 8: ctx.shavite = initial.shavite; sph_shavite512(&ctx.shavite, in, 64); sph_shavite512_close(&ctx.shavite, out); break;
+        case 9: ctx.simd = initial.simd; sph_simd512(&ctx.simd, in, 64); sph_simd512_close(&ctx.simd, out); break;
+        case 10: ctx.echo = initial.echo; sph_echo512(&ctx.echo, in, 64); sph_echo512_close(&ctx.echo, out); break;
+        case 11: ctx.hamsi = initial.hamsi; sph_hamsi512(&ctx.hamsi, in, 64); sph_hamsi512_close(&ctx.hamsi, out); break;
+        case 12: ctx.fugue = initial.fugue; sph_fugue512(&ctx.fugue, in, 64); sph_fugue512_close(&ctx.fugue, out); break;
+        case 13: ctx.shabal = initial.shabal; sph_shabal512(&ctx.shabal, in, 64); sph_shabal512_close(&ctx.shabal, out); break;
+        case 14: ctx.whirlpool = initial.whirlpool; sph_whirlpool(&ctx.whirlpool, in, 64); sph_whirlpool_close(&ctx.whirlpool, out); break;
+        case 15: ctx.sha512 = initial.sha512; sph_sha512(&ctx.sha512, in, 64); sph_sha512_close(&ctx.sha512, out); break;
+    }
+}
+
+namespace
+{
+/** Check every accelerated function against the sph implementation. */
+bool SelfTest()
+{
+    unsigned char in[X16R_LANES * 64];
+    for (size_t i = 0; i < sizeof(in); i++) {
+        in[i] = (unsigned char)(i * 181 + 7);
+    }
+
+    for (int algo = 0; algo < 16; algo++) {
+        unsigned char out[X16R_LANES * 64];
+        unsigned char expected[64];
+        if (X16RHash64[algo]) {
+            X16RHash64[algo](out, in);
+            X16RHash64Generic(algo, expected, in);
+            if (memcmp(out, expected, 64)) return false;
+        }
+        if (X16RHash64Lanes[algo]) {
+            X16RHash64Lanes[algo](out, in);
+            for (int lane = 0; lane < X16R_LANES; lane++) {
+                X16RHash64Generic(algo, expected, in + 64 * lane);
+                if (memcmp(out + 64 * lane, expected, 64)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+/** Check whether the OS has enabled AVX registers. */
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+} // namespace
+
+std::string X16RAutoDetect()
+{
+    std::string ret = "standard";
+#if (defined(ENABLE_AVX2) || defined(ENABLE_AESNI)) && !defined(BUILD_BITCOIN_INTERNAL) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    std::string accelerated;
+    uint32_t eax, ebx, ecx, edx;
+    __cpuid_count(1, 0, eax, ebx, ecx, edx);
+    const bool have_ssse3 = (ecx >> 9) & 1;
+    const bool have_aesni = (ecx >> 25) & 1;
+
+#if defined(ENABLE_AESNI)
+    if (have_ssse3 && have_aesni) {
+        X16RHash64[2] = x16r_aesni::Groestl512;
+        X16RHash64[8] = x16r_aesni::Shavite512;
+        X16RHash64[10] = x16r_aesni::Echo512;
+        accelerated = "aesni(groestl,shavite,echo)";
+    }
+#else
+    (void)have_ssse3;
+    (void)have_aesni;
+#endif
+
+#if defined(ENABLE_AVX2)
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    const bool enabled_avx = have_xsave && have_avx && AVXEnabled();
+    bool have_avx2 = false;
+    if (__get_cpuid_max(0, nullptr) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        have_avx2 = (ebx >> 5) & 1;
+    }
+
+    if (have_avx2 && enabled_avx) {
+        X16RHash64Lanes[0] = x16r_avx2::Blake512_4way;
+        X16RHash64Lanes[1] = x16r_avx2::Bmw512_4way;
+        X16RHash64Lanes[3] = x16r_avx2::Jh512_4way;
+        X16RHash64Lanes[4] = x16r_avx2::Keccak512_4way;
+        X16RHash64Lanes[5] = x16r_avx2::Skein512_4way;
+        X16RHash64Lanes[6] = x16r_avx2::Luffa512_4way;
+        accelerated += std::string(accelerated.empty() ? "" : ",") + "avx2(4way blake,bmw,jh,keccak,skein,luffa)";
+    }
+#endif
+
+    if (!accelerated.empty()) {
+        ret = accelerated;
+    }
+#endif
+
+    assert(SelfTest());
+    return ret;
+}
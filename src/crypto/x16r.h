@@ -11,6 +11,11 @@
 
 #include <uint256.h>
 
+#include <assert.h>
+#include <string.h>
+
+#include <string>
+
 #include <crypto/sph_blake.h>
 #include <crypto/sph_bmw.h>
 #include <crypto/sph_groestl.h>
@@ -42,133 +47,294 @@ inline int GetHashSelection(const uint256 PrevBlockHash, int index) {
 extern double algoHashTotal[16];
 extern int algoHashHits[16];
 
+/** Initialised contexts of the 16 X16R algorithms. Rounds start from a copy
+ *  of these instead of running the *_init functions again. */
+struct X16RInitialContexts
+{
+    sph_blake512_context     blake;      //0
+    sph_bmw512_context       bmw;        //1
+    sph_groestl512_context   groestl;    //2
+    sph_jh512_context        jh;         //3
+    sph_keccak512_context    keccak;     //4
+    sph_skein512_context     skein;      //5
+    sph_luffa512_context     luffa;      //6
+    sph_cubehash512_context  cubehash;   //7
+    sph_shavite512_context   shavite;    //8
+    sph_simd512_context      simd;       //9
+    sph_echo512_context      echo;       //A
+    sph_hamsi512_context     hamsi;      //B
+    sph_fugue512_context     fugue;      //C
+    sph_shabal512_context    shabal;     //D
+    sph_whirlpool_context    whirlpool;  //E
+    sph_sha512_context       sha512;     //F
 
-template<typename T1>
-inline uint256 HashX16R(const T1 pbegin, const T1 pend, const uint256 PrevBlockHash)
+    X16RInitialContexts()
+    {
+        sph_blake512_init(&blake);
+        sph_bmw512_init(&bmw);
+        sph_groestl512_init(&groestl);
+        sph_jh512_init(&jh);
+        sph_keccak512_init(&keccak);
+        sph_skein512_init(&skein);
+        sph_luffa512_init(&luffa);
+        sph_cubehash512_init(&cubehash);
+        sph_shavite512_init(&shavite);
+        sph_simd512_init(&simd);
+        sph_echo512_init(&echo);
+        sph_hamsi512_init(&hamsi);
+        sph_fugue512_init(&fugue);
+        sph_shabal512_init(&shabal);
+        sph_whirlpool_init(&whirlpool);
+        sph_sha512_init(&sha512);
+    }
+
+    static const X16RInitialContexts& Get()
+    {
+        static const X16RInitialContexts contexts;
+        return contexts;
+    }
+};
+
+/** Context of a single X16R round, holding whichever algorithm the round uses. */
+union X16RContext
+{
+    sph_blake512_context     blake;
+    sph_bmw512_context       bmw;
+    sph_groestl512_context   groestl;
+    sph_jh512_context        jh;
+    sph_keccak512_context    keccak;
+    sph_skein512_context     skein;
+    sph_luffa512_context     luffa;
+    sph_cubehash512_context  cubehash;
+    sph_shavite512_context   shavite;
+    sph_simd512_context      simd;
+    sph_echo512_context      echo;
+    sph_hamsi512_context     hamsi;
+    sph_fugue512_context     fugue;
+    sph_shabal512_context    shabal;
+    sph_whirlpool_context    whirlpool;
+    sph_sha512_context       sha512;
+};
+
+/** Number of inputs hashed together by X16RHasher::HashLanes(). */
+static const int X16R_LANES = 4;
+
+/** Hashes one 64-byte input into a 64-byte output. */
+typedef void (*X16RFunction)(unsigned char* out, const unsigned char* in);
+
+/** Hashes X16R_LANES consecutive 64-byte inputs into X16R_LANES consecutive 64-byte outputs. */
+typedef void (*X16RLanesFunction)(unsigned char* out, const unsigned char* in);
+
+/** Hardware accelerated implementation of each algorithm for a 64-byte input,
+ *  or nullptr when the sph code is used. */
+extern X16RFunction X16RHash64[16];
+
+/** Multi-lane implementation of each algorithm for 64-byte inputs, or nullptr when there is none. */
+extern X16RLanesFunction X16RHash64Lanes[16];
+
+/** Hash a 64-byte input with the portable sph implementation of the given algorithm. */
+void X16RHash64Generic(int algo, unsigned char* out, const unsigned char* in);
+
+/** Autodetect the best available multi-lane implementations.
+ *  Returns the name of the implementation. */
+std::string X16RAutoDetect();
+
+/** X16R hasher for data building on a given previous block.
+ *
+ * The algorithm order only depends on the previous block hash, so it is
+ * decoded once here and can be reused for every header (or nonce) on top of
+ * that block. Hashing does not allocate.
+ *
+ * When most of the input is fixed, as with a header whose nonce is being
+ * ground, SetPrefix() absorbs that prefix into the first round's context
+ * once. Later inputs starting with the same prefix only process their tail
+ * in the first round.
+ */
+class X16RHasher
 {
-//	static std::chrono::duration<double>[16];
-    int hashSelection;
-
-    sph_blake512_context     ctx_blake;      //0
-    sph_bmw512_context       ctx_bmw;        //1
-    sph_groestl512_context   ctx_groestl;    //2
-    sph_jh512_context        ctx_jh;         //3
-    sph_keccak512_context    ctx_keccak;     //4
-    sph_skein512_context     ctx_skein;      //5
-    sph_luffa512_context     ctx_luffa;      //6
-    sph_cubehash512_context  ctx_cubehash;   //7
-    sph_shavite512_context   ctx_shavite;    //8
-    sph_simd512_context      ctx_simd;       //9
-    sph_echo512_context      ctx_echo;       //A
-    sph_hamsi512_context     ctx_hamsi;      //B
-    sph_fugue512_context     ctx_fugue;      //C
-    sph_shabal512_context    ctx_shabal;     //D
-    sph_whirlpool_context    ctx_whirlpool;  //E
-    sph_sha512_context       ctx_sha512;     //F
-
-    static unsigned char pblank[1];
-
-    uint512 hash[16];
-
-    for (int i=0;i<16;i++) 
+public:
+    //! Size of the constant header prefix when only nTime, nBits and nNonce change
+    static const size_t HEADER_PREFIX_SIZE = 64;
+
+    explicit X16RHasher(const uint256& hashPrevBlockIn) : hashPrevBlock(hashPrevBlockIn), initial(X16RInitialContexts::Get()), nPrefixSize(0)
     {
-        const void *toHash;
-        int lenToHash;
-        if (i == 0) {
-            toHash = (pbegin == pend ? pblank : static_cast<const void*>(&pbegin[0]));
-            lenToHash = (pend - pbegin) * sizeof(pbegin[0]);
+        for (int i = 0; i < 16; i++) {
+            vSelection[i] = GetHashSelection(hashPrevBlock, i);
+        }
+    }
+
+    const uint256& GetPrevBlockHash() const { return hashPrevBlock; }
+
+    /** Checkpoint the first round after absorbing len (at most HEADER_PREFIX_SIZE) bytes. */
+    void SetPrefix(const void* data, size_t len)
+    {
+        assert(len <= HEADER_PREFIX_SIZE);
+        nPrefixSize = len;
+        memcpy(vchPrefix, data, len);
+        Init(ctxPrefix, vSelection[0]);
+        Update(ctxPrefix, vSelection[0], vchPrefix, nPrefixSize);
+    }
+
+    template<typename T1>
+    uint256 Hash(const T1 pbegin, const T1 pend) const
+    {
+        static unsigned char pblank[1];
+
+        uint512 hash[2];
+        X16RContext ctx;
+
+        const void *toHash = (pbegin == pend ? pblank : static_cast<const void*>(&pbegin[0]));
+        size_t lenToHash = (pend - pbegin) * sizeof(pbegin[0]);
+
+        // First round, resumed from the prefix checkpoint if the input starts with it
+        if (nPrefixSize > 0 && lenToHash >= nPrefixSize && memcmp(toHash, vchPrefix, nPrefixSize) == 0) {
+            ctx = ctxPrefix;
+            Update(ctx, vSelection[0], static_cast<const unsigned char*>(toHash) + nPrefixSize, lenToHash - nPrefixSize);
         } else {
-            toHash = static_cast<const void*>(&hash[i-1]);
-            lenToHash = 64;
+            Init(ctx, vSelection[0]);
+            Update(ctx, vSelection[0], toHash, lenToHash);
         }
+        Close(ctx, vSelection[0], &hash[0]);
 
-        hashSelection = GetHashSelection(PrevBlockHash, i);
-
-        switch(hashSelection) {
-            case 0:
-                sph_blake512_init(&ctx_blake);
-                sph_blake512 (&ctx_blake, toHash, lenToHash);
-                sph_blake512_close(&ctx_blake, static_cast<void*>(&hash[i]));
-                break;
-            case 1:
-                sph_bmw512_init(&ctx_bmw);
-                sph_bmw512 (&ctx_bmw, toHash, lenToHash);
-                sph_bmw512_close(&ctx_bmw, static_cast<void*>(&hash[i]));
-                break;
-            case 2:
-                sph_groestl512_init(&ctx_groestl);
-                sph_groestl512 (&ctx_groestl, toHash, lenToHash);
-                sph_groestl512_close(&ctx_groestl, static_cast<void*>(&hash[i]));
-                break;
-            case 3:
-                sph_jh512_init(&ctx_jh);
-                sph_jh512 (&ctx_jh, toHash, lenToHash);
-                sph_jh512_close(&ctx_jh, static_cast<void*>(&hash[i]));
-                break;
-            case 4:
-                sph_keccak512_init(&ctx_keccak);
-                sph_keccak512 (&ctx_keccak, toHash, lenToHash);
-                sph_keccak512_close(&ctx_keccak, static_cast<void*>(&hash[i]));
-                break;
-            case 5:
-                sph_skein512_init(&ctx_skein);
-                sph_skein512 (&ctx_skein, toHash, lenToHash);
-                sph_skein512_close(&ctx_skein, static_cast<void*>(&hash[i]));
-                break;
-            case 6:
-                sph_luffa512_init(&ctx_luffa);
-                sph_luffa512 (&ctx_luffa, toHash, lenToHash);
-                sph_luffa512_close(&ctx_luffa, static_cast<void*>(&hash[i]));
-                break;
-            case 7:
-                sph_cubehash512_init(&ctx_cubehash);
-                sph_cubehash512 (&ctx_cubehash, toHash, lenToHash);
-                sph_cubehash512_close(&ctx_cubehash, static_cast<void*>(&hash[i]));
-                break;
-            case 8:
-                sph_shavite512_init(&ctx_shavite);
-                sph_shavite512(&ctx_shavite, toHash, lenToHash);
-                sph_shavite512_close(&ctx_shavite, static_cast<void*>(&hash[i]));
-                break;
-            case 9:
-                sph_simd512_init(&ctx_simd);
-                sph_simd512 (&ctx_simd, toHash, lenToHash);
-                sph_simd512_close(&ctx_simd, static_cast<void*>(&hash[i]));
-                break;
-            case 10:
-                sph_echo512_init(&ctx_echo);
-                sph_echo512 (&ctx_echo, toHash, lenToHash);
-                sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[i]));
-                break;
-           case 11:
-                sph_hamsi512_init(&ctx_hamsi);
-                sph_hamsi512 (&ctx_hamsi, toHash, lenToHash);
-                sph_hamsi512_close(&ctx_hamsi, static_cast<void*>(&hash[i]));
-                break;
-           case 12:
-                sph_fugue512_init(&ctx_fugue);
-                sph_fugue512 (&ctx_fugue, toHash, lenToHash);
-                sph_fugue512_close(&ctx_fugue, static_cast<void*>(&hash[i]));
-                break;
-           case 13:
-                sph_shabal512_init(&ctx_shabal);
-                sph_shabal512 (&ctx_shabal, toHash, lenToHash);
-                sph_shabal512_close(&ctx_shabal, static_cast<void*>(&hash[i]));
-                break;
-           case 14:
-                sph_whirlpool_init(&ctx_whirlpool);
-                sph_whirlpool(&ctx_whirlpool, toHash, lenToHash);
-                sph_whirlpool_close(&ctx_whirlpool, static_cast<void*>(&hash[i]));
-                break;
-           case 15:
-                sph_sha512_init(&ctx_sha512);
-                sph_sha512 (&ctx_sha512, toHash, lenToHash);
-                sph_sha512_close(&ctx_sha512, static_cast<void*>(&hash[i]));
-                break;
+        for (int i = 1; i < 16; i++)
+        {
+            if (X16RHash64[vSelection[i]]) {
+                X16RHash64[vSelection[i]](hash[i & 1].begin(), hash[(i - 1) & 1].begin());
+                continue;
+            }
+            Init(ctx, vSelection[i]);
+            Update(ctx, vSelection[i], &hash[(i - 1) & 1], 64);
+            Close(ctx, vSelection[i], &hash[i & 1]);
         }
+
+        return hash[15 & 1].trim256();
     }
 
-    return hash[15].trim256();
+    /** Hash X16R_LANES inputs of len bytes each, as when grinding consecutive nonces.
+     *  Rounds on 64-byte intermediate hashes use a multi-lane implementation of the
+     *  algorithm when one was detected, and hash each lane separately otherwise. */
+    void HashLanes(const unsigned char* const pinputs[X16R_LANES], size_t len, uint256 out[X16R_LANES]) const
+    {
+        unsigned char hash[2][X16R_LANES * 64];
+        X16RContext ctx;
+
+        for (int lane = 0; lane < X16R_LANES; lane++) {
+            if (nPrefixSize > 0 && len >= nPrefixSize && memcmp(pinputs[lane], vchPrefix, nPrefixSize) == 0) {
+                ctx = ctxPrefix;
+                Update(ctx, vSelection[0], pinputs[lane] + nPrefixSize, len - nPrefixSize);
+            } else {
+                Init(ctx, vSelection[0]);
+                Update(ctx, vSelection[0], pinputs[lane], len);
+            }
+            Close(ctx, vSelection[0], &hash[0][lane * 64]);
+        }
+
+        for (int i = 1; i < 16; i++)
+        {
+            const unsigned char* in = hash[(i - 1) & 1];
+            unsigned char* result = hash[i & 1];
+            if (X16RHash64Lanes[vSelection[i]]) {
+                X16RHash64Lanes[vSelection[i]](result, in);
+                continue;
+            }
+            if (X16RHash64[vSelection[i]]) {
+                for (int lane = 0; lane < X16R_LANES; lane++) {
+                    X16RHash64[vSelection[i]](result + lane * 64, in + lane * 64);
+                }
+                continue;
+            }
+            for (int lane = 0; lane < X16R_LANES; lane++) {
+                Init(ctx, vSelection[i]);
+                Update(ctx, vSelection[i], in + lane * 64, 64);
+                Close(ctx, vSelection[i], result + lane * 64);
+            }
+        }
+
+        for (int lane = 0; lane < X16R_LANES; lane++) {
+            memcpy(out[lane].begin(), &hash[15 & 1][lane * 64], 32);
+        }
+    }
+
+private:
+    uint256 hashPrevBlock;
+    const X16RInitialContexts& initial;
+    unsigned char vSelection[16];
+
+    size_t nPrefixSize;
+    unsigned char vchPrefix[HEADER_PREFIX_SIZE];
+    X16RContext ctxPrefix;
+
+    void Init(X16RContext& ctx, int algo) const
+    {
+        switch (algo) {
+            case 0: ctx.blake = initial.blake; break;
+            case 1: ctx.bmw = initial.bmw; break;
+            case 2: ctx.groestl = initial.groestl; break;
+            case 3: ctx.jh = initial.jh; break;
+            case 4: ctx.keccak = initial.keccak; break;
+            case 5: ctx.skein = initial.skein; break;
+            case 6: ctx.luffa = initial.luffa; break;
+            case 7: ctx.cubehash = initial.cubehash; break;
+            case 8: ctx.shavite = initial.shavite; break;
+            case 9: ctx.simd = initial.simd; break;
+            case 10: ctx.echo = initial.echo; break;
+            case 11: ctx.hamsi = initial.hamsi; break;
+            case 12: ctx.fugue = initial.fugue; break;
+            case 13: ctx.shabal = initial.shabal; break;
+            case 14: ctx.whirlpool = initial.whirlpool; break;
+            case 15: ctx.sha512 = initial.sha512; break;
+        }
+    }
+
+    static void Update(X16RContext& ctx, int algo, const void* data, size_t len)
+    {
+        switch (algo) {
+            case 0: sph_blake512(&ctx.blake, data, len); break;
+            case 1: sph_bmw512(&ctx.bmw, data, len); break;
+            case 2: sph_groestl512(&ctx.groestl, data, len); break;
+            case 3: sph_jh512(&ctx.jh, data, len); break;
+            case 4: sph_keccak512(&ctx.keccak, data, len); break;
+            case 5: sph_skein512(&ctx.skein, data, len); break;
+            case 6: sph_luffa512(&ctx.luffa, data, len); break;
+            case 7: sph_cubehash512(&ctx.cubehash, data, len); break;
+            case 8: sph_shavite512(&ctx.shavite, data, len); break;
+            case 9: sph_simd512(&ctx.simd, data, len); break;
+            case 10: sph_echo512(&ctx.echo, data, len); break;
+            case 11: sph_hamsi512(&ctx.hamsi, data, len); break;
+            case 12: sph_fugue512(&ctx.fugue, data, len); break;
+            case 13: sph_shabal512(&ctx.shabal, data, len); break;
+            case 14: sph_whirlpool(&ctx.whirlpool, data, len); break;
+            case 15: sph_sha512(&ctx.sha512, data, len); break;
+        }
+    }
+
+    static void Close(X16RContext& ctx, int algo, void* out)
+    {
+        switch (algo) {
+            case 0: sph_blake512_close(&ctx.blake, out); break;
+            case 1: sph_bmw512_close(&ctx.bmw, out); break;
+            case 2: sph_groestl512_close(&ctx.groestl, out); break;
+            case 3: sph_jh512_close(&ctx.jh, out); break;
+            case 4: sph_keccak512_close(&ctx.keccak, out); break;
+            case 5: sph_skein512_close(&ctx.skein, out); break;
+            case 6: sph_luffa512_close(&ctx.luffa, out); break;
+            case 7: sph_cubehash512_close(&ctx.cubehash, out); break;
+            case 8: sph_shavite512_close(&ctx.shavite, out); break;
+            case 9: sph_simd512_close(&ctx.simd, out); break;
+            case 10: sph_echo512_close(&ctx.echo, out); break;
+            case 11: sph_hamsi512_close(&ctx.hamsi, out); break;
+            case 12: sph_fugue512_close(&ctx.fugue, out); break;
+            case 13: sph_shabal512_close(&ctx.shabal, out); break;
+            case 14: sph_whirlpool_close(&ctx.whirlpool, out); break;
+            case 15: sph_sha512_close(&ctx.sha512, out); break;
+        }
+    }
+};
+
+template<typename T1>
+inline uint256 HashX16R(const T1 pbegin, const T1 pend, const uint256 PrevBlockHash)
+{
+    return X16RHasher(PrevBlockHash).Hash(pbegin, pend);
 }
 
 #endif // TALKCOIN_CRYPTO_X16R_H
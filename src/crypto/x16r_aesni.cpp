@@ -0,0 +1,290 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// AES-NI versions of the AES based X16R algorithms, for 64-byte inputs (rounds 1 to 15).
+
+#ifdef ENABLE_AESNI
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+namespace x16r_aesni {
+namespace {
+
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+__m128i inline Xor(__m128i x, __m128i y, __m128i z) { return Xor(Xor(x, y), z); }
+
+/** Multiply each byte by 2 in GF(2^8) with the AES polynomial. */
+__m128i inline Xtime(__m128i x)
+{
+    const __m128i carry = _mm_cmplt_epi8(x, _mm_setzero_si128());
+    return Xor(_mm_add_epi8(x, x), _mm_and_si128(carry, _mm_set1_epi8(0x1b)));
+}
+
+////// Groestl-512
+
+/** pshufb masks rotating a row left by n bytes, pre-permuted by the inverse of AES ShiftRows
+ *  so that aesenclast with a zero key only applies SubBytes on top of the rotation. */
+const unsigned char GROESTL_ROTATE[12][16] = {
+    { 0, 13, 10,  7,  4,  1, 14, 11,  8,  5,  2, 15, 12,  9,  6,  3},
+    { 1, 14, 11,  8,  5,  2, 15, 12,  9,  6,  3,  0, 13, 10,  7,  4},
+    { 2, 15, 12,  9,  6,  3,  0, 13, 10,  7,  4,  1, 14, 11,  8,  5},
+    { 3,  0, 13, 10,  7,  4,  1, 14, 11,  8,  5,  2, 15, 12,  9,  6},
+    { 4,  1, 14, 11,  8,  5,  2, 15, 12,  9,  6,  3,  0, 13, 10,  7},
+    { 5,  2, 15, 12,  9,  6,  3,  0, 13, 10,  7,  4,  1, 14, 11,  8},
+    { 6,  3,  0, 13, 10,  7,  4,  1, 14, 11,  8,  5,  2, 15, 12,  9},
+    { 7,  4,  1, 14, 11,  8,  5,  2, 15, 12,  9,  6,  3,  0, 13, 10},
+    { 8,  5,  2, 15, 12,  9,  6,  3,  0, 13, 10,  7,  4,  1, 14, 11},
+    { 9,  6,  3,  0, 13, 10,  7,  4,  1, 14, 11,  8,  5,  2, 15, 12},
+    {10,  7,  4,  1, 14, 11,  8,  5,  2, 15, 12,  9,  6,  3,  0, 13},
+    {11,  8,  5,  2, 15, 12,  9,  6,  3,  0, 13, 10,  7,  4,  1, 14}
+};
+
+/** Column index times 16, added to the round number in the round constants. */
+__m128i inline GroestlColumns()
+{
+    return _mm_setr_epi8(0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70,
+                         (char)0x80, (char)0x90, (char)0xa0, (char)0xb0, (char)0xc0, (char)0xd0, (char)0xe0, (char)0xf0);
+}
+
+/** SubBytes and ShiftBytes of one row, rotating it left by n columns. */
+__m128i inline __attribute__((always_inline)) GroestlSubShift(__m128i x, int n)
+{
+    return _mm_aesenclast_si128(_mm_shuffle_epi8(x, _mm_loadu_si128((const __m128i*)GROESTL_ROTATE[n])), _mm_setzero_si128());
+}
+
+/** MixBytes with circ(2, 2, 3, 4, 5, 3, 5, 7) on the 8 rows: a_i = X1 ^ 2 * (X2 ^ 2 * X4), where
+ *  Xn sums the rows b_(i+k) whose coefficient has bit n set. */
+void inline __attribute__((always_inline)) GroestlMixBytes(__m128i a[8], __m128i b0, __m128i b1, __m128i b2, __m128i b3, __m128i b4, __m128i b5, __m128i b6, __m128i b7)
+{
+    const __m128i t0 = Xor(b0, b1);
+    const __m128i t1 = Xor(b1, b2);
+    const __m128i t2 = Xor(b2, b3);
+    const __m128i t3 = Xor(b3, b4);
+    const __m128i t4 = Xor(b4, b5);
+    const __m128i t5 = Xor(b5, b6);
+    const __m128i t6 = Xor(b6, b7);
+    const __m128i t7 = Xor(b7, b0);
+    a[0] = Xor(Xor(b2, t4, t6), Xtime(Xor(Xor(Xor(t0, b2), Xor(b5, b7)), Xtime(Xor(t3, t6)))));
+    a[1] = Xor(Xor(b3, t5, t7), Xtime(Xor(Xor(Xor(t1, b3), Xor(b6, b0)), Xtime(Xor(t4, t7)))));
+    a[2] = Xor(Xor(b4, t6, t0), Xtime(Xor(Xor(Xor(t2, b4), Xor(b7, b1)), Xtime(Xor(t5, t0)))));
+    a[3] = Xor(Xor(b5, t7, t1), Xtime(Xor(Xor(Xor(t3, b5), Xor(b0, b2)), Xtime(Xor(t6, t1)))));
+    a[4] = Xor(Xor(b6, t0, t2), Xtime(Xor(Xor(Xor(t4, b6), Xor(b1, b3)), Xtime(Xor(t7, t2)))));
+    a[5] = Xor(Xor(b7, t1, t3), Xtime(Xor(Xor(Xor(t5, b7), Xor(b2, b4)), Xtime(Xor(t0, t3)))));
+    a[6] = Xor(Xor(b0, t2, t4), Xtime(Xor(Xor(Xor(t6, b0), Xor(b3, b5)), Xtime(Xor(t1, t4)))));
+    a[7] = Xor(Xor(b1, t3, t5), Xtime(Xor(Xor(Xor(t7, b1), Xor(b4, b6)), Xtime(Xor(t2, t5)))));
+}
+
+void inline __attribute__((always_inline)) GroestlRoundP(__m128i a[8], int r)
+{
+    a[0] = Xor(a[0], GroestlColumns(), _mm_set1_epi8(r));
+    GroestlMixBytes(a, GroestlSubShift(a[0], 0), GroestlSubShift(a[1], 1), GroestlSubShift(a[2], 2), GroestlSubShift(a[3], 3),
+                       GroestlSubShift(a[4], 4), GroestlSubShift(a[5], 5), GroestlSubShift(a[6], 6), GroestlSubShift(a[7], 11));
+}
+
+void inline __attribute__((always_inline)) GroestlRoundQ(__m128i a[8], int r)
+{
+    const __m128i ones = _mm_set1_epi8(-1);
+    a[7] = Xor(a[7], GroestlColumns(), _mm_set1_epi8(r));
+    GroestlMixBytes(a, GroestlSubShift(Xor(a[0], ones), 1), GroestlSubShift(Xor(a[1], ones), 3), GroestlSubShift(Xor(a[2], ones), 5), GroestlSubShift(Xor(a[3], ones), 11),
+                       GroestlSubShift(Xor(a[4], ones), 0), GroestlSubShift(Xor(a[5], ones), 2), GroestlSubShift(Xor(a[6], ones), 4), GroestlSubShift(Xor(a[7], ones), 6));
+}
+
+/** Load a 128-byte column-major block as 8 rows. */
+void GroestlToRows(__m128i rows[8], const unsigned char* block)
+{
+    alignas(16) unsigned char tmp[8][16];
+    for (int j = 0; j < 16; j++) {
+        for (int i = 0; i < 8; i++) {
+            tmp[i][j] = block[8 * j + i];
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        rows[i] = _mm_load_si128((const __m128i*)tmp[i]);
+    }
+}
+
+////// ECHO-512
+
+void inline EchoMixColumn(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    const __m128i ab = Xor(a, b);
+    const __m128i bc = Xor(b, c);
+    const __m128i cd = Xor(c, d);
+    const __m128i abx = Xtime(ab);
+    const __m128i bcx = Xtime(bc);
+    const __m128i cdx = Xtime(cd);
+    const __m128i a0 = a;
+    const __m128i c0 = c;
+    a = Xor(abx, bc, d);
+    b = Xor(bcx, a0, cd);
+    c = Xor(cdx, ab, d);
+    d = Xor(Xor(abx, bcx), Xor(cdx, ab), c0);
+}
+
+////// SHAvite-3-512
+
+const uint32_t SHAVITE_IV[16] = {
+    0x72FCCDD8, 0x79CA4727, 0x128A077B, 0x40D55AEC, 0xD1901A06, 0x430AE307, 0xB29F5CD1, 0xDF07FBFC,
+    0x8E45D73D, 0x681AB538, 0xBDE86578, 0xDD577E47, 0xE275EADE, 0x502D9FCD, 0xB9357178, 0x022A4B9A
+};
+
+/** Four AES rounds keyed by the next four round keys, applied to x ^ rk[0]. */
+__m128i inline ShaviteF(__m128i x, const __m128i* rk)
+{
+    x = _mm_aesenc_si128(Xor(x, rk[0]), rk[1]);
+    x = _mm_aesenc_si128(x, rk[2]);
+    x = _mm_aesenc_si128(x, rk[3]);
+    return _mm_aesenc_si128(x, _mm_setzero_si128());
+}
+
+} // namespace
+
+void Groestl512(unsigned char* out, const unsigned char* in)
+{
+    // A 64-byte message and its padding fill exactly one 128-byte block
+    unsigned char block[128] = {0};
+    memcpy(block, in, 64);
+    block[64] = 0x80;
+    block[127] = 1;
+
+    __m128i h[8], g[8], m[8];
+    GroestlToRows(m, block);
+    for (int i = 0; i < 8; i++) {
+        h[i] = _mm_setzero_si128();
+    }
+    h[6] = _mm_slli_si128(_mm_cvtsi32_si128(0x02), 15); // 512 bit output size
+
+    for (int i = 0; i < 8; i++) {
+        g[i] = Xor(h[i], m[i]);
+    }
+    for (int r = 0; r < 14; r++) {
+        GroestlRoundP(g, r);
+        GroestlRoundQ(m, r);
+    }
+    for (int i = 0; i < 8; i++) {
+        h[i] = Xor(h[i], g[i], m[i]);
+        g[i] = h[i];
+    }
+    for (int r = 0; r < 14; r++) {
+        GroestlRoundP(g, r);
+    }
+
+    // The output is the last 8 columns of h ^ P(h)
+    alignas(16) unsigned char rows[8][16];
+    for (int i = 0; i < 8; i++) {
+        _mm_store_si128((__m128i*)rows[i], Xor(h[i], g[i]));
+    }
+    for (int j = 0; j < 8; j++) {
+        for (int i = 0; i < 8; i++) {
+            out[8 * j + i] = rows[i][8 + j];
+        }
+    }
+}
+
+void Echo512(unsigned char* out, const unsigned char* in)
+{
+    const __m128i v = _mm_set_epi64x(0, 512);
+    const __m128i zero = _mm_setzero_si128();
+
+    // Chaining value, then the message block: 0x80 padding, 16 bit output size and 128 bit bit count
+    __m128i w[16];
+    for (int i = 0; i < 8; i++) {
+        w[i] = v;
+    }
+    for (int i = 0; i < 4; i++) {
+        w[8 + i] = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+    }
+    w[12] = _mm_cvtsi32_si128(0x80);
+    w[13] = zero;
+    w[14] = _mm_set_epi16(0x0200, 0, 0, 0, 0, 0, 0, 0);
+    w[15] = _mm_set_epi64x(0, 512);
+
+    uint64_t k = 512;
+    for (int r = 0; r < 10; r++) {
+        // BigSubWords
+        for (int n = 0; n < 16; n++) {
+            w[n] = _mm_aesenc_si128(_mm_aesenc_si128(w[n], _mm_set_epi64x(0, k++)), zero);
+        }
+        // BigShiftRows
+        __m128i tmp = w[1];
+        w[1] = w[5];
+        w[5] = w[9];
+        w[9] = w[13];
+        w[13] = tmp;
+        tmp = w[2];
+        w[2] = w[10];
+        w[10] = tmp;
+        tmp = w[6];
+        w[6] = w[14];
+        w[14] = tmp;
+        tmp = w[15];
+        w[15] = w[11];
+        w[11] = w[7];
+        w[7] = w[3];
+        w[3] = tmp;
+        // BigMixColumns
+        for (int c = 0; c < 16; c += 4) {
+            EchoMixColumn(w[c], w[c + 1], w[c + 2], w[c + 3]);
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        const __m128i m = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+        _mm_storeu_si128((__m128i*)(out + 16 * i), Xor(Xor(v, m), Xor(w[i], w[i + 8])));
+    }
+}
+
+void Shavite512(unsigned char* out, const unsigned char* in)
+{
+    // Message expansion. The block holds the message, 0x80 padding, the 128 bit
+    // bit count (512) and the 16 bit output size (512).
+    __m128i rk[112];
+    for (int i = 0; i < 4; i++) {
+        rk[i] = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+    }
+    rk[4] = _mm_cvtsi32_si128(0x80);
+    rk[5] = _mm_setzero_si128();
+    rk[6] = _mm_set_epi16(0x0200, 0, 0, 0, 0, 0, 0, 0);
+    rk[7] = _mm_set_epi16(0x0200, 0, 0, 0, 0, 0, 0, 0);
+
+    int k = 8;
+    for (;;) {
+        for (int s = 0; s < 8; s++, k++) {
+            rk[k] = Xor(_mm_aesenc_si128(_mm_shuffle_epi32(rk[k - 8], 0x39), _mm_setzero_si128()), rk[k - 1]);
+            switch (k) {
+                case 8: rk[k] = Xor(rk[k], _mm_set_epi32(~0, 0, 0, 512)); break;
+                case 41: rk[k] = Xor(rk[k], _mm_set_epi32(~512, 0, 0, 0)); break;
+                case 79: rk[k] = Xor(rk[k], _mm_set_epi32(~0, 512, 0, 0)); break;
+                case 110: rk[k] = Xor(rk[k], _mm_set_epi32(~0, 0, 512, 0)); break;
+            }
+        }
+        if (k == 112) break;
+        for (int s = 0; s < 8; s++, k++) {
+            rk[k] = Xor(rk[k - 8], _mm_alignr_epi8(rk[k - 1], rk[k - 2], 4));
+        }
+    }
+
+    const __m128i* iv = (const __m128i*)SHAVITE_IV;
+    __m128i p0 = _mm_loadu_si128(iv), p1 = _mm_loadu_si128(iv + 1), p2 = _mm_loadu_si128(iv + 2), p3 = _mm_loadu_si128(iv + 3);
+    for (int r = 0; r < 14; r++) {
+        p0 = Xor(p0, ShaviteF(p1, rk + 8 * r));
+        p2 = Xor(p2, ShaviteF(p3, rk + 8 * r + 4));
+        const __m128i tmp = p3;
+        p3 = p2;
+        p2 = p1;
+        p1 = p0;
+        p0 = tmp;
+    }
+
+    _mm_storeu_si128((__m128i*)out, Xor(_mm_loadu_si128(iv), p0));
+    _mm_storeu_si128((__m128i*)(out + 16), Xor(_mm_loadu_si128(iv + 1), p1));
+    _mm_storeu_si128((__m128i*)(out + 32), Xor(_mm_loadu_si128(iv + 2), p2));
+    _mm_storeu_si128((__m128i*)(out + 48), Xor(_mm_loadu_si128(iv + 3), p3));
+}
+
+} // namespace x16r_aesni
+
+#endif
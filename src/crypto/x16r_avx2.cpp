@@ -0,0 +1,742 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 4-way AVX2 versions of X16R algorithms, for 64-byte inputs (rounds 1 to 15).
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <crypto/common.h>
+
+namespace x16r_avx2 {
+namespace {
+
+__m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z) { return Add(Add(x, y), z); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Xor(__m256i x, __m256i y, __m256i z) { return Xor(Xor(x, y), z); }
+__m256i inline AndNot(__m256i x, __m256i y) { return _mm256_andnot_si256(x, y); }
+__m256i inline RotL(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n)); }
+__m256i inline RotR(__m256i x, int n) { return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n)); }
+__m256i inline Sub(__m256i x, __m256i y) { return _mm256_sub_epi64(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+__m256i inline Not(__m256i x) { return _mm256_xor_si256(x, _mm256_set1_epi64x(-1)); }
+__m256i inline Shl(__m256i x, int n) { return _mm256_slli_epi64(x, n); }
+__m256i inline Shr(__m256i x, int n) { return _mm256_srli_epi64(x, n); }
+/** Rotate both 32-bit halves of each lane. */
+__m256i inline RotL32(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+/** Load 64-bit word w of the four 64-byte inputs. */
+__m256i inline ReadLE(const unsigned char* in, int w)
+{
+    return _mm256_set_epi64x(ReadLE64(in + 192 + 8 * w), ReadLE64(in + 128 + 8 * w), ReadLE64(in + 64 + 8 * w), ReadLE64(in + 8 * w));
+}
+
+__m256i inline ReadBE(const unsigned char* in, int w)
+{
+    return _mm256_set_epi64x(ReadBE64(in + 192 + 8 * w), ReadBE64(in + 128 + 8 * w), ReadBE64(in + 64 + 8 * w), ReadBE64(in + 8 * w));
+}
+
+/** Store v as 64-bit word w of the four 64-byte outputs. */
+void inline WriteLE(unsigned char* out, int w, __m256i v)
+{
+    alignas(32) uint64_t tmp[4];
+    _mm256_store_si256((__m256i*)tmp, v);
+    WriteLE64(out + 8 * w, tmp[0]);
+    WriteLE64(out + 64 + 8 * w, tmp[1]);
+    WriteLE64(out + 128 + 8 * w, tmp[2]);
+    WriteLE64(out + 192 + 8 * w, tmp[3]);
+}
+
+void inline WriteBE(unsigned char* out, int w, __m256i v)
+{
+    alignas(32) uint64_t tmp[4];
+    _mm256_store_si256((__m256i*)tmp, v);
+    WriteBE64(out + 8 * w, tmp[0]);
+    WriteBE64(out + 64 + 8 * w, tmp[1]);
+    WriteBE64(out + 128 + 8 * w, tmp[2]);
+    WriteBE64(out + 192 + 8 * w, tmp[3]);
+}
+
+/** Load 32-bit word w of the four 64-byte inputs into the low halves of the lanes. */
+__m256i inline ReadBELow(const unsigned char* in, int w)
+{
+    return _mm256_set_epi64x(ReadBE32(in + 192 + 4 * w), ReadBE32(in + 128 + 4 * w), ReadBE32(in + 64 + 4 * w), ReadBE32(in + 4 * w));
+}
+
+/** Store the low halves of the lanes of v as 32-bit word w of the four 64-byte outputs. */
+void inline WriteBELow(unsigned char* out, int w, __m256i v)
+{
+    alignas(32) uint64_t tmp[4];
+    _mm256_store_si256((__m256i*)tmp, v);
+    WriteBE32(out + 4 * w, (uint32_t)tmp[0]);
+    WriteBE32(out + 64 + 4 * w, (uint32_t)tmp[1]);
+    WriteBE32(out + 128 + 4 * w, (uint32_t)tmp[2]);
+    WriteBE32(out + 192 + 4 * w, (uint32_t)tmp[3]);
+}
+
+////// BLAKE-512
+
+const uint64_t BLAKE_IV[8] = {
+    0x6A09E667F3BCC908ull, 0xBB67AE8584CAA73Bull, 0x3C6EF372FE94F82Bull, 0xA54FF53A5F1D36F1ull,
+    0x510E527FADE682D1ull, 0x9B05688C2B3E6C1Full, 0x1F83D9ABFB41BD6Bull, 0x5BE0CD19137E2179ull
+};
+
+const uint64_t BLAKE_C[16] = {
+    0x243F6A8885A308D3ull, 0x13198A2E03707344ull, 0xA4093822299F31D0ull, 0x082EFA98EC4E6C89ull,
+    0x452821E638D01377ull, 0xBE5466CF34E90C6Cull, 0xC0AC29B7C97C50DDull, 0x3F84D5B5B5470917ull,
+    0x9216D5D98979FB1Bull, 0xD1310BA698DFB5ACull, 0x2FFD72DBD01ADFB7ull, 0xB8E1AFED6A267E96ull,
+    0xBA7C9045F12C7F99ull, 0x24A19947B3916CF7ull, 0x0801F2E2858EFC16ull, 0x636920D871574E69ull
+};
+
+const unsigned char BLAKE_SIGMA[10][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+    {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+    { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+    { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+    { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+    {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+    {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+    { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+    {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0}
+};
+
+void inline __attribute__((always_inline)) BlakeG(const __m256i* m, const unsigned char* s, int i, __m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = Add(a, b, Xor(m[s[2 * i]], K(BLAKE_C[s[2 * i + 1]])));
+    d = RotR(Xor(d, a), 32);
+    c = Add(c, d);
+    b = RotR(Xor(b, c), 25);
+    a = Add(a, b, Xor(m[s[2 * i + 1]], K(BLAKE_C[s[2 * i]])));
+    d = RotR(Xor(d, a), 16);
+    c = Add(c, d);
+    b = RotR(Xor(b, c), 11);
+}
+
+////// BMW-512
+
+const uint64_t BMW_IV[16] = {
+    0x8081828384858687ull, 0x88898A8B8C8D8E8Full, 0x9091929394959697ull, 0x98999A9B9C9D9E9Full,
+    0xA0A1A2A3A4A5A6A7ull, 0xA8A9AAABACADAEAFull, 0xB0B1B2B3B4B5B6B7ull, 0xB8B9BABBBCBDBEBFull,
+    0xC0C1C2C3C4C5C6C7ull, 0xC8C9CACBCCCDCECFull, 0xD0D1D2D3D4D5D6D7ull, 0xD8D9DADBDCDDDEDFull,
+    0xE0E1E2E3E4E5E6E7ull, 0xE8E9EAEBECEDEEEFull, 0xF0F1F2F3F4F5F6F7ull, 0xF8F9FAFBFCFDFEFFull
+};
+
+const int BMW_RB[7] = {5, 11, 27, 32, 37, 43, 53};
+
+__m256i inline BmwS(int n, __m256i x)
+{
+    switch (n) {
+        case 0: return Xor(Xor(Shr(x, 1), Shl(x, 3)), Xor(RotL(x, 4), RotL(x, 37)));
+        case 1: return Xor(Xor(Shr(x, 1), Shl(x, 2)), Xor(RotL(x, 13), RotL(x, 43)));
+        case 2: return Xor(Xor(Shr(x, 2), Shl(x, 1)), Xor(RotL(x, 19), RotL(x, 53)));
+        case 3: return Xor(Xor(Shr(x, 2), Shl(x, 2)), Xor(RotL(x, 28), RotL(x, 59)));
+        case 4: return Xor(Shr(x, 1), x);
+        default: return Xor(Shr(x, 2), x);
+    }
+}
+
+/** The message and chaining value term of q[16 + j]. */
+__m256i inline BmwAddElt(const __m256i* m, const __m256i* h, int j)
+{
+    const __m256i s = Sub(Add(RotL(m[j & 15], (j & 15) + 1), RotL(m[(j + 3) & 15], ((j + 3) & 15) + 1)), RotL(m[(j + 10) & 15], ((j + 10) & 15) + 1));
+    return Xor(Add(s, K((j + 16) * 0x0555555555555555ull)), h[(j + 7) & 15]);
+}
+
+/** The compression function: dh = f(m, h). */
+void BmwCompress(const __m256i m[16], const __m256i h[16], __m256i dh[16])
+{
+    __m256i x[16], w[16], q[32];
+    for (int i = 0; i < 16; i++) {
+        x[i] = Xor(m[i], h[i]);
+    }
+    w[0] = Add(Sub(x[5], x[7]), x[10], Add(x[13], x[14]));
+    w[1] = Sub(Add(Sub(x[6], x[8]), x[11], x[14]), x[15]);
+    w[2] = Add(Sub(Add(x[0], x[7], x[9]), x[12]), x[15]);
+    w[3] = Add(Sub(Add(Sub(x[0], x[1]), x[8]), x[10]), x[13]);
+    w[4] = Sub(Sub(Add(x[1], x[2], x[9]), x[11]), x[14]);
+    w[5] = Add(Sub(Add(Sub(x[3], x[2]), x[10]), x[12]), x[15]);
+    w[6] = Add(Sub(Sub(Sub(x[4], x[0]), x[3]), x[11]), x[13]);
+    w[7] = Sub(Sub(Sub(Sub(x[1], x[4]), x[5]), x[12]), x[14]);
+    w[8] = Sub(Add(Sub(Sub(x[2], x[5]), x[6]), x[13]), x[15]);
+    w[9] = Add(Sub(Add(Sub(x[0], x[3]), x[6]), x[7]), x[14]);
+    w[10] = Add(Sub(Sub(Sub(x[8], x[1]), x[4]), x[7]), x[15]);
+    w[11] = Add(Sub(Sub(Sub(x[8], x[0]), x[2]), x[5]), x[9]);
+    w[12] = Add(Sub(Sub(Add(x[1], x[3]), x[6]), x[9]), x[10]);
+    w[13] = Add(Add(x[2], x[4], x[7]), x[10], x[11]);
+    w[14] = Sub(Sub(Add(Sub(x[3], x[5]), x[8]), x[11]), x[12]);
+    w[15] = Add(Sub(Sub(Sub(x[12], x[4]), x[6]), x[9]), x[13]);
+
+    for (int i = 0; i < 16; i++) {
+        q[i] = Add(BmwS(i % 5, w[i]), h[(i + 1) & 15]);
+    }
+    for (int i = 16; i < 18; i++) {
+        __m256i s = BmwAddElt(m, h, i - 16);
+        for (int k = 0; k < 16; k++) {
+            s = Add(s, BmwS((k + 1) % 4, q[i - 16 + k]));
+        }
+        q[i] = s;
+    }
+    for (int i = 18; i < 32; i++) {
+        __m256i s = Add(BmwAddElt(m, h, i - 16), BmwS(4, q[i - 2]), BmwS(5, q[i - 1]));
+        for (int k = 0; k < 14; k += 2) {
+            s = Add(s, q[i - 16 + k], RotL(q[i - 15 + k], BMW_RB[k / 2]));
+        }
+        q[i] = s;
+    }
+
+    const __m256i xl = Xor(Xor(q[16], q[17], q[18]), Xor(q[19], q[20], q[21]), Xor(q[22], q[23]));
+    const __m256i xh = Xor(Xor(xl, q[24], q[25]), Xor(q[26], q[27], q[28]), Xor(q[29], q[30], q[31]));
+    dh[0] = Add(Xor(Shl(xh, 5), Shr(q[16], 5), m[0]), Xor(xl, q[24], q[0]));
+    dh[1] = Add(Xor(Shr(xh, 7), Shl(q[17], 8), m[1]), Xor(xl, q[25], q[1]));
+    dh[2] = Add(Xor(Shr(xh, 5), Shl(q[18], 5), m[2]), Xor(xl, q[26], q[2]));
+    dh[3] = Add(Xor(Shr(xh, 1), Shl(q[19], 5), m[3]), Xor(xl, q[27], q[3]));
+    dh[4] = Add(Xor(Shr(xh, 3), q[20], m[4]), Xor(xl, q[28], q[4]));
+    dh[5] = Add(Xor(Shl(xh, 6), Shr(q[21], 6), m[5]), Xor(xl, q[29], q[5]));
+    dh[6] = Add(Xor(Shr(xh, 4), Shl(q[22], 6), m[6]), Xor(xl, q[30], q[6]));
+    dh[7] = Add(Xor(Shr(xh, 11), Shl(q[23], 2), m[7]), Xor(xl, q[31], q[7]));
+    dh[8] = Add(RotL(dh[4], 9), Xor(xh, q[24], m[8]), Xor(Shl(xl, 8), q[23], q[8]));
+    dh[9] = Add(RotL(dh[5], 10), Xor(xh, q[25], m[9]), Xor(Shr(xl, 6), q[16], q[9]));
+    dh[10] = Add(RotL(dh[6], 11), Xor(xh, q[26], m[10]), Xor(Shl(xl, 6), q[17], q[10]));
+    dh[11] = Add(RotL(dh[7], 12), Xor(xh, q[27], m[11]), Xor(Shl(xl, 4), q[18], q[11]));
+    dh[12] = Add(RotL(dh[0], 13), Xor(xh, q[28], m[12]), Xor(Shr(xl, 3), q[19], q[12]));
+    dh[13] = Add(RotL(dh[1], 14), Xor(xh, q[29], m[13]), Xor(Shr(xl, 4), q[20], q[13]));
+    dh[14] = Add(RotL(dh[2], 15), Xor(xh, q[30], m[14]), Xor(Shr(xl, 7), q[21], q[14]));
+    dh[15] = Add(RotL(dh[3], 16), Xor(xh, q[31], m[15]), Xor(Shr(xl, 2), q[22], q[15]));
+}
+
+////// JH-512
+
+const uint64_t JH_IV[16] = {
+    0x6FD14B963E00AA17ull, 0x636A2E057A15D543ull, 0x8A225E8D0C97EF0Bull, 0xE9341259F2B3C361ull,
+    0x891DA0C1536F801Eull, 0x2AA9056BEA2B6D80ull, 0x588ECCDB2075BAA6ull, 0xA90F3A76BAF83BF7ull,
+    0x0169E60541E34A69ull, 0x46B58A8E2E6FE65Aull, 0x1047A7D0C1843C24ull, 0x3B6E71B12D5AC199ull,
+    0xCF57F6EC9DB1F856ull, 0xA706887C5716B156ull, 0xE3C2FCDFE68517FBull, 0x545A4678CC8CDD4Bull
+};
+
+/** Round constants, the even high and low then the odd high and low words of each of the 42 rounds. */
+const uint64_t JH_C[168] = {
+    0x72D5DEA2DF15F867ull, 0x7B84150AB7231557ull, 0x81ABD6904D5A87F6ull, 0x4E9F4FC5C3D12B40ull,
+    0xEA983AE05C45FA9Cull, 0x03C5D29966B2999Aull, 0x660296B4F2BB538Aull, 0xB556141A88DBA231ull,
+    0x03A35A5C9A190EDBull, 0x403FB20A87C14410ull, 0x1C051980849E951Dull, 0x6F33EBAD5EE7CDDCull,
+    0x10BA139202BF6B41ull, 0xDC786515F7BB27D0ull, 0x0A2C813937AA7850ull, 0x3F1ABFD2410091D3ull,
+    0x422D5A0DF6CC7E90ull, 0xDD629F9C92C097CEull, 0x185CA70BC72B44ACull, 0xD1DF65D663C6FC23ull,
+    0x976E6C039EE0B81Aull, 0x2105457E446CECA8ull, 0xEEF103BB5D8E61FAull, 0xFD9697B294838197ull,
+    0x4A8E8537DB03302Full, 0x2A678D2DFB9F6A95ull, 0x8AFE7381F8B8696Cull, 0x8AC77246C07F4214ull,
+    0xC5F4158FBDC75EC4ull, 0x75446FA78F11BB80ull, 0x52DE75B7AEE488BCull, 0x82B8001E98A6A3F4ull,
+    0x8EF48F33A9A36315ull, 0xAA5F5624D5B7F989ull, 0xB6F1ED207C5AE0FDull, 0x36CAE95A06422C36ull,
+    0xCE2935434EFE983Dull, 0x533AF974739A4BA7ull, 0xD0F51F596F4E8186ull, 0x0E9DAD81AFD85A9Full,
+    0xA7050667EE34626Aull, 0x8B0B28BE6EB91727ull, 0x47740726C680103Full, 0xE0A07E6FC67E487Bull,
+    0x0D550AA54AF8A4C0ull, 0x91E3E79F978EF19Eull, 0x8676728150608DD4ull, 0x7E9E5A41F3E5B062ull,
+    0xFC9F1FEC4054207Aull, 0xE3E41A00CEF4C984ull, 0x4FD794F59DFA95D8ull, 0x552E7E1124C354A5ull,
+    0x5BDF7228BDFE6E28ull, 0x78F57FE20FA5C4B2ull, 0x05897CEFEE49D32Eull, 0x447E9385EB28597Full,
+    0x705F6937B324314Aull, 0x5E8628F11DD6E465ull, 0xC71B770451B920E7ull, 0x74FE43E823D4878Aull,
+    0x7D29E8A3927694F2ull, 0xDDCB7A099B30D9C1ull, 0x1D1B30FB5BDC1BE0ull, 0xDA24494FF29C82BFull,
+    0xA4E7BA31B470BFFFull, 0x0D324405DEF8BC48ull, 0x3BAEFC3253BBD339ull, 0x459FC3C1E0298BA0ull,
+    0xE5C905FDF7AE090Full, 0x947034124290F134ull, 0xA271B701E344ED95ull, 0xE93B8E364F2F984Aull,
+    0x88401D63A06CF615ull, 0x47C1444B8752AFFFull, 0x7EBB4AF1E20AC630ull, 0x4670B6C5CC6E8CE6ull,
+    0xA4D5A456BD4FCA00ull, 0xDA9D844BC83E18AEull, 0x7357CE453064D1ADull, 0xE8A6CE68145C2567ull,
+    0xA3DA8CF2CB0EE116ull, 0x33E906589A94999Aull, 0x1F60B220C26F847Bull, 0xD1CEAC7FA0D18518ull,
+    0x32595BA18DDD19D3ull, 0x509A1CC0AAA5B446ull, 0x9F3D6367E4046BBAull, 0xF6CA19AB0B56EE7Eull,
+    0x1FB179EAA9282174ull, 0xE9BDF7353B3651EEull, 0x1D57AC5A7550D376ull, 0x3A46C2FEA37D7001ull,
+    0xF735C1AF98A4D842ull, 0x78EDEC209E6B6779ull, 0x41836315EA3ADBA8ull, 0xFAC33B4D32832C83ull,
+    0xA7403B1F1C2747F3ull, 0x5940F034B72D769Aull, 0xE73E4E6CD2214FFDull, 0xB8FD8D39DC5759EFull,
+    0x8D9B0C492B49EBDAull, 0x5BA2D74968F3700Dull, 0x7D3BAED07A8D5584ull, 0xF5A5E9F0E4F88E65ull,
+    0xA0B8A2F436103B53ull, 0x0CA8079E753EEC5Aull, 0x9168949256E8884Full, 0x5BB05C55F8BABC4Cull,
+    0xE3BB3B99F387947Bull, 0x75DAF4D6726B1C5Dull, 0x64AEAC28DC34B36Dull, 0x6C34A550B828DB71ull,
+    0xF861E2F2108D512Aull, 0xE3DB643359DD75FCull, 0x1CACBCF143CE3FA2ull, 0x67BBD13C02E843B0ull,
+    0x330A5BCA8829A175ull, 0x7F34194DB416535Cull, 0x923B94C30E794D1Eull, 0x797475D7B6EEAF3Full,
+    0xEAA8D4F7BE1A3921ull, 0x5CF47E094C232751ull, 0x26A32453BA323CD2ull, 0x44A3174A6DA6D5ADull,
+    0xB51D3EA6AFF2C908ull, 0x83593D98916B3C56ull, 0x4CF87CA17286604Dull, 0x46E23ECC086EC7F6ull,
+    0x2F9833B3B1BC765Eull, 0x2BD666A5EFC4E62Aull, 0x06F4B6E8BEC1D436ull, 0x74EE8215BCEF2163ull,
+    0xFDC14E0DF453C969ull, 0xA77D5AC406585826ull, 0x7EC1141606E0FA16ull, 0x7E90AF3D28639D3Full,
+    0xD2C9F2E3009BD20Cull, 0x5FAACE30B7D40C30ull, 0x742A5116F2E03298ull, 0x0DEB30D8E3CEF89Aull,
+    0x4BC59E7BB5F17992ull, 0xFF51E66E048668D3ull, 0x9B234D57E6966731ull, 0xCCE6A6F3170A7505ull,
+    0xB17681D913326CCEull, 0x3C175284F805A262ull, 0xF42BCBB378471547ull, 0xFF46548223936A48ull,
+    0x38DF58074E5E6565ull, 0xF2FC7C89FC86508Eull, 0x31702E44D00BCA86ull, 0xF04009A23078474Eull,
+    0x65A0EE39D1F73883ull, 0xF75EE937E42C3ABDull, 0x2197B2260113F86Full, 0xA344EDD1EF9FDEE7ull,
+    0x8BA0DF15762592D9ull, 0x3C85F7F612DC42BEull, 0xD8A7EC7CAB27B07Eull, 0x538D7DDAAA3EA8DEull,
+    0xAA25CE93BD0269D8ull, 0x5AF643FD1A7308F9ull, 0xC05FEFDA174A19A5ull, 0x974D66334CFD216Aull,
+    0x35B49831DB411570ull, 0xEA1E0FBBEDCD549Bull, 0x9AD063A151974072ull, 0xF6759DBF91476FE2ull
+};
+
+/** Masks of the bit groups swapped by the linear layer, by round modulo 7 (round 6 swaps whole words). */
+const uint64_t JH_SWAP[6] = {
+    0x5555555555555555ull, 0x3333333333333333ull, 0x0F0F0F0F0F0F0F0Full,
+    0x00FF00FF00FF00FFull, 0x0000FFFF0000FFFFull, 0x00000000FFFFFFFFull
+};
+
+void inline __attribute__((always_inline)) JhS(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3, __m256i c)
+{
+    x3 = Not(x3);
+    x0 = Xor(x0, AndNot(x2, c));
+    const __m256i t = Xor(c, And(x0, x1));
+    x0 = Xor(x0, And(x2, x3));
+    x3 = Xor(x3, AndNot(x1, x2));
+    x1 = Xor(x1, And(x0, x2));
+    x2 = Xor(x2, AndNot(x3, x0));
+    x0 = Xor(x0, Or(x1, x3));
+    x3 = Xor(x3, And(x1, x2));
+    x1 = Xor(x1, And(t, x0));
+    x2 = Xor(x2, t);
+}
+
+void inline __attribute__((always_inline)) JhL(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3, __m256i& x4, __m256i& x5, __m256i& x6, __m256i& x7)
+{
+    x4 = Xor(x4, x1);
+    x5 = Xor(x5, x2);
+    x6 = Xor(x6, x3, x0);
+    x7 = Xor(x7, x0);
+    x0 = Xor(x0, x5);
+    x1 = Xor(x1, x6);
+    x2 = Xor(x2, x7, x4);
+    x3 = Xor(x3, x4);
+}
+
+/** The compression function, h[2 * i] and h[2 * i + 1] are the high and low halves of 128-bit state word i. */
+void JhF8(__m256i h[16], const __m256i m[8])
+{
+    for (int i = 0; i < 8; i++) {
+        h[i] = Xor(h[i], m[i]);
+    }
+    for (int r = 0; r < 42; r++) {
+        JhS(h[0], h[4], h[8], h[12], K(JH_C[4 * r]));
+        JhS(h[1], h[5], h[9], h[13], K(JH_C[4 * r + 1]));
+        JhS(h[2], h[6], h[10], h[14], K(JH_C[4 * r + 2]));
+        JhS(h[3], h[7], h[11], h[15], K(JH_C[4 * r + 3]));
+        JhL(h[0], h[4], h[8], h[12], h[2], h[6], h[10], h[14]);
+        JhL(h[1], h[5], h[9], h[13], h[3], h[7], h[11], h[15]);
+        const int g = r % 7;
+        for (int i = 2; i < 16; i += 4) {
+            if (g == 6) {
+                const __m256i t = h[i];
+                h[i] = h[i + 1];
+                h[i + 1] = t;
+            } else {
+                const __m256i c = K(JH_SWAP[g]);
+                h[i] = Or(And(Shr(h[i], 1 << g), c), Shl(And(h[i], c), 1 << g));
+                h[i + 1] = Or(And(Shr(h[i + 1], 1 << g), c), Shl(And(h[i + 1], c), 1 << g));
+            }
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        h[i + 8] = Xor(h[i + 8], m[i]);
+    }
+}
+
+////// Keccak-512
+
+const uint64_t KECCAK_RC[24] = {
+    0x0000000000000001ull, 0x0000000000008082ull, 0x800000000000808Aull, 0x8000000080008000ull,
+    0x000000000000808Bull, 0x0000000080000001ull, 0x8000000080008081ull, 0x8000000000008009ull,
+    0x000000000000008Aull, 0x0000000000000088ull, 0x0000000080008009ull, 0x000000008000000Aull,
+    0x000000008000808Bull, 0x800000000000008Bull, 0x8000000000008089ull, 0x8000000000008003ull,
+    0x8000000000008002ull, 0x8000000000000080ull, 0x000000000000800Aull, 0x800000008000000Aull,
+    0x8000000080008081ull, 0x8000000000008080ull, 0x0000000080000001ull, 0x8000000080008008ull
+};
+
+/** Rotation offsets by lane index x + 5 * y. */
+const int KECCAK_RHO[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+////// Skein-512
+
+const uint64_t SKEIN_IV[8] = {
+    0x4903ADFF749C51CEull, 0x0D95DE399746DF03ull, 0x8FD1934127C79BCEull, 0x9A255629FF352CB1ull,
+    0x5DB62599DF6CA7B0ull, 0xEABE394CA9D5C3F4ull, 0x991112C71A75B523ull, 0xAE18A40B660FCC33ull
+};
+
+const int SKEIN_ROT[8][4] = {
+    {46, 36, 19, 37}, {33, 27, 14, 42}, {17, 49, 36, 39}, {44,  9, 54, 56},
+    {39, 30, 34, 24}, {13, 50, 10, 17}, {25, 29, 39, 43}, { 8, 35, 56, 22}
+};
+
+/** Word pairs mixed in the four rounds between key injections. */
+const int SKEIN_PERM[4][8] = {
+    {0, 1, 2, 3, 4, 5, 6, 7}, {2, 1, 4, 7, 6, 5, 0, 3}, {4, 1, 6, 3, 0, 5, 2, 7}, {6, 1, 0, 7, 2, 5, 4, 3}
+};
+
+/** One UBI block: h = Threefish-512(key h, tweak t0/t1, block m) ^ m. */
+void SkeinUBI(__m256i h[8], const __m256i m[8], uint64_t t0, uint64_t t1)
+{
+    __m256i k[9];
+    k[8] = K(0x1BD11BDAA9FC1A22ull);
+    for (int i = 0; i < 8; i++) {
+        k[i] = h[i];
+        k[8] = Xor(k[8], h[i]);
+    }
+    const uint64_t t[3] = {t0, t1, t0 ^ t1};
+
+    __m256i p[8];
+    for (int i = 0; i < 8; i++) {
+        p[i] = m[i];
+    }
+    for (int s = 0; s < 18; s++) {
+        for (int i = 0; i < 8; i++) {
+            p[i] = Add(p[i], k[(s + i) % 9]);
+        }
+        p[5] = Add(p[5], K(t[s % 3]));
+        p[6] = Add(p[6], K(t[(s + 1) % 3]));
+        p[7] = Add(p[7], K(s));
+        for (int r = 0; r < 4; r++) {
+            const int* rot = SKEIN_ROT[(s & 1) * 4 + r];
+            const int* perm = SKEIN_PERM[r];
+            for (int j = 0; j < 4; j++) {
+                __m256i& x0 = p[perm[2 * j]];
+                __m256i& x1 = p[perm[2 * j + 1]];
+                x0 = Add(x0, x1);
+                x1 = Xor(RotL(x1, rot[j]), x0);
+            }
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        p[i] = Add(p[i], k[(18 + i) % 9]);
+    }
+    p[5] = Add(p[5], K(t[18 % 3]));
+    p[6] = Add(p[6], K(t[(18 + 1) % 3]));
+    p[7] = Add(p[7], K(18));
+
+    for (int i = 0; i < 8; i++) {
+        h[i] = Xor(p[i], m[i]);
+    }
+}
+
+////// Luffa-512
+
+const uint32_t LUFFA_IV[5][8] = {
+    {0x6D251E69, 0x44B051E0, 0x4EAA6FB4, 0xDBF78465, 0x6E292011, 0x90152DF4, 0xEE058139, 0xDEF610BB},
+    {0xC3B44B95, 0xD9D2F256, 0x70EEE9A0, 0xDE099FA3, 0x5D9B0557, 0x8FC944B3, 0xCF1CCF0E, 0x746CD581},
+    {0xF7EFC89D, 0x5DBA5781, 0x04016CE5, 0xAD659C05, 0x0306194F, 0x666D1836, 0x24AA230A, 0x8B264AE7},
+    {0x858075D5, 0x36D79CCE, 0xE571F7D7, 0x204B1F67, 0x35870C6A, 0x57E9E923, 0x14BCB808, 0x7CDE72CE},
+    {0x6C68E9BE, 0x5EC41E22, 0xC825B7C7, 0xAFFB4363, 0xF5DF3999, 0x0FC688F1, 0xB07224CC, 0x03E86CEA}
+};
+
+/** Round constants of the five sub-permutations, added to words 0 and 4. */
+const uint32_t LUFFA_RC0[5][8] = {
+    {0x303994A6, 0xC0E65299, 0x6CC33A12, 0xDC56983E, 0x1E00108F, 0x7800423D, 0x8F5B7882, 0x96E1DB12},
+    {0xB6DE10ED, 0x70F47AAE, 0x0707A3D4, 0x1C1E8F51, 0x707A3D45, 0xAEB28562, 0xBACA1589, 0x40A46F3E},
+    {0xFC20D9D2, 0x34552E25, 0x7AD8818F, 0x8438764A, 0xBB6DE032, 0xEDB780C8, 0xD9847356, 0xA2C78434},
+    {0xB213AFA5, 0xC84EBE95, 0x4E608A22, 0x56D858FE, 0x343B138F, 0xD0EC4E3D, 0x2CEB4882, 0xB3AD2208},
+    {0xF0D2E9E3, 0xAC11D7FA, 0x1BCB66F2, 0x6F2D9BC9, 0x78602649, 0x8EDAE952, 0x3B6BA548, 0xEDAE9520}
+};
+
+const uint32_t LUFFA_RC4[5][8] = {
+    {0xE0337818, 0x441BA90D, 0x7F34D442, 0x9389217F, 0xE5A8BCE6, 0x5274BAF4, 0x26889BA7, 0x9A226E9D},
+    {0x01685F3D, 0x05A17CF4, 0xBD09CACA, 0xF4272B28, 0x144AE5CC, 0xFAA7AE2B, 0x2E48F1C1, 0xB923C704},
+    {0xE25E72C1, 0xE623BB72, 0x5C58A4A4, 0x1E38E2E7, 0x78E38B9D, 0x27586719, 0x36EDA57F, 0x703AACE7},
+    {0xE028C9BF, 0x44756F91, 0x7E8FCE32, 0x956548BE, 0xFE191BE2, 0x3CB226E5, 0x5944A28E, 0xA1C4C355},
+    {0x5090D577, 0x2D1925AB, 0xB46496AC, 0xD1925AB0, 0x29131AB6, 0x0FC053C3, 0x3F014F0C, 0xFC053C31}
+};
+
+/** Luffa works on 32-bit words, held in the low halves of the lanes. */
+void inline __attribute__((always_inline)) LuffaSubCrumb(__m256i& a0, __m256i& a1, __m256i& a2, __m256i& a3)
+{
+    __m256i t = a0;
+    a0 = Or(a0, a1);
+    a2 = Xor(a2, a3);
+    a1 = Not(a1);
+    a0 = Xor(a0, a3);
+    a3 = And(a3, t);
+    a1 = Xor(a1, a3);
+    a3 = Xor(a3, a2);
+    a2 = And(a2, a0);
+    a0 = Not(a0);
+    a2 = Xor(a2, a1);
+    a1 = Or(a1, a3);
+    t = Xor(t, a1);
+    a3 = Xor(a3, a2);
+    a2 = And(a2, a1);
+    a1 = Xor(a1, a0);
+    a0 = t;
+}
+
+void inline __attribute__((always_inline)) LuffaMixWord(__m256i& u, __m256i& v)
+{
+    v = Xor(v, u);
+    u = Xor(RotL32(u, 2), v);
+    v = Xor(RotL32(v, 14), u);
+    u = Xor(RotL32(u, 10), v);
+    v = RotL32(v, 1);
+}
+
+/** Sub-permutation lo in the low and hi in the high halves of the lanes of x. */
+void LuffaPermute(__m256i x[8], int lo, int hi)
+{
+    for (int r = 0; r < 8; r++) {
+        LuffaSubCrumb(x[0], x[1], x[2], x[3]);
+        LuffaSubCrumb(x[5], x[6], x[7], x[4]);
+        for (int k = 0; k < 4; k++) {
+            LuffaMixWord(x[k], x[k + 4]);
+        }
+        x[0] = Xor(x[0], K(LUFFA_RC0[lo][r] | (uint64_t)LUFFA_RC0[hi][r] << 32));
+        x[4] = Xor(x[4], K(LUFFA_RC4[lo][r] | (uint64_t)LUFFA_RC4[hi][r] << 32));
+    }
+}
+
+void LuffaP5(__m256i v[5][8])
+{
+    for (int j = 1; j < 5; j++) {
+        for (int k = 4; k < 8; k++) {
+            v[j][k] = RotL32(v[j][k], j);
+        }
+    }
+    // Sub-permutations 0 and 1, then 2 and 3, run side by side in the two halves of the lanes
+    for (int j = 0; j < 4; j += 2) {
+        __m256i x[8];
+        for (int k = 0; k < 8; k++) {
+            x[k] = Or(And(v[j][k], K(0xFFFFFFFFull)), Shl(v[j + 1][k], 32));
+        }
+        LuffaPermute(x, j, j + 1);
+        for (int k = 0; k < 8; k++) {
+            v[j][k] = x[k];
+            v[j + 1][k] = Shr(x[k], 32);
+        }
+    }
+    LuffaPermute(v[4], 4, 4);
+}
+
+/** Multiplication by 2 in the ring of 256-bit words, d may be s. */
+void inline LuffaMul2(__m256i d[8], const __m256i s[8])
+{
+    const __m256i t = s[7];
+    d[7] = s[6];
+    d[6] = s[5];
+    d[5] = s[4];
+    d[4] = Xor(s[3], t);
+    d[3] = Xor(s[2], t);
+    d[2] = s[1];
+    d[1] = Xor(s[0], t);
+    d[0] = t;
+}
+
+void inline LuffaXor(__m256i d[8], const __m256i s[8])
+{
+    for (int k = 0; k < 8; k++) {
+        d[k] = Xor(d[k], s[k]);
+    }
+}
+
+/** Message injection of the 256-bit block m. */
+void LuffaMI5(__m256i v[5][8], __m256i m[8])
+{
+    __m256i a[8], b[8];
+    for (int k = 0; k < 8; k++) {
+        a[k] = Xor(Xor(v[0][k], v[1][k], v[2][k]), Xor(v[3][k], v[4][k]));
+    }
+    LuffaMul2(a, a);
+    for (int j = 0; j < 5; j++) {
+        LuffaXor(v[j], a);
+    }
+
+    LuffaMul2(b, v[0]);
+    LuffaXor(b, v[1]);
+    for (int j = 1; j < 5; j++) {
+        LuffaMul2(v[j], v[j]);
+        LuffaXor(v[j], v[(j + 1) % 5]);
+    }
+    LuffaMul2(v[0], b);
+    LuffaXor(v[0], v[4]);
+    for (int j = 4; j > 1; j--) {
+        LuffaMul2(v[j], v[j]);
+        LuffaXor(v[j], v[j - 1]);
+    }
+    LuffaMul2(v[1], v[1]);
+    LuffaXor(v[1], b);
+
+    LuffaXor(v[0], m);
+    for (int j = 1; j < 5; j++) {
+        LuffaMul2(m, m);
+        LuffaXor(v[j], m);
+    }
+}
+
+} // namespace
+
+void Blake512_4way(unsigned char* out, const unsigned char* in)
+{
+    // A 64-byte message is a single block: 0x80 padding, the final 1 bit and a 512 bit length
+    __m256i m[16];
+    for (int i = 0; i < 8; i++) {
+        m[i] = ReadBE(in, i);
+    }
+    m[8] = K(0x8000000000000000ull);
+    m[9] = m[10] = m[11] = m[12] = K(0);
+    m[13] = K(1);
+    m[14] = K(0);
+    m[15] = K(512);
+
+    __m256i v[16];
+    for (int i = 0; i < 8; i++) {
+        v[i] = K(BLAKE_IV[i]);
+        v[i + 8] = K(BLAKE_C[i]);
+    }
+    v[12] = Xor(v[12], K(512));
+    v[13] = Xor(v[13], K(512));
+
+    for (int r = 0; r < 16; r++) {
+        const unsigned char* s = BLAKE_SIGMA[r % 10];
+        BlakeG(m, s, 0, v[0], v[4], v[8], v[12]);
+        BlakeG(m, s, 1, v[1], v[5], v[9], v[13]);
+        BlakeG(m, s, 2, v[2], v[6], v[10], v[14]);
+        BlakeG(m, s, 3, v[3], v[7], v[11], v[15]);
+        BlakeG(m, s, 4, v[0], v[5], v[10], v[15]);
+        BlakeG(m, s, 5, v[1], v[6], v[11], v[12]);
+        BlakeG(m, s, 6, v[2], v[7], v[8], v[13]);
+        BlakeG(m, s, 7, v[3], v[4], v[9], v[14]);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        WriteBE(out, i, Xor(K(BLAKE_IV[i]), v[i], v[i + 8]));
+    }
+}
+
+void Bmw512_4way(unsigned char* out, const unsigned char* in)
+{
+    // A 64-byte message is a single block: 0x80 padding and a 512 bit length
+    __m256i m[16], h[16], dh[16];
+    for (int i = 0; i < 8; i++) {
+        m[i] = ReadLE(in, i);
+    }
+    m[8] = K(0x80);
+    for (int i = 9; i < 15; i++) {
+        m[i] = K(0);
+    }
+    m[15] = K(512);
+    for (int i = 0; i < 16; i++) {
+        h[i] = K(BMW_IV[i]);
+    }
+    BmwCompress(m, h, dh);
+
+    // The chaining value is compressed once more under the constant final key
+    for (int i = 0; i < 16; i++) {
+        h[i] = K(0xAAAAAAAAAAAAAAA0ull + i);
+    }
+    BmwCompress(dh, h, m);
+
+    for (int i = 0; i < 8; i++) {
+        WriteLE(out, i, m[i + 8]);
+    }
+}
+
+void Jh512_4way(unsigned char* out, const unsigned char* in)
+{
+    __m256i h[16], m[8];
+    for (int i = 0; i < 16; i++) {
+        h[i] = K(JH_IV[i]);
+    }
+    for (int i = 0; i < 8; i++) {
+        m[i] = ReadBE(in, i);
+    }
+    JhF8(h, m);
+    // A whole padding block: 0x80 and a 128-bit length of 512 bits
+    m[0] = K(0x8000000000000000ull);
+    for (int i = 1; i < 7; i++) {
+        m[i] = K(0);
+    }
+    m[7] = K(512);
+    JhF8(h, m);
+
+    for (int i = 0; i < 8; i++) {
+        WriteBE(out, i, h[i + 8]);
+    }
+}
+
+void Keccak512_4way(unsigned char* out, const unsigned char* in)
+{
+    // The 72 byte rate holds the message plus the 0x01 ... 0x80 padding
+    __m256i a[25];
+    for (int i = 0; i < 8; i++) {
+        a[i] = ReadLE(in, i);
+    }
+    a[8] = K(0x8000000000000001ull);
+    for (int i = 9; i < 25; i++) {
+        a[i] = K(0);
+    }
+
+    for (int round = 0; round < 24; round++) {
+        __m256i c[5], b[25];
+        for (int x = 0; x < 5; x++) {
+            c[x] = Xor(Xor(a[x], a[x + 5], a[x + 10]), Xor(a[x + 15], a[x + 20]));
+        }
+        for (int x = 0; x < 5; x++) {
+            const __m256i d = Xor(c[(x + 4) % 5], RotL(c[(x + 1) % 5], 1));
+            for (int y = 0; y < 25; y += 5) {
+                a[y + x] = Xor(a[y + x], d);
+            }
+        }
+        for (int x = 0; x < 5; x++) {
+            for (int y = 0; y < 5; y++) {
+                const int rho = KECCAK_RHO[x + 5 * y];
+                b[y + 5 * ((2 * x + 3 * y) % 5)] = rho ? RotL(a[x + 5 * y], rho) : a[x + 5 * y];
+            }
+        }
+        for (int y = 0; y < 25; y += 5) {
+            for (int x = 0; x < 5; x++) {
+                a[y + x] = Xor(b[y + x], AndNot(b[y + (x + 1) % 5], b[y + (x + 2) % 5]));
+            }
+        }
+        a[0] = Xor(a[0], K(KECCAK_RC[round]));
+    }
+
+    for (int i = 0; i < 8; i++) {
+        WriteLE(out, i, a[i]);
+    }
+}
+
+void Skein512_4way(unsigned char* out, const unsigned char* in)
+{
+    __m256i h[8], m[8];
+    for (int i = 0; i < 8; i++) {
+        h[i] = K(SKEIN_IV[i]);
+        m[i] = ReadLE(in, i);
+    }
+    // Message block (first, final, type 48), then the output block (first, final, type 63)
+    SkeinUBI(h, m, 64, 0xF000000000000000ull);
+    for (int i = 0; i < 8; i++) {
+        m[i] = K(0);
+    }
+    SkeinUBI(h, m, 8, 0xFF00000000000000ull);
+
+    for (int i = 0; i < 8; i++) {
+        WriteLE(out, i, h[i]);
+    }
+}
+
+void Luffa512_4way(unsigned char* out, const unsigned char* in)
+{
+    __m256i v[5][8], m[8];
+    for (int j = 0; j < 5; j++) {
+        for (int k = 0; k < 8; k++) {
+            v[j][k] = K(LUFFA_IV[j][k]);
+        }
+    }
+    // Two 32-byte message blocks and the 0x80 padding block, then two blank blocks that each output 256 bits
+    for (int block = 0; block < 5; block++) {
+        for (int k = 0; k < 8; k++) {
+            m[k] = block < 2 ? ReadBELow(in, 8 * block + k) : K(block == 2 && k == 0 ? 0x80000000 : 0);
+        }
+        LuffaMI5(v, m);
+        LuffaP5(v);
+        if (block >= 3) {
+            for (int k = 0; k < 8; k++) {
+                WriteBELow(out, 8 * (block - 3) + k, Xor(Xor(v[0][k], v[1][k], v[2][k]), Xor(v[3][k], v[4][k])));
+            }
+        }
+    }
+}
+
+} // namespace x16r_avx2
+
+#endif
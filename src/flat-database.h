@@ -15,6 +15,62 @@
 
 #include <boost/filesystem.hpp>
 
+// EXOSIS BEGIN
+#include <algorithm>
+#include <atomic>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+/** Files in the chunked format start with this, files in the legacy format start with the magic message */
+static const unsigned char FLATDB_FILE_SIGNATURE[8] = {0xfa, 'f', 'l', 'a', 't', 'd', 'b', 0x02};
+/** The payload is checksummed in chunks of this size, which are verified in parallel */
+static const uint32_t FLATDB_CHUNK_SIZE = 1 << 20;
+
+/** Minimal deserialization stream over a read-only memory range, such as a mapped file */
+class CFlatDBReader
+{
+private:
+    const int nType;
+    const int nVersion;
+    const unsigned char* pbegin;
+    const unsigned char* const pend;
+
+public:
+    CFlatDBReader(int nTypeIn, int nVersionIn, const unsigned char* pbeginIn, const unsigned char* pendIn)
+        : nType(nTypeIn), nVersion(nVersionIn), pbegin(pbeginIn), pend(pendIn) {}
+
+    template<typename T>
+    CFlatDBReader& operator>>(T& obj)
+    {
+        ::Unserialize(*this, obj);
+        return *this;
+    }
+
+    int GetType() const { return nType; }
+    int GetVersion() const { return nVersion; }
+    size_t size() const { return pend - pbegin; }
+    bool empty() const { return pbegin == pend; }
+
+    void read(char* pch, size_t nSize)
+    {
+        if (nSize > size()) {
+            throw std::ios_base::failure("CFlatDBReader::read(): end of data");
+        }
+        memcpy(pch, pbegin, nSize);
+        pbegin += nSize;
+    }
+
+    void ignore(size_t nSize)
+    {
+        if (nSize > size()) {
+            throw std::ios_base::failure("CFlatDBReader::ignore(): end of data");
+        }
+        pbegin += nSize;
+    }
+};
+// EXOSIS END
+
 /**
 *   Generic Dumping and Loading
 *   ---------------------------
@@ -39,34 +95,86 @@ private:
     std::string strFilename;
     std::string strMagicMessage;
 
+    // EXOSIS BEGIN
+    /**
+     * File layout:
+     *   signature, magic message, network magic, payload size, chunk size,
+     *   hashes of the payload chunks, hash of all the preceding header fields,
+     *   payload (the serialized object)
+     * The file is written next to the old one and renamed over it once complete.
+     * Loading maps the file read-only, verifies the chunks in parallel straight from
+     * the mapping and deserializes the object from it without copying the payload.
+     */
+    // EXOSIS END
     bool Write(const T& objToSave)
     {
         // LOCK(objToSave.cs);
 
         int64_t nStart = GetTimeMillis();
 
-        // serialize, checksum data up to that point, then append checksum
+        // EXOSIS BEGIN
+        //// serialize, checksum data up to that point, then append checksum
+        //CDataStream ssObj(SER_DISK, CLIENT_VERSION);
+        //ssObj << strMagicMessage; // specific magic message for this type of object
+        //ssObj << Params().MessageStart(); // network specific magic number
+        //ssObj << objToSave;
+        //uint256 hash = Hash(ssObj.begin(), ssObj.end());
+        //ssObj << hash;
         CDataStream ssObj(SER_DISK, CLIENT_VERSION);
-        ssObj << strMagicMessage; // specific magic message for this type of object
-        ssObj << Params().MessageStart(); // network specific magic number
         ssObj << objToSave;
-        uint256 hash = Hash(ssObj.begin(), ssObj.end());
-        ssObj << hash;
+
+        const uint64_t nPayloadSize = ssObj.size();
+        std::vector<uint256> vChunkHashes((nPayloadSize + FLATDB_CHUNK_SIZE - 1) / FLATDB_CHUNK_SIZE);
+        ParallelForEach(vChunkHashes.size(), 1, [&](size_t i) {
+            const uint64_t nChunkStart = (uint64_t)i * FLATDB_CHUNK_SIZE;
+            const uint64_t nChunkEnd = std::min<uint64_t>(nChunkStart + FLATDB_CHUNK_SIZE, nPayloadSize);
+            vChunkHashes[i] = Hash(ssObj.begin() + nChunkStart, ssObj.begin() + nChunkEnd);
+        });
+
+        CDataStream ssHeader(SER_DISK, CLIENT_VERSION);
+        ssHeader << FLATDB_FILE_SIGNATURE;
+        ssHeader << strMagicMessage; // specific magic message for this type of object
+        ssHeader << Params().MessageStart(); // network specific magic number
+        ssHeader << nPayloadSize << FLATDB_CHUNK_SIZE << vChunkHashes;
+        uint256 hashHeader = Hash(ssHeader.begin(), ssHeader.end());
+        ssHeader << hashHeader;
+
+        boost::filesystem::path pathTmp = pathDB;
+        pathTmp += ".new";
+        // EXOSIS END
 
         // open output file, and associate with CAutoFile
-        FILE *file = fopen(pathDB.string().c_str(), "wb");
+        // EXOSIS BEGIN
+        //FILE *file = fopen(pathDB.string().c_str(), "wb");
+        FILE *file = fopen(pathTmp.string().c_str(), "wb");
+        // EXOSIS END
         CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
         if (fileout.IsNull())
-            return error("%s: Failed to open file %s", __func__, pathDB.string());
+            // EXOSIS BEGIN
+            //return error("%s: Failed to open file %s", __func__, pathDB.string());
+            return error("%s: Failed to open file %s", __func__, pathTmp.string());
+            // EXOSIS END
 
         // Write and commit header, data
         try {
+            // EXOSIS BEGIN
+            //fileout << ssObj;
+            fileout << ssHeader;
             fileout << ssObj;
+            // EXOSIS END
         }
         catch (std::exception &e) {
             return error("%s: Serialize or I/O error - %s", __func__, e.what());
         }
+        // EXOSIS BEGIN
+        if (!FileCommit(fileout.Get()))
+            return error("%s: Failed to commit file %s", __func__, pathTmp.string());
+        // EXOSIS END
         fileout.fclose();
+        // EXOSIS BEGIN
+        if (!RenameOver(pathTmp, pathDB))
+            return error("%s: Rename-into-place failed for %s", __func__, pathDB.string());
+        // EXOSIS END
 
         LogPrintf("Written info to %s  %dms\n", strFilename, GetTimeMillis() - nStart);
         LogPrintf("     %s\n", objToSave.ToString());
@@ -74,52 +182,51 @@ private:
         return true;
     }
 
-    ReadResult Read(T& objToLoad, bool fDryRun = false)
+    // EXOSIS BEGIN
+    /// Verify a file in the legacy format (one checksum over the whole file) and locate the object data
+    ReadResult VerifyLegacy(const unsigned char* pchFile, size_t nFileSize, const unsigned char*& pchPayload, size_t& nPayloadSize)
     {
-        //LOCK(objToLoad.cs);
-
-        int64_t nStart = GetTimeMillis();
-        // open input file, and associate with CAutoFile
-        FILE *file = fopen(pathDB.string().c_str(), "rb");
-        CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
-        if (filein.IsNull())
+        //// use file size to size memory buffer
+        //int fileSize = boost::filesystem::file_size(pathDB);
+        //int dataSize = fileSize - sizeof(uint256);
+        //// Don't try to resize to a negative number if file is small
+        //if (dataSize < 0)
+        //    dataSize = 0;
+        //std::vector<unsigned char> vchData;
+        //vchData.resize(dataSize);
+        //uint256 hashIn;
+        //
+        //// read data and checksum from file
+        //try {
+        //    filein.read((char *)&vchData[0], dataSize);
+        //    filein >> hashIn;
+        //}
+        //catch (std::exception &e) {
+        //    error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        //    return HashReadError;
+        //}
+        //filein.fclose();
+        //
+        //CDataStream ssObj(vchData, SER_DISK, CLIENT_VERSION);
+        if (nFileSize < sizeof(uint256))
         {
-            error("%s: Failed to open file %s", __func__, pathDB.string());
-            return FileError;
-        }
-
-        // use file size to size memory buffer
-        int fileSize = boost::filesystem::file_size(pathDB);
-        int dataSize = fileSize - sizeof(uint256);
-        // Don't try to resize to a negative number if file is small
-        if (dataSize < 0)
-            dataSize = 0;
-        std::vector<unsigned char> vchData;
-        vchData.resize(dataSize);
-        uint256 hashIn;
-
-        // read data and checksum from file
-        try {
-            filein.read((char *)&vchData[0], dataSize);
-            filein >> hashIn;
-        }
-        catch (std::exception &e) {
-            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+            error("%s: Deserialize or I/O error - file too small", __func__);
             return HashReadError;
         }
-        filein.fclose();
-
-        CDataStream ssObj(vchData, SER_DISK, CLIENT_VERSION);
+        const size_t nDataSize = nFileSize - sizeof(uint256);
+        uint256 hashIn;
+        memcpy(hashIn.begin(), pchFile + nDataSize, sizeof(uint256));
 
         // verify stored checksum matches input data
-        uint256 hashTmp = Hash(ssObj.begin(), ssObj.end());
+        //uint256 hashTmp = Hash(ssObj.begin(), ssObj.end());
+        uint256 hashTmp = Hash(pchFile, pchFile + nDataSize);
         if (hashIn != hashTmp)
         {
             error("%s: Checksum mismatch, data corrupted", __func__);
             return IncorrectHash;
         }
 
-
+        CFlatDBReader ssObj(SER_DISK, CLIENT_VERSION, pchFile, pchFile + nDataSize);
         unsigned char pchMsgTmp[4];
         std::string strMagicMessageTmp;
         try {
@@ -143,7 +250,133 @@ private:
                 error("%s: Invalid network magic number", __func__);
                 return IncorrectMagicNumber;
             }
+        }
+        catch (std::exception &e) {
+            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+            return IncorrectFormat;
+        }
+
+        nPayloadSize = ssObj.size();
+        pchPayload = pchFile + nDataSize - nPayloadSize;
+        return Ok;
+    }
+
+    /// Verify a file in the chunked format (see Write) and locate the object data
+    ReadResult VerifyChunked(const unsigned char* pchFile, size_t nFileSize, const unsigned char*& pchPayload, size_t& nPayloadSize)
+    {
+        CFlatDBReader ssHeader(SER_DISK, CLIENT_VERSION, pchFile + sizeof(FLATDB_FILE_SIGNATURE), pchFile + nFileSize);
+        unsigned char pchMsgTmp[4];
+        std::string strMagicMessageTmp;
+        uint64_t nPayloadSizeIn;
+        uint32_t nChunkSize;
+        std::vector<uint256> vChunkHashes;
+        uint256 hashHeaderIn;
+        try {
+            ssHeader >> strMagicMessageTmp >> pchMsgTmp >> nPayloadSizeIn >> nChunkSize >> vChunkHashes >> hashHeaderIn;
+        }
+        catch (std::exception &e) {
+            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+            return HashReadError;
+        }
+
+        // the header checksum covers everything up to itself
+        const size_t nHeaderSize = nFileSize - ssHeader.size();
+        if (hashHeaderIn != Hash(pchFile, pchFile + nHeaderSize - sizeof(uint256)))
+        {
+            error("%s: Header checksum mismatch, data corrupted", __func__);
+            return IncorrectHash;
+        }
+
+        if (strMagicMessage != strMagicMessageTmp)
+        {
+            error("%s: Invalid magic message", __func__);
+            return IncorrectMagicMessage;
+        }
+
+        if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp)))
+        {
+            error("%s: Invalid network magic number", __func__);
+            return IncorrectMagicNumber;
+        }
+
+        if (nChunkSize == 0 || vChunkHashes.size() != (nPayloadSizeIn + nChunkSize - 1) / nChunkSize ||
+            nPayloadSizeIn != ssHeader.size())
+        {
+            error("%s: Payload size does not match the file size, data corrupted", __func__);
+            return IncorrectHash;
+        }
+
+        // the chunks are hashed straight from the mapping, pages are faulted in by the worker hashing them
+        pchPayload = pchFile + nHeaderSize;
+        nPayloadSize = nPayloadSizeIn;
+        std::atomic<bool> fCorrupted(false);
+        ParallelForEach(vChunkHashes.size(), 1, [&](size_t i) {
+            const uint64_t nChunkStart = (uint64_t)i * nChunkSize;
+            const uint64_t nChunkEnd = std::min<uint64_t>(nChunkStart + nChunkSize, nPayloadSize);
+            if (vChunkHashes[i] != Hash(pchPayload + nChunkStart, pchPayload + nChunkEnd)) {
+                fCorrupted = true;
+            }
+        });
+        if (fCorrupted)
+        {
+            error("%s: Checksum mismatch, data corrupted", __func__);
+            return IncorrectHash;
+        }
+
+        return Ok;
+    }
 
+    //ReadResult Read(T& objToLoad, bool fDryRun = false)
+    ReadResult Read(T& objToLoad)
+    {
+        //LOCK(objToLoad.cs);
+
+        int64_t nStart = GetTimeMillis();
+
+        // open input file and map it read-only, the object is deserialized straight from the mapping
+        //FILE *file = fopen(pathDB.string().c_str(), "rb");
+        //CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+        //if (filein.IsNull())
+        boost::system::error_code ec;
+        const uintmax_t nFileSize = boost::filesystem::file_size(pathDB, ec);
+        if (ec)
+        {
+            error("%s: Failed to open file %s", __func__, pathDB.string());
+            return FileError;
+        }
+        if (nFileSize < sizeof(uint256))
+        {
+            error("%s: Deserialize or I/O error - file too small", __func__);
+            return HashReadError;
+        }
+
+        boost::interprocess::file_mapping mapping;
+        boost::interprocess::mapped_region region;
+        try {
+            boost::interprocess::file_mapping(pathDB.string().c_str(), boost::interprocess::read_only).swap(mapping);
+            boost::interprocess::mapped_region(mapping, boost::interprocess::read_only).swap(region);
+        }
+        catch (std::exception &e) {
+            error("%s: Failed to map file %s - %s", __func__, pathDB.string(), e.what());
+            return FileError;
+        }
+        const unsigned char* pchFile = static_cast<const unsigned char*>(region.get_address());
+
+        const unsigned char* pchPayload = nullptr;
+        size_t nPayloadSize = 0;
+        ReadResult readResult;
+        if (region.get_size() >= sizeof(FLATDB_FILE_SIGNATURE) &&
+            memcmp(pchFile, FLATDB_FILE_SIGNATURE, sizeof(FLATDB_FILE_SIGNATURE)) == 0) {
+            readResult = VerifyChunked(pchFile, region.get_size(), pchPayload, nPayloadSize);
+        } else {
+            readResult = VerifyLegacy(pchFile, region.get_size(), pchPayload, nPayloadSize);
+        }
+        if (readResult != Ok)
+            return readResult;
+
+        CFlatDBReader ssObj(SER_DISK, CLIENT_VERSION, pchPayload, pchPayload + nPayloadSize);
+        try {
+        // EXOSIS END
             // de-serialize data into T object
             ssObj >> objToLoad;
         }
@@ -155,11 +388,15 @@ private:
 
         LogPrintf("Loaded info from %s  %dms\n", strFilename, GetTimeMillis() - nStart);
         LogPrintf("     %s\n", objToLoad.ToString());
-        if(!fDryRun) {
+        // EXOSIS BEGIN
+        //if(!fDryRun) {
+        // EXOSIS END
             LogPrintf("%s: Cleaning....\n", __func__);
             objToLoad.CheckAndRemove();
             LogPrintf("     %s\n", objToLoad.ToString());
-        }
+        // EXOSIS BEGIN
+        //}
+        // EXOSIS END
 
         return Ok;
     }
@@ -199,27 +436,34 @@ public:
     {
         int64_t nStart = GetTimeMillis();
 
-        LogPrintf("Verifying %s format...\n", strFilename);
-        T tmpObjToLoad;
-        ReadResult readResult = Read(tmpObjToLoad, true);
-
-        // there was an error and it was not an error on file opening => do not proceed
-        if (readResult == FileError)
-            LogPrintf("Missing file %s, will try to recreate\n", strFilename);
-        else if (readResult != Ok)
-        {
-            LogPrintf("Error reading %s: ", strFilename);
-            if(readResult == IncorrectFormat)
-                LogPrintf("%s: Magic is ok but data has invalid format, will try to recreate\n", __func__);
-            else
-            {
-                LogPrintf("%s: File format is unknown or invalid, please fix it manually\n", __func__);
-                return false;
-            }
-        }
+        // EXOSIS BEGIN
+        //LogPrintf("Verifying %s format...\n", strFilename);
+        //T tmpObjToLoad;
+        //ReadResult readResult = Read(tmpObjToLoad, true);
+        //
+        //// there was an error and it was not an error on file opening => do not proceed
+        //if (readResult == FileError)
+        //    LogPrintf("Missing file %s, will try to recreate\n", strFilename);
+        //else if (readResult != Ok)
+        //{
+        //    LogPrintf("Error reading %s: ", strFilename);
+        //    if(readResult == IncorrectFormat)
+        //        LogPrintf("%s: Magic is ok but data has invalid format, will try to recreate\n", __func__);
+        //    else
+        //    {
+        //        LogPrintf("%s: File format is unknown or invalid, please fix it manually\n", __func__);
+        //        return false;
+        //    }
+        //}
+        // the old file is not read back, Write replaces it atomically
+        // EXOSIS END
 
         LogPrintf("Writing info to %s...\n", strFilename);
-        Write(objToSave);
+        // EXOSIS BEGIN
+        //Write(objToSave);
+        if (!Write(objToSave))
+            return false;
+        // EXOSIS END
         LogPrintf("%s dump finished  %dms\n", strFilename, GetTimeMillis() - nStart);
 
         return true;
@@ -729,6 +729,17 @@ void CGovernanceObject::CheckOrphanVotes(CConnman& connman)
 {
     int64_t nNow = GetAdjustedTime();
     const vote_mcache_t::list_t& listVotes = mapOrphanVotes.GetItemList();
+    // EXOSIS BEGIN
+    // check the signatures in parallel first, ProcessVote() then hits the signature cache
+    std::vector<CHashSignatureCheck> vecChecks;
+    for(const auto& item : listVotes) {
+        CHashSignatureCheck check;
+        if(item.value.second >= nNow && item.value.first.GetSignatureCheck(check)) {
+            vecChecks.push_back(std::move(check));
+        }
+    }
+    CHashSigner::VerifyHashes(vecChecks);
+    // EXOSIS END
     vote_mcache_t::list_cit it = listVotes.begin();
     while(it != listVotes.end()) {
         bool fRemove = false;
@@ -254,6 +254,12 @@ public:
         return fileVotes;
     }
 
+    // EXOSIS BEGIN
+    const CGovernanceObjectVoteFile& GetVoteFile() const {
+        return fileVotes;
+    }
+    // EXOSIS END
+
     // Signature related functions
 
     void SetMasternodeVin(const COutPoint& outpoint);
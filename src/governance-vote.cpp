@@ -239,6 +239,25 @@ void CGovernanceVote::Relay(CConnman& connman) const
     connman.RelayInv(inv, MIN_GOVERNANCE_PEER_PROTO_VERSION);
 }
 
+// EXOSIS BEGIN
+std::string CGovernanceVote::GetSignatureMessage() const
+{
+    return vinMasternode.prevout.ToStringShort() + "|" + nParentHash.ToString() + "|" +
+        boost::lexical_cast<std::string>(nVoteSignal) + "|" + boost::lexical_cast<std::string>(nVoteOutcome) + "|" + boost::lexical_cast<std::string>(nTime);
+}
+
+bool CGovernanceVote::GetSignatureCheck(CHashSignatureCheck& checkRet) const
+{
+    masternode_info_t infoMn;
+    if(!mnodeman.GetMasternodeInfo(vinMasternode.prevout, infoMn)) {
+        return false;
+    }
+
+    checkRet = CHashSignatureCheck(CMessageSigner::GetMessageHash(GetSignatureMessage()), infoMn.pubKeyMasternode, vchSig);
+    return true;
+}
+// EXOSIS END
+
 bool CGovernanceVote::Sign(CKey& keyMasternode, CPubKey& pubKeyMasternode)
 {
     // Choose coins to use
@@ -246,8 +265,11 @@ bool CGovernanceVote::Sign(CKey& keyMasternode, CPubKey& pubKeyMasternode)
     CKey keyCollateralAddress;
 
     std::string strError;
-    std::string strMessage = vinMasternode.prevout.ToStringShort() + "|" + nParentHash.ToString() + "|" +
-        boost::lexical_cast<std::string>(nVoteSignal) + "|" + boost::lexical_cast<std::string>(nVoteOutcome) + "|" + boost::lexical_cast<std::string>(nTime);
+    // EXOSIS BEGIN
+    //std::string strMessage = vinMasternode.prevout.ToStringShort() + "|" + nParentHash.ToString() + "|" +
+    //    boost::lexical_cast<std::string>(nVoteSignal) + "|" + boost::lexical_cast<std::string>(nVoteOutcome) + "|" + boost::lexical_cast<std::string>(nTime);
+    std::string strMessage = GetSignatureMessage();
+    // EXOSIS END
 
     if(!CMessageSigner::SignMessage(strMessage, vchSig, keyMasternode)) {
         LogPrintf("CGovernanceVote::Sign -- SignMessage() failed\n");
@@ -269,15 +291,29 @@ bool CGovernanceVote::IsValid(bool fSignatureCheck) const
         return false;
     }
 
+    // EXOSIS BEGIN
+    // votes are stored in compact form, which only keeps the outpoint of the masternode input
+    if(vinMasternode != CTxIn(vinMasternode.prevout) || vchSig.size() > CPubKey::COMPACT_SIGNATURE_SIZE) {
+        LogPrint(BCLog::GOBJECT, "CGovernanceVote::IsValid -- Non-canonical masternode input or signature - %s\n", GetHash().ToString());
+        return false;
+    }
+    // EXOSIS END
+
     // support up to 50 actions (implemented in sentinel)
-    if(nVoteSignal > MAX_SUPPORTED_VOTE_SIGNAL)
+    // EXOSIS BEGIN
+    //if(nVoteSignal > MAX_SUPPORTED_VOTE_SIGNAL)
+    if(nVoteSignal < 0 || nVoteSignal > MAX_SUPPORTED_VOTE_SIGNAL)
+    // EXOSIS END
     {
         LogPrint(BCLog::GOBJECT, "CGovernanceVote::IsValid -- Client attempted to vote on invalid signal(%d) - %s\n", nVoteSignal, GetHash().ToString());
         return false;
     }
 
     // 0=none, 1=yes, 2=no, 3=abstain. Beyond that reject votes
-    if(nVoteOutcome > 3)
+    // EXOSIS BEGIN
+    //if(nVoteOutcome > 3)
+    if(nVoteOutcome < 0 || nVoteOutcome > 3)
+    // EXOSIS END
     {
         LogPrint(BCLog::GOBJECT, "CGovernanceVote::IsValid -- Client attempted to vote on invalid outcome(%d) - %s\n", nVoteSignal, GetHash().ToString());
         return false;
@@ -292,8 +328,11 @@ bool CGovernanceVote::IsValid(bool fSignatureCheck) const
     if(!fSignatureCheck) return true;
 
     std::string strError;
-    std::string strMessage = vinMasternode.prevout.ToStringShort() + "|" + nParentHash.ToString() + "|" +
-        boost::lexical_cast<std::string>(nVoteSignal) + "|" + boost::lexical_cast<std::string>(nVoteOutcome) + "|" + boost::lexical_cast<std::string>(nTime);
+    // EXOSIS BEGIN
+    //std::string strMessage = vinMasternode.prevout.ToStringShort() + "|" + nParentHash.ToString() + "|" +
+    //    boost::lexical_cast<std::string>(nVoteSignal) + "|" + boost::lexical_cast<std::string>(nVoteOutcome) + "|" + boost::lexical_cast<std::string>(nTime);
+    std::string strMessage = GetSignatureMessage();
+    // EXOSIS END
 
     if(!CMessageSigner::VerifyMessage(infoMn.pubKeyMasternode, vchSig, strMessage, strError)) {
         LogPrintf("CGovernanceVote::IsValid -- VerifyMessage() failed, error: %s\n", strError);
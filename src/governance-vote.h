@@ -9,6 +9,9 @@
 #define DASH_GOVERNANCE_VOTE_H
 
 #include <key.h>
+// EXOSIS BEGIN
+#include <messagesigner.h>
+// EXOSIS END
 #include <primitives/transaction.h>
 
 #include <boost/lexical_cast.hpp>
@@ -104,6 +107,10 @@ private:
     int64_t nTime;
     std::vector<unsigned char> vchSig;
 
+    // EXOSIS BEGIN
+    std::string GetSignatureMessage() const;
+    // EXOSIS END
+
 public:
     CGovernanceVote();
     CGovernanceVote(COutPoint outpointMasternodeIn, uint256 nParentHashIn, vote_signal_enum_t eVoteSignalIn, vote_outcome_enum_t eVoteOutcomeIn);
@@ -124,8 +131,16 @@ public:
 
     void SetSignature(const std::vector<unsigned char>& vchSigIn) { vchSig = vchSigIn; }
 
+    // EXOSIS BEGIN
+    const std::vector<unsigned char>& GetSignature() const { return vchSig; }
+    // EXOSIS END
+
     bool Sign(CKey& keyMasternode, CPubKey& pubKeyMasternode);
     bool IsValid(bool fSignatureCheck) const;
+    // EXOSIS BEGIN
+    /// Signature check for CHashSigner::VerifyHashes(), false if the masternode is unknown
+    bool GetSignatureCheck(CHashSignatureCheck& checkRet) const;
+    // EXOSIS END
     void Relay(CConnman& connman) const;
 
     std::string GetVoteString() const {
@@ -141,15 +156,32 @@ public:
     */
 
     uint256 GetHash() const
+    {
+        // EXOSIS BEGIN
+        //CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+        //ss << vinMasternode;
+        //ss << nParentHash;
+        //ss << nVoteSignal;
+        //ss << nVoteOutcome;
+        //ss << nTime;
+        //return ss.GetHash();
+        return GetHash(vinMasternode.prevout, nParentHash, nVoteSignal, nVoteOutcome, nTime);
+        // EXOSIS END
+    }
+
+    // EXOSIS BEGIN
+    /// Hash of a vote with these fields, for votes stored in compact form
+    static uint256 GetHash(const COutPoint& outpointMasternode, const uint256& nParentHash, int nVoteSignal, int nVoteOutcome, int64_t nTime)
     {
         CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
-        ss << vinMasternode;
+        ss << CTxIn(outpointMasternode);
         ss << nParentHash;
         ss << nVoteSignal;
         ss << nVoteOutcome;
         ss << nTime;
         return ss.GetHash();
     }
+    // EXOSIS END
 
     std::string ToString() const
     {
@@ -6,30 +6,87 @@
 
 #include <governance-votedb.h>
 
+// EXOSIS BEGIN
+#include <memusage.h>
+
+#include <limits>
+// EXOSIS END
+
 CGovernanceObjectVoteFile::CGovernanceObjectVoteFile()
-    : nMemoryVotes(0),
-      listVotes(),
+    // EXOSIS BEGIN
+    //: nMemoryVotes(0),
+    //  listVotes(),
+    //  mapVoteIndex()
+    : nParentHash(),
+      vecMasternodes(),
+      vecRecords(),
+      vchSigs(),
+      mapMasternodeIndex(),
       mapVoteIndex()
+    // EXOSIS END
 {}
 
-CGovernanceObjectVoteFile::CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other)
-    : nMemoryVotes(other.nMemoryVotes),
-      listVotes(other.listVotes),
-      mapVoteIndex()
+// EXOSIS BEGIN
+//CGovernanceObjectVoteFile::CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other)
+//    : nMemoryVotes(other.nMemoryVotes),
+//      listVotes(other.listVotes),
+//      mapVoteIndex()
+//{
+//    RebuildIndex();
+//}
+
+CGovernanceVote CGovernanceObjectVoteFile::CVoteRef::GetVote() const
+{
+    CGovernanceVote vote(GetMasternodeOutpoint(), file.nParentHash, GetSignal(), GetOutcome());
+    vote.SetTime(record.nTime);
+    vote.SetSignature(std::vector<unsigned char>(file.vchSigs.begin() + record.nSigOffset,
+                                                 file.vchSigs.begin() + record.nSigOffset + record.nSigSize));
+    return vote;
+}
+
+void CGovernanceObjectVoteFile::AddRecord(const COutPoint& outpointMasternode, vote_signal_enum_t eSignal, vote_outcome_enum_t eOutcome,
+                                          int64_t nTime, const unsigned char* pchSig, size_t nSigSize)
 {
-    RebuildIndex();
+    auto it = mapMasternodeIndex.find(outpointMasternode);
+    if(it == mapMasternodeIndex.end()) {
+        it = mapMasternodeIndex.emplace(outpointMasternode, vecMasternodes.size()).first;
+        vecMasternodes.push_back(outpointMasternode);
+    }
+
+    CVoteRecord record;
+    record.nMasternode = it->second;
+    record.nSignal = eSignal;
+    record.nOutcome = eOutcome;
+    record.nSigSize = nSigSize;
+    record.nSigOffset = vchSigs.size();
+    record.nTime = nTime;
+    vchSigs.insert(vchSigs.end(), pchSig, pchSig + nSigSize);
+    vecRecords.push_back(record);
 }
+// EXOSIS END
 
 void CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote)
 {
-    listVotes.push_front(vote);
-    mapVoteIndex[vote.GetHash()] = listVotes.begin();
-    ++nMemoryVotes;
+    // EXOSIS BEGIN
+    //listVotes.push_front(vote);
+    //mapVoteIndex[vote.GetHash()] = listVotes.begin();
+    //++nMemoryVotes;
+    // all votes of a file are for the same object
+    if(vecRecords.empty()) {
+        nParentHash = vote.GetParentHash();
+    }
+    const std::vector<unsigned char>& vchSig = vote.GetSignature();
+    AddRecord(vote.GetMasternodeOutpoint(), vote.GetSignal(), vote.GetOutcome(), vote.GetTimestamp(), vchSig.data(), vchSig.size());
+    mapVoteIndex[vote.GetHash()] = vecRecords.size() - 1;
+    // EXOSIS END
 }
 
 bool CGovernanceObjectVoteFile::HasVote(const uint256& nHash) const
 {
-    vote_m_cit it = mapVoteIndex.find(nHash);
+    // EXOSIS BEGIN
+    //vote_m_cit it = mapVoteIndex.find(nHash);
+    auto it = mapVoteIndex.find(nHash);
+    // EXOSIS END
     if(it == mapVoteIndex.end()) {
         return false;
     }
@@ -38,61 +95,156 @@ bool CGovernanceObjectVoteFile::HasVote(const uint256& nHash) const
 
 bool CGovernanceObjectVoteFile::GetVote(const uint256& nHash, CGovernanceVote& vote) const
 {
-    vote_m_cit it = mapVoteIndex.find(nHash);
+    // EXOSIS BEGIN
+    //vote_m_cit it = mapVoteIndex.find(nHash);
+    auto it = mapVoteIndex.find(nHash);
+    // EXOSIS END
     if(it == mapVoteIndex.end()) {
         return false;
     }
-    vote = *(it->second);
+    // EXOSIS BEGIN
+    //vote = *(it->second);
+    vote = CVoteRef(*this, vecRecords[it->second]).GetVote();
+    // EXOSIS END
     return true;
 }
 
 std::vector<CGovernanceVote> CGovernanceObjectVoteFile::GetVotes() const
 {
     std::vector<CGovernanceVote> vecResult;
-    for(vote_l_cit it = listVotes.begin(); it != listVotes.end(); ++it) {
-        vecResult.push_back(*it);
+    // EXOSIS BEGIN
+    //for(vote_l_cit it = listVotes.begin(); it != listVotes.end(); ++it) {
+    //    vecResult.push_back(*it);
+    //}
+    vecResult.reserve(vecRecords.size());
+    for(const CVoteRef& vote : *this) {
+        vecResult.push_back(vote.GetVote());
     }
+    // EXOSIS END
     return vecResult;
 }
 
 void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
 {
-    vote_l_it it = listVotes.begin();
-    while(it != listVotes.end()) {
-        if(it->GetMasternodeOutpoint() == outpointMasternode) {
-            --nMemoryVotes;
-            mapVoteIndex.erase(it->GetHash());
-            listVotes.erase(it++);
+    // EXOSIS BEGIN
+    //vote_l_it it = listVotes.begin();
+    //while(it != listVotes.end()) {
+    //    if(it->GetMasternodeOutpoint() == outpointMasternode) {
+    //        --nMemoryVotes;
+    //        mapVoteIndex.erase(it->GetHash());
+    //        listVotes.erase(it++);
+    //    }
+    //    else {
+    //        ++it;
+    //    }
+    //}
+    auto it = mapMasternodeIndex.find(outpointMasternode);
+    if(it == mapMasternodeIndex.end()) {
+        return;
+    }
+    const uint32_t nMasternode = it->second;
+
+    // compact the records and their signatures in place, signatures are stored in record order
+    // so they only ever move towards the front of the buffer
+    std::vector<uint32_t> vecNewIndex(vecRecords.size(), std::numeric_limits<uint32_t>::max());
+    size_t nRecords = 0;
+    size_t nSigs = 0;
+    for(size_t i = 0; i < vecRecords.size(); ++i) {
+        CVoteRecord record = vecRecords[i];
+        if(record.nMasternode == nMasternode) {
+            continue;
         }
-        else {
-            ++it;
+        if(record.nMasternode > nMasternode) {
+            --record.nMasternode;
+        }
+        if(record.nSigOffset != nSigs) {
+            memmove(vchSigs.data() + nSigs, vchSigs.data() + record.nSigOffset, record.nSigSize);
+            record.nSigOffset = nSigs;
+        }
+        nSigs += record.nSigSize;
+        vecNewIndex[i] = nRecords;
+        vecRecords[nRecords++] = record;
+    }
+    vecRecords.resize(nRecords);
+    vchSigs.resize(nSigs);
+
+    // the hashes of the kept votes do not change, only their positions
+    for(auto itVote = mapVoteIndex.begin(); itVote != mapVoteIndex.end(); ) {
+        const uint32_t nNewIndex = vecNewIndex[itVote->second];
+        if(nNewIndex == std::numeric_limits<uint32_t>::max()) {
+            itVote = mapVoteIndex.erase(itVote);
+        } else {
+            itVote->second = nNewIndex;
+            ++itVote;
         }
     }
+
+    mapMasternodeIndex.erase(it);
+    vecMasternodes.erase(vecMasternodes.begin() + nMasternode);
+    for(auto& pair : mapMasternodeIndex) {
+        if(pair.second > nMasternode) {
+            --pair.second;
+        }
+    }
+    // EXOSIS END
 }
 
-CGovernanceObjectVoteFile& CGovernanceObjectVoteFile::operator=(const CGovernanceObjectVoteFile& other)
+// EXOSIS BEGIN
+//CGovernanceObjectVoteFile& CGovernanceObjectVoteFile::operator=(const CGovernanceObjectVoteFile& other)
+//{
+//    nMemoryVotes = other.nMemoryVotes;
+//    listVotes = other.listVotes;
+//    RebuildIndex();
+//    return *this;
+//}
+
+size_t CGovernanceObjectVoteFile::DynamicMemoryUsage() const
 {
-    nMemoryVotes = other.nMemoryVotes;
-    listVotes = other.listVotes;
-    RebuildIndex();
-    return *this;
+    return memusage::DynamicUsage(vecMasternodes) + memusage::DynamicUsage(vecRecords) + memusage::DynamicUsage(vchSigs) +
+           memusage::DynamicUsage(mapMasternodeIndex) + memusage::DynamicUsage(mapVoteIndex);
 }
+// EXOSIS END
 
 void CGovernanceObjectVoteFile::RebuildIndex()
 {
     mapVoteIndex.clear();
-    nMemoryVotes = 0;
-    vote_l_it it = listVotes.begin();
-    while(it != listVotes.end()) {
-        CGovernanceVote& vote = *it;
-        uint256 nHash = vote.GetHash();
-        if(mapVoteIndex.find(nHash) == mapVoteIndex.end()) {
-            mapVoteIndex[nHash] = it;
-            ++nMemoryVotes;
-            ++it;
+    // EXOSIS BEGIN
+    //nMemoryVotes = 0;
+    //vote_l_it it = listVotes.begin();
+    //while(it != listVotes.end()) {
+    //    CGovernanceVote& vote = *it;
+    //    uint256 nHash = vote.GetHash();
+    //    if(mapVoteIndex.find(nHash) == mapVoteIndex.end()) {
+    //        mapVoteIndex[nHash] = it;
+    //        ++nMemoryVotes;
+    //        ++it;
+    //    }
+    //    else {
+    //        listVotes.erase(it++);
+    //    }
+    //}
+    mapMasternodeIndex.clear();
+    for(size_t i = 0; i < vecMasternodes.size(); ++i) {
+        if(!mapMasternodeIndex.emplace(vecMasternodes[i], i).second) {
+            throw std::ios_base::failure("CGovernanceObjectVoteFile: duplicate masternode");
+        }
+    }
+
+    // drop duplicate votes, their signatures stay in the buffer until the next compaction
+    // which relies on the signatures being stored in record order
+    size_t nRecords = 0;
+    uint64_t nSigEnd = 0;
+    for(size_t i = 0; i < vecRecords.size(); ++i) {
+        const CVoteRecord& record = vecRecords[i];
+        if(record.nMasternode >= vecMasternodes.size() || record.nSigOffset < nSigEnd ||
+           (uint64_t)record.nSigOffset + record.nSigSize > vchSigs.size()) {
+            throw std::ios_base::failure("CGovernanceObjectVoteFile: invalid vote record");
         }
-        else {
-            listVotes.erase(it++);
+        nSigEnd = (uint64_t)record.nSigOffset + record.nSigSize;
+        if(mapVoteIndex.emplace(CVoteRef(*this, record).GetHash(), nRecords).second) {
+            vecRecords[nRecords++] = record;
         }
     }
+    vecRecords.resize(nRecords);
+    // EXOSIS END
 }
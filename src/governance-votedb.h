@@ -7,12 +7,21 @@
 #ifndef DASH_GOVERNANCE_VOTEDB_H
 #define DASH_GOVERNANCE_VOTEDB_H
 
-#include <list>
-#include <map>
+// EXOSIS BEGIN
+//#include <list>
+//#include <map>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+// EXOSIS END
 
 #include <governance-vote.h>
 #include <serialize.h>
 #include <uint256.h>
+// EXOSIS BEGIN
+#include <primitives/transaction.h>
+#include <util/hasher.h>
+// EXOSIS END
 
 /**
  * Represents the collection of votes associated with a given CGovernanceObject
@@ -22,8 +31,18 @@
  * Note: This is a stub implementation that doesn't limit the number of votes held
  * in memory and doesn't flush to disk.
  */
+// EXOSIS BEGIN
+/**
+ * Votes are stored in compact records. All votes of a file share the parent
+ * hash, the masternode outpoints are stored once per masternode and the
+ * signatures are appended to a single buffer.
+ * Iteration and GetVotes return the newest vote first, like the list they replace.
+ */
+// EXOSIS END
 class CGovernanceObjectVoteFile
 {
+// EXOSIS BEGIN
+/*
 public: // Types
     typedef std::list<CGovernanceVote> vote_l_t;
 
@@ -45,11 +64,105 @@ private:
     vote_l_t listVotes;
 
     vote_m_t mapVoteIndex;
+*/
+public: // Types
+    struct CVoteRecord
+    {
+        uint32_t nMasternode; // index into vecMasternodes
+        uint8_t nSignal;
+        uint8_t nOutcome;
+        uint16_t nSigSize;
+        uint32_t nSigOffset; // offset into vchSigs
+        int64_t nTime;
+
+        ADD_SERIALIZE_METHODS;
+
+        template <typename Stream, typename Operation>
+        inline void SerializationOp(Stream& s, Operation ser_action)
+        {
+            READWRITE(nMasternode);
+            READWRITE(nSignal);
+            READWRITE(nOutcome);
+            READWRITE(nSigSize);
+            READWRITE(nSigOffset);
+            READWRITE(nTime);
+        }
+    };
+
+    /**
+     * Read-only view of a stored vote, valid until the file is modified
+     */
+    class CVoteRef
+    {
+    private:
+        const CGovernanceObjectVoteFile& file;
+        const CVoteRecord& record;
+
+    public:
+        CVoteRef(const CGovernanceObjectVoteFile& fileIn, const CVoteRecord& recordIn) : file(fileIn), record(recordIn) {}
+
+        const COutPoint& GetMasternodeOutpoint() const { return file.vecMasternodes[record.nMasternode]; }
+
+        vote_signal_enum_t GetSignal() const { return vote_signal_enum_t(record.nSignal); }
+
+        vote_outcome_enum_t GetOutcome() const { return vote_outcome_enum_t(record.nOutcome); }
+
+        int64_t GetTimestamp() const { return record.nTime; }
+
+        uint256 GetHash() const
+        {
+            return CGovernanceVote::GetHash(GetMasternodeOutpoint(), file.nParentHash, record.nSignal, record.nOutcome, record.nTime);
+        }
+
+        /// Copy of the full vote, including the signature
+        CGovernanceVote GetVote() const;
+    };
+
+    /**
+     * Iterates the records from the newest to the oldest
+     */
+    class const_iterator
+    {
+    private:
+        const CGovernanceObjectVoteFile* pfile;
+        std::vector<CVoteRecord>::const_reverse_iterator it;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef CVoteRef value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef CVoteRef reference;
+
+        const_iterator(const CGovernanceObjectVoteFile* pfileIn, std::vector<CVoteRecord>::const_reverse_iterator itIn) : pfile(pfileIn), it(itIn) {}
+
+        CVoteRef operator*() const { return CVoteRef(*pfile, *it); }
+        const_iterator& operator++() { ++it; return *this; }
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+    };
+
+private:
+    uint256 nParentHash;
+
+    std::vector<COutPoint> vecMasternodes;
+
+    std::vector<CVoteRecord> vecRecords;
+
+    std::vector<unsigned char> vchSigs;
+
+    // not serialized
+    std::unordered_map<COutPoint, uint32_t, SaltedOutpointHasher> mapMasternodeIndex;
+
+    std::unordered_map<uint256, uint32_t, SaltedTxidHasher> mapVoteIndex;
+// EXOSIS END
 
 public:
     CGovernanceObjectVoteFile();
 
-    CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other);
+    // EXOSIS BEGIN
+    //CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other);
+    // EXOSIS END
 
     /**
      * Add a vote to the file
@@ -66,13 +179,26 @@ public:
      */
     bool GetVote(const uint256& nHash, CGovernanceVote& vote) const;
 
-    int GetVoteCount() {
-        return nMemoryVotes;
+    // EXOSIS BEGIN
+    //int GetVoteCount() {
+    //    return nMemoryVotes;
+    //}
+    int GetVoteCount() const {
+        return vecRecords.size();
     }
 
+    const_iterator begin() const { return const_iterator(this, vecRecords.rbegin()); }
+
+    const_iterator end() const { return const_iterator(this, vecRecords.rend()); }
+
+    size_t DynamicMemoryUsage() const;
+    // EXOSIS END
+
     std::vector<CGovernanceVote> GetVotes() const;
 
-    CGovernanceObjectVoteFile& operator=(const CGovernanceObjectVoteFile& other);
+    // EXOSIS BEGIN
+    //CGovernanceObjectVoteFile& operator=(const CGovernanceObjectVoteFile& other);
+    // EXOSIS END
 
     void RemoveVotesFromMasternode(const COutPoint& outpointMasternode);
 
@@ -81,8 +207,14 @@ public:
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action)
     {
-        READWRITE(nMemoryVotes);
-        READWRITE(listVotes);
+        // EXOSIS BEGIN
+        //READWRITE(nMemoryVotes);
+        //READWRITE(listVotes);
+        READWRITE(nParentHash);
+        READWRITE(vecMasternodes);
+        READWRITE(vecRecords);
+        READWRITE(vchSigs);
+        // EXOSIS END
         if(ser_action.ForRead()) {
             RebuildIndex();
         }
@@ -90,6 +222,10 @@ public:
 private:
     void RebuildIndex();
 
+    // EXOSIS BEGIN
+    void AddRecord(const COutPoint& outpointMasternode, vote_signal_enum_t eSignal, vote_outcome_enum_t eOutcome,
+                   int64_t nTime, const unsigned char* pchSig, size_t nSigSize);
+    // EXOSIS END
 };
 
 #endif // DASH_GOVERNANCE_VOTEDB_H
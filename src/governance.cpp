@@ -25,7 +25,10 @@ CGovernanceManager governance;
 
 int nSubmittedFinalBudget;
 
-const std::string CGovernanceManager::SERIALIZATION_VERSION_STRING = "CGovernanceManager-Version-12";
+// EXOSIS BEGIN
+//const std::string CGovernanceManager::SERIALIZATION_VERSION_STRING = "CGovernanceManager-Version-12";
+const std::string CGovernanceManager::SERIALIZATION_VERSION_STRING = "CGovernanceManager-Version-13";
+// EXOSIS END
 const int CGovernanceManager::MAX_TIME_FUTURE_DEVIATION = 60*60;
 const int CGovernanceManager::RELIABLE_PROPAGATION_TIME = 60;
 
@@ -105,7 +108,9 @@ bool CGovernanceManager::SerializeVoteForHash(uint256 nHash, CDataStream& ss)
     return true;
 }
 
-void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+// EXOSIS BEGIN
+//void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+void CGovernanceManager::ProcessSyncMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
 {
     // lite mode is not supported
     if(fLiteMode) return;
@@ -114,170 +119,182 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
     if(pfrom->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) return;
 
     // ANOTHER USER IS ASKING US TO HELP THEM SYNC GOVERNANCE OBJECT DATA
-    if (strCommand == NetMsgType::MNGOVERNANCESYNC)
-    {
 
-        // Ignore such requests until we are fully synced.
-        // We could start processing this after masternode list is synced
-        // but this is a heavy one so it's better to finish sync first.
-        if (!masternodeSync.IsSynced()) return;
+    // Ignore such requests until we are fully synced.
+    // We could start processing this after masternode list is synced
+    // but this is a heavy one so it's better to finish sync first.
+    if (!masternodeSync.IsSynced()) return;
 
-        uint256 nProp;
-        CBloomFilter filter;
+    uint256 nProp;
+    CBloomFilter filter;
 
-        vRecv >> nProp;
+    vRecv >> nProp;
 
-        if(pfrom->nVersion >= GOVERNANCE_FILTER_PROTO_VERSION) {
-            vRecv >> filter;
-            filter.UpdateEmptyFull();
-        }
-        else {
-            filter.clear();
-        }
+    if(pfrom->nVersion >= GOVERNANCE_FILTER_PROTO_VERSION) {
+        vRecv >> filter;
+        filter.UpdateEmptyFull();
+    }
+    else {
+        filter.clear();
+    }
 
-        if(nProp == uint256()) {
-            if(netfulfilledman.HasFulfilledRequest(pfrom->addr, NetMsgType::MNGOVERNANCESYNC)) {
-                // Asking for the whole list multiple times in a short period of time is no good
-                LogPrint(BCLog::GOBJECT, "MNGOVERNANCESYNC -- peer already asked me for the list\n");
-                Misbehaving(pfrom->GetId(), 20);
-                return;
-            }
-            netfulfilledman.AddFulfilledRequest(pfrom->addr, NetMsgType::MNGOVERNANCESYNC);
+    if(nProp == uint256()) {
+        if(netfulfilledman.HasFulfilledRequest(pfrom->addr, NetMsgType::MNGOVERNANCESYNC)) {
+            // Asking for the whole list multiple times in a short period of time is no good
+            LogPrint(BCLog::GOBJECT, "MNGOVERNANCESYNC -- peer already asked me for the list\n");
+            Misbehaving(pfrom->GetId(), 20);
+            return;
         }
+        netfulfilledman.AddFulfilledRequest(pfrom->addr, NetMsgType::MNGOVERNANCESYNC);
+    }
 
-        Sync(pfrom, nProp, filter, connman);
-        LogPrint(BCLog::GOBJECT, "MNGOVERNANCESYNC -- syncing governance objects to our peer at %s\n", pfrom->addr.ToString());
+    Sync(pfrom, nProp, filter, connman);
+    LogPrint(BCLog::GOBJECT, "MNGOVERNANCESYNC -- syncing governance objects to our peer at %s\n", pfrom->addr.ToString());
+}
+// EXOSIS END
 
-    }
+// EXOSIS BEGIN
+// A NEW GOVERNANCE OBJECT HAS ARRIVED
+void CGovernanceManager::ProcessObjectMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    // lite mode is not supported
+    if(fLiteMode) return;
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-    // A NEW GOVERNANCE OBJECT HAS ARRIVED
-    else if (strCommand == NetMsgType::MNGOVERNANCEOBJECT)
-    {
-        // MAKE SURE WE HAVE A VALID REFERENCE TO THE TIP BEFORE CONTINUING
+    if(pfrom->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) return;
 
-        CGovernanceObject govobj;
-        vRecv >> govobj;
+    // MAKE SURE WE HAVE A VALID REFERENCE TO THE TIP BEFORE CONTINUING
 
-        uint256 nHash = govobj.GetHash();
+    CGovernanceObject govobj;
+    vRecv >> govobj;
 
-        pfrom->setAskFor.erase(nHash);
+    uint256 nHash = govobj.GetHash();
 
-        if(!masternodeSync.IsMasternodeListSynced()) {
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- masternode list not synced\n");
-            return;
-        }
+    pfrom->RemoveAskFor(nHash);
 
-        std::string strHash = nHash.ToString();
+    if(!masternodeSync.IsMasternodeListSynced()) {
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- masternode list not synced\n");
+        return;
+    }
 
-        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Received object: %s\n", strHash);
+    std::string strHash = nHash.ToString();
 
-        if(!AcceptObjectMessage(nHash)) {
-            LogPrintf("MNGOVERNANCEOBJECT -- Received unrequested object: %s\n", strHash);
-            return;
-        }
+    LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Received object: %s\n", strHash);
 
-        LOCK2(cs_main, cs);
+    if(!AcceptObjectMessage(nHash)) {
+        LogPrintf("MNGOVERNANCEOBJECT -- Received unrequested object: %s\n", strHash);
+        return;
+    }
 
-        if(mapObjects.count(nHash) || mapPostponedObjects.count(nHash) ||
-           mapErasedGovernanceObjects.count(nHash) || mapMasternodeOrphanObjects.count(nHash)) {
-            // TODO - print error code? what if it's GOVOBJ_ERROR_IMMATURE?
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Received already seen object: %s\n", strHash);
-            return;
-        }
+    LOCK2(cs_main, cs);
 
-        bool fRateCheckBypassed = false;
-        if(!MasternodeRateCheck(govobj, true, false, fRateCheckBypassed)) {
-            LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
-            return;
-        }
+    if(mapObjects.count(nHash) || mapPostponedObjects.count(nHash) ||
+       mapErasedGovernanceObjects.count(nHash) || mapMasternodeOrphanObjects.count(nHash)) {
+        // TODO - print error code? what if it's GOVOBJ_ERROR_IMMATURE?
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Received already seen object: %s\n", strHash);
+        return;
+    }
 
-        std::string strError = "";
-        // CHECK OBJECT AGAINST LOCAL BLOCKCHAIN
+    bool fRateCheckBypassed = false;
+    if(!MasternodeRateCheck(govobj, true, false, fRateCheckBypassed)) {
+        LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
+        return;
+    }
 
-        bool fMasternodeMissing = false;
-        bool fMissingConfirmations = false;
-        bool fIsValid = govobj.IsValidLocally(strError, fMasternodeMissing, fMissingConfirmations, true);
+    std::string strError = "";
+    // CHECK OBJECT AGAINST LOCAL BLOCKCHAIN
 
-        if(fRateCheckBypassed && (fIsValid || fMasternodeMissing)) {
-            if(!MasternodeRateCheck(govobj, true)) {
-                LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed (after signature verification) - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
-                return;
-            }
-        }
+    bool fMasternodeMissing = false;
+    bool fMissingConfirmations = false;
+    bool fIsValid = govobj.IsValidLocally(strError, fMasternodeMissing, fMissingConfirmations, true);
 
-        if(!fIsValid) {
-            if(fMasternodeMissing) {
+    if(fRateCheckBypassed && (fIsValid || fMasternodeMissing)) {
+        if(!MasternodeRateCheck(govobj, true)) {
+            LogPrintf("MNGOVERNANCEOBJECT -- masternode rate check failed (after signature verification) - %s - (current block height %d) \n", strHash, nCachedBlockHeight);
+            return;
+        }
+    }
 
-                int& count = mapMasternodeOrphanCounter[govobj.GetMasternodeVin().prevout];
-                if (count >= 10) {
-                    LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Too many orphan objects, missing masternode=%s\n", govobj.GetMasternodeVin().prevout.ToStringShort());
-                    // ask for this object again in 2 minutes
-                    CInv inv(MSG_GOVERNANCE_OBJECT, govobj.GetHash());
-                    pfrom->AskFor(inv);
-                    return;
-                }
+    if(!fIsValid) {
+        if(fMasternodeMissing) {
 
-                count++;
-                ExpirationInfo info(pfrom->GetId(), GetAdjustedTime() + GOVERNANCE_ORPHAN_EXPIRATION_TIME);
-                mapMasternodeOrphanObjects.insert(std::make_pair(nHash, object_info_pair_t(govobj, info)));
-                LogPrintf("MNGOVERNANCEOBJECT -- Missing masternode for: %s, strError = %s\n", strHash, strError);
-            } else if(fMissingConfirmations) {
-                AddPostponedObject(govobj);
-                LogPrintf("MNGOVERNANCEOBJECT -- Not enough fee confirmations for: %s, strError = %s\n", strHash, strError);
-            } else {
-                LogPrintf("MNGOVERNANCEOBJECT -- Governance object is invalid - %s\n", strError);
-                // apply node's ban score
-                Misbehaving(pfrom->GetId(), 20);
+            int& count = mapMasternodeOrphanCounter[govobj.GetMasternodeVin().prevout];
+            if (count >= 10) {
+                LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECT -- Too many orphan objects, missing masternode=%s\n", govobj.GetMasternodeVin().prevout.ToStringShort());
+                // ask for this object again in 2 minutes
+                CInv inv(MSG_GOVERNANCE_OBJECT, govobj.GetHash());
+                pfrom->AskFor(inv);
+                return;
             }
 
-            return;
+            count++;
+            ExpirationInfo info(pfrom->GetId(), GetAdjustedTime() + GOVERNANCE_ORPHAN_EXPIRATION_TIME);
+            mapMasternodeOrphanObjects.insert(std::make_pair(nHash, object_info_pair_t(govobj, info)));
+            LogPrintf("MNGOVERNANCEOBJECT -- Missing masternode for: %s, strError = %s\n", strHash, strError);
+        } else if(fMissingConfirmations) {
+            AddPostponedObject(govobj);
+            LogPrintf("MNGOVERNANCEOBJECT -- Not enough fee confirmations for: %s, strError = %s\n", strHash, strError);
+        } else {
+            LogPrintf("MNGOVERNANCEOBJECT -- Governance object is invalid - %s\n", strError);
+            // apply node's ban score
+            Misbehaving(pfrom->GetId(), 20);
         }
 
-        AddGovernanceObject(govobj, connman, pfrom);
+        return;
     }
 
-    // A NEW GOVERNANCE OBJECT VOTE HAS ARRIVED
-    else if (strCommand == NetMsgType::MNGOVERNANCEOBJECTVOTE)
-    {
-        CGovernanceVote vote;
-        vRecv >> vote;
+    AddGovernanceObject(govobj, connman, pfrom);
+}
+// EXOSIS END
 
-        uint256 nHash = vote.GetHash();
+// EXOSIS BEGIN
+// A NEW GOVERNANCE OBJECT VOTE HAS ARRIVED
+void CGovernanceManager::ProcessObjectVoteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    // lite mode is not supported
+    if(fLiteMode) return;
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        pfrom->setAskFor.erase(nHash);
+    if(pfrom->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) return;
 
-        // Ignore such messages until masternode list is synced
-        if(!masternodeSync.IsMasternodeListSynced()) {
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- masternode list not synced\n");
-            return;
-        }
+    CGovernanceVote vote;
+    vRecv >> vote;
 
-        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Received vote: %s\n", vote.ToString());
+    uint256 nHash = vote.GetHash();
 
-        std::string strHash = nHash.ToString();
+    pfrom->RemoveAskFor(nHash);
 
-        if(!AcceptVoteMessage(nHash)) {
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Received unrequested vote object: %s, hash: %s, peer = %d\n",
-                      vote.ToString(), strHash, pfrom->GetId());
-            return;
-        }
+    // Ignore such messages until masternode list is synced
+    if(!masternodeSync.IsMasternodeListSynced()) {
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- masternode list not synced\n");
+        return;
+    }
 
-        CGovernanceException exception;
-        if(ProcessVote(pfrom, vote, exception, connman)) {
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- %s new\n", strHash);
-            masternodeSync.BumpAssetLastTime("MNGOVERNANCEOBJECTVOTE");
-            vote.Relay(connman);
-        }
-        else {
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Rejected vote, error = %s\n", exception.what());
-            if((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
-                Misbehaving(pfrom->GetId(), exception.GetNodePenalty());
-            }
-            return;
-        }
+    LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Received vote: %s\n", vote.ToString());
+
+    std::string strHash = nHash.ToString();
 
+    if(!AcceptVoteMessage(nHash)) {
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Received unrequested vote object: %s, hash: %s, peer = %d\n",
+                  vote.ToString(), strHash, pfrom->GetId());
+        return;
+    }
+
+    CGovernanceException exception;
+    if(ProcessVote(pfrom, vote, exception, connman)) {
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- %s new\n", strHash);
+        masternodeSync.BumpAssetLastTime("MNGOVERNANCEOBJECTVOTE");
+        vote.Relay(connman);
+    }
+    else {
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Rejected vote, error = %s\n", exception.what());
+        if((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
+            Misbehaving(pfrom->GetId(), exception.GetNodePenalty());
+        }
+        return;
     }
 }
+// EXOSIS END
 
 void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernanceException& exception, CConnman& connman)
 {
@@ -288,6 +305,17 @@ void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernance
     ScopedLockBool guard(cs, fRateChecksEnabled, false);
 
     int64_t nNow = GetAdjustedTime();
+    // EXOSIS BEGIN
+    // check the signatures in parallel first, ProcessVote() then hits the signature cache
+    std::vector<CHashSignatureCheck> vecChecks;
+    for(const vote_time_pair_t& pairVote : vecVotePairs) {
+        CHashSignatureCheck check;
+        if(pairVote.second >= nNow && pairVote.first.GetSignatureCheck(check)) {
+            vecChecks.push_back(std::move(check));
+        }
+    }
+    CHashSigner::VerifyHashes(vecChecks);
+    // EXOSIS END
     for(size_t i = 0; i < vecVotePairs.size(); ++i) {
         bool fRemove = false;
         vote_time_pair_t& pairVote = vecVotePairs[i];
@@ -598,32 +626,49 @@ std::vector<CGovernanceVote> CGovernanceManager::GetCurrentVotes(const uint256&
     if(it == mapObjects.end()) return vecResult;
     CGovernanceObject& govobj = it->second;
 
-    CMasternode mn;
-    std::map<COutPoint, CMasternode> mapMasternodes;
-    if(mnCollateralOutpointFilter == COutPoint()) {
-        mapMasternodes = mnodeman.GetFullMasternodeMap();
-    } else if (mnodeman.Get(mnCollateralOutpointFilter, mn)) {
-        mapMasternodes[mnCollateralOutpointFilter] = mn;
-    }
-
-    // Loop thru each MN collateral outpoint and get the votes for the `nParentHash` governance object
-    for (auto& mnpair : mapMasternodes)
-    {
-        // get a vote_rec_t from the govobj
-        vote_rec_t voteRecord;
-        if (!govobj.GetCurrentMNVotes(mnpair.first, voteRecord)) continue;
-
-        for (vote_instance_m_it it3 = voteRecord.mapInstances.begin(); it3 != voteRecord.mapInstances.end(); ++it3) {
-            int signal = (it3->first);
-            int outcome = ((it3->second).eOutcome);
-            int64_t nCreationTime = ((it3->second).nCreationTime);
-
-            CGovernanceVote vote = CGovernanceVote(mnpair.first, nParentHash, (vote_signal_enum_t)signal, (vote_outcome_enum_t)outcome);
-            vote.SetTime(nCreationTime);
+    // EXOSIS BEGIN
+    //CMasternode mn;
+    //std::map<COutPoint, CMasternode> mapMasternodes;
+    //if(mnCollateralOutpointFilter == COutPoint()) {
+    //    mapMasternodes = mnodeman.GetFullMasternodeMap();
+    //} else if (mnodeman.Get(mnCollateralOutpointFilter, mn)) {
+    //    mapMasternodes[mnCollateralOutpointFilter] = mn;
+    //}
+    //
+    //// Loop thru each MN collateral outpoint and get the votes for the `nParentHash` governance object
+    //for (auto& mnpair : mapMasternodes)
+    //{
+    //    // get a vote_rec_t from the govobj
+    //    vote_rec_t voteRecord;
+    //    if (!govobj.GetCurrentMNVotes(mnpair.first, voteRecord)) continue;
+    //
+    //    for (vote_instance_m_it it3 = voteRecord.mapInstances.begin(); it3 != voteRecord.mapInstances.end(); ++it3) {
+    //        int signal = (it3->first);
+    //        int outcome = ((it3->second).eOutcome);
+    //        int64_t nCreationTime = ((it3->second).nCreationTime);
+    //
+    //        CGovernanceVote vote = CGovernanceVote(mnpair.first, nParentHash, (vote_signal_enum_t)signal, (vote_outcome_enum_t)outcome);
+    //        vote.SetTime(nCreationTime);
+    //
+    //        vecResult.push_back(vote);
+    //    }
+    //}
+
+    // Walk the current votes of the object, which are usually far fewer than the masternodes,
+    // and keep those of masternodes still in the list, looked up without copying the list
+    for (const auto& votepair : govobj.mapCurrentMNVotes) {
+        const COutPoint& outpoint = votepair.first;
+        if (mnCollateralOutpointFilter != COutPoint() && outpoint != mnCollateralOutpointFilter) continue;
+        if (!mnodeman.Has(outpoint)) continue;
+
+        for (const auto& instancepair : votepair.second.mapInstances) {
+            CGovernanceVote vote = CGovernanceVote(outpoint, nParentHash, (vote_signal_enum_t)instancepair.first, instancepair.second.eOutcome);
+            vote.SetTime(instancepair.second.nCreationTime);
 
             vecResult.push_back(vote);
         }
     }
+    // EXOSIS END
 
     return vecResult;
 }
@@ -801,11 +846,32 @@ void CGovernanceManager::Sync(CNode* pfrom, const uint256& nProp, const CBloomFi
             pfrom->PushInventory(CInv(MSG_GOVERNANCE_OBJECT, it->first));
             ++nObjCount;
 
-            std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
-            for(size_t i = 0; i < vecVotes.size(); ++i) {
-                if(filter.contains(vecVotes[i].GetHash())) {
-                    continue;
+            // EXOSIS BEGIN
+            //std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
+            // only the votes the peer doesn't have yet are copied out of the vote file
+            std::vector<CGovernanceVote> vecVotes;
+            for(const auto& voteRef : govobj.GetVoteFile()) {
+                if(!filter.contains(voteRef.GetHash())) {
+                    vecVotes.push_back(voteRef.GetVote());
+                }
+            }
+            // check the signatures in parallel first, the IsValid(true) calls below then hit the signature cache
+            std::vector<CHashSignatureCheck> vecChecks;
+            vecChecks.reserve(vecVotes.size());
+            for(const CGovernanceVote& vote : vecVotes) {
+                CHashSignatureCheck check;
+                if(vote.GetSignatureCheck(check)) {
+                    vecChecks.push_back(std::move(check));
                 }
+            }
+            CHashSigner::VerifyHashes(vecChecks);
+            // EXOSIS END
+            for(size_t i = 0; i < vecVotes.size(); ++i) {
+                // EXOSIS BEGIN
+                //if(filter.contains(vecVotes[i].GetHash())) {
+                //    continue;
+                //}
+                // EXOSIS END
                 if(!vecVotes[i].IsValid(true)) {
                     continue;
                 }
@@ -1128,11 +1194,17 @@ void CGovernanceManager::RequestGovernanceObject(CNode* pfrom, const uint256& nH
 
         if(pObj) {
             filter = CBloomFilter(Params().GetConsensus().nGovernanceFilterElements, GOVERNANCE_FILTER_FP_RATE, GetRandInt(999999), BLOOM_UPDATE_ALL);
-            std::vector<CGovernanceVote> vecVotes = pObj->GetVoteFile().GetVotes();
-            nVoteCount = vecVotes.size();
-            for(size_t i = 0; i < vecVotes.size(); ++i) {
-                filter.insert(vecVotes[i].GetHash());
+            // EXOSIS BEGIN
+            //std::vector<CGovernanceVote> vecVotes = pObj->GetVoteFile().GetVotes();
+            //nVoteCount = vecVotes.size();
+            //for(size_t i = 0; i < vecVotes.size(); ++i) {
+            //    filter.insert(vecVotes[i].GetHash());
+            //}
+            nVoteCount = pObj->GetVoteFile().GetVoteCount();
+            for(const auto& voteRef : pObj->GetVoteFile()) {
+                filter.insert(voteRef.GetHash());
             }
+            // EXOSIS END
         }
     }
 
@@ -1225,7 +1297,10 @@ int CGovernanceManager::RequestGovernanceObjectVotes(const std::vector<CNode*>&
             // only use up to date peers
             if(pnode->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) continue;
             // stop early to prevent setAskFor overflow
-            size_t nProjectedSize = pnode->setAskFor.size() + nProjectedVotes;
+            // EXOSIS BEGIN
+            //size_t nProjectedSize = pnode->setAskFor.size() + nProjectedVotes;
+            size_t nProjectedSize = pnode->GetAskForCount() + nProjectedVotes;
+            // EXOSIS END
             if(nProjectedSize > SETASKFOR_MAX_SZ/2) continue;
             // to early to ask the same node
             if(mapAskedRecently[nHashGovobj].count(pnode->addr)) continue;
@@ -1279,10 +1354,15 @@ void CGovernanceManager::RebuildIndexes()
     mapVoteToObject.Clear();
     for(object_m_it it = mapObjects.begin(); it != mapObjects.end(); ++it) {
         CGovernanceObject& govobj = it->second;
-        std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
-        for(size_t i = 0; i < vecVotes.size(); ++i) {
-            mapVoteToObject.Insert(vecVotes[i].GetHash(), &govobj);
+        // EXOSIS BEGIN
+        //std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
+        //for(size_t i = 0; i < vecVotes.size(); ++i) {
+        //    mapVoteToObject.Insert(vecVotes[i].GetHash(), &govobj);
+        //}
+        for(const auto& voteRef : govobj.GetVoteFile()) {
+            mapVoteToObject.Insert(voteRef.GetHash(), &govobj);
         }
+        // EXOSIS END
     }
 }
 
@@ -1320,10 +1400,16 @@ std::string CGovernanceManager::ToString() const
     int nTriggerCount = 0;
     int nWatchdogCount = 0;
     int nOtherCount = 0;
+    // EXOSIS BEGIN
+    size_t nVoteMemoryUsage = 0;
+    // EXOSIS END
 
     object_m_cit it = mapObjects.begin();
 
     while(it != mapObjects.end()) {
+        // EXOSIS BEGIN
+        nVoteMemoryUsage += it->second.GetVoteFile().DynamicMemoryUsage();
+        // EXOSIS END
         switch(it->second.GetObjectType()) {
             case GOVERNANCE_OBJECT_PROPOSAL:
                 nProposalCount++;
@@ -1341,10 +1427,16 @@ std::string CGovernanceManager::ToString() const
         ++it;
     }
 
-    return strprintf("Governance Objects: %d (Proposals: %d, Triggers: %d, Watchdogs: %d/%d, Other: %d; Erased: %d), Votes: %d",
+    // EXOSIS BEGIN
+    //return strprintf("Governance Objects: %d (Proposals: %d, Triggers: %d, Watchdogs: %d/%d, Other: %d; Erased: %d), Votes: %d",
+    //                (int)mapObjects.size(),
+    //                nProposalCount, nTriggerCount, nWatchdogCount, mapWatchdogObjects.size(), nOtherCount, (int)mapErasedGovernanceObjects.size(),
+    //                (int)mapVoteToObject.GetSize());
+    return strprintf("Governance Objects: %d (Proposals: %d, Triggers: %d, Watchdogs: %d/%d, Other: %d; Erased: %d), Votes: %d, vote memory usage: %u",
                     (int)mapObjects.size(),
                     nProposalCount, nTriggerCount, nWatchdogCount, mapWatchdogObjects.size(), nOtherCount, (int)mapErasedGovernanceObjects.size(),
-                    (int)mapVoteToObject.GetSize());
+                    (int)mapVoteToObject.GetSize(), nVoteMemoryUsage);
+    // EXOSIS END
 }
 
 void CGovernanceManager::UpdatedBlockTip(const CBlockIndex *pindex, CConnman& connman)
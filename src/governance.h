@@ -303,7 +303,13 @@ public:
 
     void Sync(CNode* node, const uint256& nProp, const CBloomFilter& filter, CConnman& connman);
 
-    void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS BEGIN
+    //void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Handlers of the MNGOVERNANCESYNC, MNGOVERNANCEOBJECT and MNGOVERNANCEOBJECTVOTE messages
+    void ProcessSyncMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessObjectMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessObjectVoteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS END
 
     void DoMaintenance(CConnman& connman);
 
@@ -348,6 +354,13 @@ public:
         std::string strVersion;
         if(ser_action.ForRead()) {
             READWRITE(strVersion);
+            // EXOSIS BEGIN
+            // older versions store the votes differently, don't even try to read them
+            if(strVersion != SERIALIZATION_VERSION_STRING) {
+                Clear();
+                return;
+            }
+            // EXOSIS END
         }
         else {
             strVersion = SERIALIZATION_VERSION_STRING;
@@ -21,6 +21,7 @@
 #include <checkpoints.h>
 #include <compat/sanity.h>
 #include <consensus/validation.h>
+#include <crypto/x16r.h>
 #include <fs.h>
 #include <httpserver.h>
 #include <httprpc.h>
@@ -253,6 +254,10 @@ void Shutdown(InitInterfaces& interfaces)
     // Because these depend on each-other, we make sure that neither can be
     // using the other before destroying them.
     if (peerLogic) UnregisterValidationInterface(peerLogic.get());
+    // EXOSIS BEGIN
+    // The queued messages hold references to nodes which CConnman::Stop deletes
+    StopDashMessageQueues();
+    // EXOSIS END
     if (g_connman) g_connman->Stop();
     if (g_txindex) g_txindex->Stop();
 
@@ -537,6 +542,9 @@ void SetupServerArgs()
         "and level 4 tries to reconnect the blocks, "
         "each level includes the checks of the previous levels "
         "(0-4, default: %u)", DEFAULT_CHECKLEVEL), true, OptionsCategory::DEBUG_TEST);
+    // EXOSIS BEGIN
+    gArgs.AddArg("-checkblockindexpow", strprintf("Re-verify the proof-of-work of every block index entry at startup instead of trusting earlier verification (default: %u)", DEFAULT_CHECKBLOCKINDEXPOW), true, OptionsCategory::DEBUG_TEST);
+    // EXOSIS END
     gArgs.AddArg("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. (default: %u, regtest: %u)", defaultChainParams->DefaultConsistencyChecks(), regtestChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u, regtest: %u)", defaultChainParams->DefaultConsistencyChecks(), regtestChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED), true, OptionsCategory::DEBUG_TEST);
@@ -1087,6 +1095,9 @@ bool AppInitParameterInteraction()
         mempool.setSanityCheck(1.0 / ratio);
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
+    // EXOSIS BEGIN
+    fCheckBlockIndexPoW = gArgs.GetBoolArg("-checkblockindexpow", DEFAULT_CHECKBLOCKINDEXPOW);
+    // EXOSIS END
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
@@ -1278,6 +1289,10 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    // EXOSIS BEGIN
+    std::string x16r_algo = X16RAutoDetect();
+    LogPrintf("Using the '%s' X16R implementation\n", x16r_algo);
+    // EXOSIS END
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1359,6 +1374,10 @@ bool AppInitMain(InitInterfaces& interfaces)
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        // EXOSIS BEGIN
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadMessageSignatureCheck);
+        // EXOSIS END
     }
 
     // Dash
@@ -2040,6 +2059,9 @@ bool AppInitMain(InitInterfaces& interfaces)
             connOptions.m_specified_outgoing = connect;
         }
     }
+    // EXOSIS BEGIN
+    StartDashMessageQueues();
+    // EXOSIS END
     if (!g_connman->Start(scheduler, connOptions)) {
         return false;
     }
@@ -5,11 +5,17 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <activemasternode.h>
+// EXOSIS BEGIN
+#include <core_memusage.h>
+// EXOSIS END
 #include <instantx.h>
 #include <key.h>
 #include <validation.h>
 #include <masternode-sync.h>
 #include <masternodeman.h>
+// EXOSIS BEGIN
+#include <memusage.h>
+// EXOSIS END
 #include <messagesigner.h>
 #include <net.h>
 #include <protocol.h>
@@ -46,45 +52,45 @@ CInstantSend instantsend;
 // CInstantSend
 //
 
-void CInstantSend::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+// EXOSIS BEGIN
+//void CInstantSend::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+void CInstantSend::ProcessTxLockVoteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
 {
     if(fLiteMode) return; // disable all Dash specific functionality
     if(!sporkManager.IsSporkActive(SPORK_2_INSTANTSEND_ENABLED)) return;
 
     // NOTE: NetMsgType::TXLOCKREQUEST is handled via ProcessMessage() in main.cpp
 
-    if (strCommand == NetMsgType::TXLOCKVOTE) // InstantSend Transaction Lock Consensus Votes
-    {
-        if(pfrom->nVersion < MIN_INSTANTSEND_PROTO_VERSION) return;
+    if(pfrom->nVersion < MIN_INSTANTSEND_PROTO_VERSION) return;
 
-        CTxLockVote vote;
-        vRecv >> vote;
+    CTxLockVote vote;
+    vRecv >> vote;
 
 
-        uint256 nVoteHash = vote.GetHash();
+    uint256 nVoteHash = vote.GetHash();
 
-        pfrom->setAskFor.erase(nVoteHash);
+    pfrom->RemoveAskFor(nVoteHash);
 
-        // Ignore any InstantSend messages until masternode list is synced
-        if(!masternodeSync.IsMasternodeListSynced()) return;
+    // Ignore any InstantSend messages until masternode list is synced
+    if(!masternodeSync.IsMasternodeListSynced()) return;
 
-        LOCK(cs_main);
+    LOCK(cs_main);
 #ifdef ENABLE_WALLET
-        std::vector<std::shared_ptr<CWallet>> wallets = GetWallets();
-        CWallet * const pwallet = (wallets.size() > 0) ? wallets[0].get() : nullptr;
-        if (pwallet)
-            LOCK(pwallet->cs_wallet);
+    std::vector<std::shared_ptr<CWallet>> wallets = GetWallets();
+    CWallet * const pwallet = (wallets.size() > 0) ? wallets[0].get() : nullptr;
+    if (pwallet)
+        LOCK(pwallet->cs_wallet);
 #endif
-        LOCK(cs_instantsend);
+    LOCK(cs_instantsend);
 
-        if(mapTxLockVotes.count(nVoteHash)) return;
-        mapTxLockVotes.insert(std::make_pair(nVoteHash, vote));
+    if(mapTxLockVotes.count(nVoteHash)) return;
+    mapTxLockVotes.insert(std::make_pair(nVoteHash, vote));
 
-        ProcessTxLockVote(pfrom, vote, connman);
+    ProcessTxLockVote(pfrom, vote, connman);
 
-        return;
-    }
+    return;
 }
+// EXOSIS END
 
 bool CInstantSend::ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CConnman& connman)
 {
@@ -94,7 +100,10 @@ bool CInstantSend::ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CCo
 
     // Check to see if we conflict with existing completed lock
     for (const auto& txin : txLockRequest.vin) {
-        std::map<COutPoint, uint256>::iterator it = mapLockedOutpoints.find(txin.prevout);
+        // EXOSIS BEGIN
+        //std::map<COutPoint, uint256>::iterator it = mapLockedOutpoints.find(txin.prevout);
+        auto it = mapLockedOutpoints.find(txin.prevout);
+        // EXOSIS END
         if(it != mapLockedOutpoints.end() && it->second != txLockRequest.GetHash()) {
             // Conflicting with complete lock, proceed to see if we should cancel them both
             LogPrintf("CInstantSend::ProcessTxLockRequest -- WARNING: Found conflicting completed Transaction Lock, txid=%s, completed lock txid=%s\n",
@@ -105,7 +114,10 @@ bool CInstantSend::ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CCo
     // Check to see if there are votes for conflicting request,
     // if so - do not fail, just warn user
     for (const auto& txin : txLockRequest.vin) {
-        std::map<COutPoint, std::set<uint256> >::iterator it = mapVotedOutpoints.find(txin.prevout);
+        // EXOSIS BEGIN
+        //std::map<COutPoint, std::set<uint256> >::iterator it = mapVotedOutpoints.find(txin.prevout);
+        auto it = mapVotedOutpoints.find(txin.prevout);
+        // EXOSIS END
         if(it != mapVotedOutpoints.end()) {
             for (const auto& hash : it->second) {
                 if(hash != txLockRequest.GetHash()) {
@@ -127,7 +139,10 @@ bool CInstantSend::ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CCo
     // Masternodes will sometimes propagate votes before the transaction is known to the client.
     // If this just happened - lock inputs, resolve conflicting locks, update transaction status
     // forcing external script notification.
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     TryToFinalizeLockCandidate(itLockCandidate->second);
 
     return true;
@@ -141,7 +156,10 @@ bool CInstantSend::CreateTxLockCandidate(const CTxLockRequest& txLockRequest)
 
     uint256 txHash = txLockRequest.GetHash();
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if(itLockCandidate == mapTxLockCandidates.end()) {
         LogPrintf("CInstantSend::CreateTxLockCandidate -- new, txid=%s\n", txHash.ToString());
 
@@ -185,7 +203,10 @@ void CInstantSend::Vote(const uint256& txHash, CConnman& connman)
     AssertLockHeld(cs_main);
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if (itLockCandidate == mapTxLockCandidates.end()) return;
     Vote(itLockCandidate->second, connman);
     // Let's see if our vote changed smth
@@ -231,14 +252,20 @@ void CInstantSend::Vote(CTxLockCandidate& txLockCandidate, CConnman& connman)
 
         LogPrint(BCLog::INSTANTSEND, "CInstantSend::Vote -- In the top %d (%d)\n", nSignaturesTotal, nRank);
 
-        std::map<COutPoint, std::set<uint256> >::iterator itVoted = mapVotedOutpoints.find(itOutpointLock->first);
+        // EXOSIS BEGIN
+        //std::map<COutPoint, std::set<uint256> >::iterator itVoted = mapVotedOutpoints.find(itOutpointLock->first);
+        auto itVoted = mapVotedOutpoints.find(itOutpointLock->first);
+        // EXOSIS END
 
         // Check to see if we already voted for this outpoint,
         // refuse to vote twice or to include the same outpoint in another tx
         bool fAlreadyVoted = false;
         if(itVoted != mapVotedOutpoints.end()) {
             for (const auto& hash : itVoted->second) {
-                std::map<uint256, CTxLockCandidate>::iterator it2 = mapTxLockCandidates.find(hash);
+                // EXOSIS BEGIN
+                //std::map<uint256, CTxLockCandidate>::iterator it2 = mapTxLockCandidates.find(hash);
+                auto it2 = mapTxLockCandidates.find(hash);
+                // EXOSIS END
                 if(it2->second.HasMasternodeVoted(itOutpointLock->first, activeMasternode.outpoint)) {
                     // we already voted for this outpoint to be included either in the same tx or in a competing one,
                     // skip it anyway
@@ -320,7 +347,10 @@ bool CInstantSend::ProcessTxLockVote(CNode* pfrom, CTxLockVote& vote, CConnman&
     // Masternodes will sometimes propagate votes before the transaction is known to the client,
     // will actually process only after the lock request itself has arrived
 
-    std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    auto it = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if(it == mapTxLockCandidates.end() || !it->second.txLockRequest) {
         if(!mapTxLockVotesOrphan.count(vote.GetHash())) {
             // start timeout countdown after the very first vote
@@ -329,7 +359,10 @@ bool CInstantSend::ProcessTxLockVote(CNode* pfrom, CTxLockVote& vote, CConnman&
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::ProcessTxLockVote -- Orphan vote: txid=%s  masternode=%s new\n",
                     txHash.ToString(), vote.GetMasternodeOutpoint().ToStringShort());
             bool fReprocess = true;
-            std::map<uint256, CTxLockRequest>::iterator itLockRequest = mapLockRequestAccepted.find(txHash);
+            // EXOSIS BEGIN
+            //std::map<uint256, CTxLockRequest>::iterator itLockRequest = mapLockRequestAccepted.find(txHash);
+            auto itLockRequest = mapLockRequestAccepted.find(txHash);
+            // EXOSIS END
             if(itLockRequest == mapLockRequestAccepted.end()) {
                 itLockRequest = mapLockRequestRejected.find(txHash);
                 if(itLockRequest == mapLockRequestRejected.end()) {
@@ -379,14 +412,20 @@ bool CInstantSend::ProcessTxLockVote(CNode* pfrom, CTxLockVote& vote, CConnman&
 
     LogPrint(BCLog::INSTANTSEND, "CInstantSend::ProcessTxLockVote -- Transaction Lock Vote, txid=%s\n", txHash.ToString());
 
-    std::map<COutPoint, std::set<uint256> >::iterator it1 = mapVotedOutpoints.find(vote.GetOutpoint());
+    // EXOSIS BEGIN
+    //std::map<COutPoint, std::set<uint256> >::iterator it1 = mapVotedOutpoints.find(vote.GetOutpoint());
+    auto it1 = mapVotedOutpoints.find(vote.GetOutpoint());
+    // EXOSIS END
     if(it1 != mapVotedOutpoints.end()) {
         for (const auto& hash : it1->second) {
             if(hash != txHash) {
                 // same outpoint was already voted to be locked by another tx lock request,
                 // let's see if it was the same masternode who voted on this outpoint
                 // for another tx lock request
-                std::map<uint256, CTxLockCandidate>::iterator it2 = mapTxLockCandidates.find(hash);
+                // EXOSIS BEGIN
+                //std::map<uint256, CTxLockCandidate>::iterator it2 = mapTxLockCandidates.find(hash);
+                auto it2 = mapTxLockCandidates.find(hash);
+                // EXOSIS END
                 if(it2 !=mapTxLockCandidates.end() && it2->second.HasMasternodeVoted(vote.GetOutpoint(), vote.GetMasternodeOutpoint())) {
                     // yes, it was the same masternode
                     LogPrintf("CInstantSend::ProcessTxLockVote -- masternode sent conflicting votes! %s\n", vote.GetMasternodeOutpoint().ToStringShort());
@@ -437,7 +476,10 @@ void CInstantSend::ProcessOrphanTxLockVotes(CConnman& connman)
 #endif
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotesOrphan.begin();
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotesOrphan.begin();
+    auto it = mapTxLockVotesOrphan.begin();
+    // EXOSIS END
     while(it != mapTxLockVotesOrphan.end()) {
         if(ProcessTxLockVote(NULL, it->second, connman)) {
             mapTxLockVotesOrphan.erase(it++);
@@ -465,7 +507,10 @@ bool CInstantSend::IsEnoughOrphanVotesForTxAndOutPoint(const uint256& txHash, co
     // Scan orphan votes to check if this outpoint has enough orphan votes to be locked in some tx.
     LOCK2(cs_main, cs_instantsend);
     int nCountVotes = 0;
-    std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotesOrphan.begin();
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotesOrphan.begin();
+    auto it = mapTxLockVotesOrphan.begin();
+    // EXOSIS END
     while(it != mapTxLockVotesOrphan.end()) {
         if(it->second.GetTxHash() == txHash && it->second.GetOutpoint() == outpoint) {
             nCountVotes++;
@@ -557,7 +602,10 @@ void CInstantSend::LockTransactionInputs(const CTxLockCandidate& txLockCandidate
 bool CInstantSend::GetLockedOutPointTxHash(const COutPoint& outpoint, uint256& hashRet)
 {
     LOCK(cs_instantsend);
-    std::map<COutPoint, uint256>::iterator it = mapLockedOutpoints.find(outpoint);
+    // EXOSIS BEGIN
+    //std::map<COutPoint, uint256>::iterator it = mapLockedOutpoints.find(outpoint);
+    auto it = mapLockedOutpoints.find(outpoint);
+    // EXOSIS END
     if(it == mapLockedOutpoints.end()) return false;
     hashRet = it->second;
     return true;
@@ -579,8 +627,14 @@ bool CInstantSend::ResolveConflicts(const CTxLockCandidate& txLockCandidate)
         if(GetLockedOutPointTxHash(txin.prevout, hashConflicting) && txHash != hashConflicting) {
             // completed lock which conflicts with another completed one?
             // this means that majority of MNs in the quorum for this specific tx input are malicious!
-            std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
-            std::map<uint256, CTxLockCandidate>::iterator itLockCandidateConflicting = mapTxLockCandidates.find(hashConflicting);
+            // EXOSIS BEGIN
+            //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+            auto itLockCandidate = mapTxLockCandidates.find(txHash);
+            // EXOSIS END
+            // EXOSIS BEGIN
+            //std::map<uint256, CTxLockCandidate>::iterator itLockCandidateConflicting = mapTxLockCandidates.find(hashConflicting);
+            auto itLockCandidateConflicting = mapTxLockCandidates.find(hashConflicting);
+            // EXOSIS END
             if(itLockCandidate == mapTxLockCandidates.end() || itLockCandidateConflicting == mapTxLockCandidates.end()) {
                 // safety check, should never really happen
                 LogPrintf("CInstantSend::ResolveConflicts -- ERROR: Found conflicting completed Transaction Lock, but one of txLockCandidate-s is missing, txid=%s, conflicting txid=%s\n",
@@ -648,7 +702,10 @@ int64_t CInstantSend::GetAverageMasternodeOrphanVoteTime()
     // NOTE: should never actually call this function when mapMasternodeOrphanVotes is empty
     if(mapMasternodeOrphanVotes.empty()) return 0;
 
-    std::map<COutPoint, int64_t>::iterator it = mapMasternodeOrphanVotes.begin();
+    // EXOSIS BEGIN
+    //std::map<COutPoint, int64_t>::iterator it = mapMasternodeOrphanVotes.begin();
+    auto it = mapMasternodeOrphanVotes.begin();
+    // EXOSIS END
     int64_t total = 0;
 
     while(it != mapMasternodeOrphanVotes.end()) {
@@ -665,7 +722,10 @@ void CInstantSend::CheckAndRemove()
 
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.begin();
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.begin();
+    auto itLockCandidate = mapTxLockCandidates.begin();
+    // EXOSIS END
 
     // remove expired candidates
     while(itLockCandidate != mapTxLockCandidates.end()) {
@@ -688,7 +748,10 @@ void CInstantSend::CheckAndRemove()
     }
 
     // remove expired votes
-    std::map<uint256, CTxLockVote>::iterator itVote = mapTxLockVotes.begin();
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockVote>::iterator itVote = mapTxLockVotes.begin();
+    auto itVote = mapTxLockVotes.begin();
+    // EXOSIS END
     while(itVote != mapTxLockVotes.end()) {
         if(itVote->second.IsExpired(nCachedBlockHeight)) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::CheckAndRemove -- Removing expired vote: txid=%s  masternode=%s\n",
@@ -700,7 +763,10 @@ void CInstantSend::CheckAndRemove()
     }
 
     // remove timed out orphan votes
-    std::map<uint256, CTxLockVote>::iterator itOrphanVote = mapTxLockVotesOrphan.begin();
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockVote>::iterator itOrphanVote = mapTxLockVotesOrphan.begin();
+    auto itOrphanVote = mapTxLockVotesOrphan.begin();
+    // EXOSIS END
     while(itOrphanVote != mapTxLockVotesOrphan.end()) {
         if(itOrphanVote->second.IsTimedOut()) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::CheckAndRemove -- Removing timed out orphan vote: txid=%s  masternode=%s\n",
@@ -725,7 +791,10 @@ void CInstantSend::CheckAndRemove()
     }
 
     // remove timed out masternode orphan votes (DOS protection)
-    std::map<COutPoint, int64_t>::iterator itMasternodeOrphan = mapMasternodeOrphanVotes.begin();
+    // EXOSIS BEGIN
+    //std::map<COutPoint, int64_t>::iterator itMasternodeOrphan = mapMasternodeOrphanVotes.begin();
+    auto itMasternodeOrphan = mapMasternodeOrphanVotes.begin();
+    // EXOSIS END
     while(itMasternodeOrphan != mapMasternodeOrphanVotes.end()) {
         if(itMasternodeOrphan->second < GetTime()) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::CheckAndRemove -- Removing timed out orphan masternode vote: masternode=%s\n",
@@ -768,7 +837,10 @@ bool CInstantSend::GetTxLockRequest(const uint256& txHash, CTxLockRequest& txLoc
 {
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    auto it = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if(it == mapTxLockCandidates.end()) return false;
     txLockRequestRet = it->second.txLockRequest;
 
@@ -779,7 +851,10 @@ bool CInstantSend::GetTxLockVote(const uint256& hash, CTxLockVote& txLockVoteRet
 {
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotes.find(hash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotes.find(hash);
+    auto it = mapTxLockVotes.find(hash);
+    // EXOSIS END
     if(it == mapTxLockVotes.end()) return false;
     txLockVoteRet = it->second;
 
@@ -794,7 +869,10 @@ bool CInstantSend::IsInstantSendReadyToLock(const uint256& txHash)
     LOCK(cs_instantsend);
     // There must be a successfully verified lock request
     // and all outputs must be locked (i.e. have enough signatures)
-    std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    auto it = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     return it != mapTxLockCandidates.end() && it->second.IsAllOutPointsReady();
 }
 
@@ -806,7 +884,10 @@ bool CInstantSend::IsLockedInstantSendTransaction(const uint256& txHash)
     LOCK(cs_instantsend);
 
     // there must be a lock candidate
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if(itLockCandidate == mapTxLockCandidates.end()) return false;
 
     // which should have outpoints
@@ -831,7 +912,10 @@ int CInstantSend::GetTransactionLockSignatures(const uint256& txHash)
 
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if(itLockCandidate != mapTxLockCandidates.end()) {
         return itLockCandidate->second.CountVotes();
     }
@@ -850,7 +934,10 @@ bool CInstantSend::IsTxLockCandidateTimedOut(const uint256& txHash)
 
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if (itLockCandidate != mapTxLockCandidates.end()) {
         return !itLockCandidate->second.IsAllOutPointsReady() &&
                 itLockCandidate->second.IsTimedOut();
@@ -863,7 +950,10 @@ void CInstantSend::Relay(const uint256& txHash, CConnman& connman)
 {
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::const_iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::const_iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if (itLockCandidate != mapTxLockCandidates.end()) {
         itLockCandidate->second.Relay(connman);
     }
@@ -902,7 +992,10 @@ void CInstantSend::SyncTransaction(const CTransaction& tx, const CBlock* pblock)
     LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d\n", txHash.ToString(), nHeightNew);
 
     // Check lock candidates
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
+    // EXOSIS END
     if(itLockCandidate != mapTxLockCandidates.end()) {
         LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d lock candidate updated\n",
                 txHash.ToString(), nHeightNew);
@@ -913,12 +1006,17 @@ void CInstantSend::SyncTransaction(const CTransaction& tx, const CBlock* pblock)
             // Check corresponding lock votes
             std::vector<CTxLockVote> vVotes = itOutpointLock->second.GetVotes();
             std::vector<CTxLockVote>::iterator itVote = vVotes.begin();
-            std::map<uint256, CTxLockVote>::iterator it;
+            // EXOSIS BEGIN
+            //std::map<uint256, CTxLockVote>::iterator it;
+            // EXOSIS END
             while(itVote != vVotes.end()) {
                 uint256 nVoteHash = itVote->GetHash();
                 LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d vote %s updated\n",
                         txHash.ToString(), nHeightNew, nVoteHash.ToString());
-                it = mapTxLockVotes.find(nVoteHash);
+                // EXOSIS BEGIN
+                //it = mapTxLockVotes.find(nVoteHash);
+                auto it = mapTxLockVotes.find(nVoteHash);
+                // EXOSIS END
                 if(it != mapTxLockVotes.end()) {
                     it->second.SetConfirmedHeight(nHeightNew);
                 }
@@ -929,7 +1027,10 @@ void CInstantSend::SyncTransaction(const CTransaction& tx, const CBlock* pblock)
     }
 
     // check orphan votes
-    std::map<uint256, CTxLockVote>::iterator itOrphanVote = mapTxLockVotesOrphan.begin();
+    // EXOSIS BEGIN
+    //std::map<uint256, CTxLockVote>::iterator itOrphanVote = mapTxLockVotesOrphan.begin();
+    auto itOrphanVote = mapTxLockVotesOrphan.begin();
+    // EXOSIS END
     while(itOrphanVote != mapTxLockVotesOrphan.end()) {
         if(itOrphanVote->second.GetTxHash() == txHash) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d vote %s updated\n",
@@ -943,9 +1044,51 @@ void CInstantSend::SyncTransaction(const CTransaction& tx, const CBlock* pblock)
 std::string CInstantSend::ToString()
 {
     LOCK(cs_instantsend);
-    return strprintf("Lock Candidates: %llu, Votes %llu", mapTxLockCandidates.size(), mapTxLockVotes.size());
+    // EXOSIS BEGIN
+    //return strprintf("Lock Candidates: %llu, Votes %llu", mapTxLockCandidates.size(), mapTxLockVotes.size());
+    return strprintf("Lock Candidates: %llu, Votes %llu, memory usage: %u", mapTxLockCandidates.size(), mapTxLockVotes.size(), DynamicMemoryUsage());
+    // EXOSIS END
 }
 
+// EXOSIS BEGIN
+size_t CInstantSend::DynamicMemoryUsage()
+{
+    LOCK(cs_instantsend);
+
+    size_t nUsage = memusage::DynamicUsage(mapLockRequestAccepted) +
+                    memusage::DynamicUsage(mapLockRequestRejected) +
+                    memusage::DynamicUsage(mapTxLockVotes) +
+                    memusage::DynamicUsage(mapTxLockVotesOrphan) +
+                    memusage::DynamicUsage(mapTxLockCandidates) +
+                    memusage::DynamicUsage(mapVotedOutpoints) +
+                    memusage::DynamicUsage(mapLockedOutpoints) +
+                    memusage::DynamicUsage(mapMasternodeOrphanVotes);
+    for (const auto& lockRequestPair : mapLockRequestAccepted) {
+        nUsage += RecursiveDynamicUsage(lockRequestPair.second);
+    }
+    for (const auto& lockRequestPair : mapLockRequestRejected) {
+        nUsage += RecursiveDynamicUsage(lockRequestPair.second);
+    }
+    for (const auto& votedPair : mapVotedOutpoints) {
+        nUsage += memusage::DynamicUsage(votedPair.second);
+    }
+    for (const auto& votePair : mapTxLockVotes) {
+        nUsage += votePair.second.DynamicMemoryUsage();
+    }
+    for (const auto& votePair : mapTxLockVotesOrphan) {
+        nUsage += votePair.second.DynamicMemoryUsage();
+    }
+    for (const auto& candidatePair : mapTxLockCandidates) {
+        const CTxLockCandidate& txLockCandidate = candidatePair.second;
+        nUsage += RecursiveDynamicUsage(txLockCandidate.txLockRequest) + memusage::DynamicUsage(txLockCandidate.mapOutPointLocks);
+        for (const auto& outpointLockPair : txLockCandidate.mapOutPointLocks) {
+            nUsage += outpointLockPair.second.DynamicMemoryUsage();
+        }
+    }
+    return nUsage;
+}
+// EXOSIS END
+
 //
 // CTxLockRequest
 //
@@ -1154,6 +1297,17 @@ bool COutPointLock::HasMasternodeVoted(const COutPoint& outpointMasternodeIn) co
     return mapMasternodeVotes.count(outpointMasternodeIn);
 }
 
+// EXOSIS BEGIN
+size_t COutPointLock::DynamicMemoryUsage() const
+{
+    size_t nUsage = memusage::DynamicUsage(mapMasternodeVotes);
+    for (const auto& votePair : mapMasternodeVotes) {
+        nUsage += votePair.second.DynamicMemoryUsage();
+    }
+    return nUsage;
+}
+// EXOSIS END
+
 void COutPointLock::Relay(CConnman& connman) const
 {
     std::map<COutPoint, CTxLockVote>::const_iterator itVote = mapMasternodeVotes.begin();
@@ -10,6 +10,12 @@
 #include <chain.h>
 #include <net.h>
 #include <primitives/transaction.h>
+// EXOSIS BEGIN
+#include <memusage.h>
+#include <util/hasher.h>
+
+#include <unordered_map>
+// EXOSIS END
 
 class CTxLockVote;
 class COutPointLock;
@@ -50,19 +56,30 @@ private:
     // Keep track of current block height
     int nCachedBlockHeight;
 
+    // EXOSIS BEGIN
+    // lookup-only maps, hashed with a random salt
     // maps for AlreadyHave
-    std::map<uint256, CTxLockRequest> mapLockRequestAccepted; // tx hash - tx
-    std::map<uint256, CTxLockRequest> mapLockRequestRejected; // tx hash - tx
-    std::map<uint256, CTxLockVote> mapTxLockVotes; // vote hash - vote
-    std::map<uint256, CTxLockVote> mapTxLockVotesOrphan; // vote hash - vote
-
-    std::map<uint256, CTxLockCandidate> mapTxLockCandidates; // tx hash - lock candidate
-
-    std::map<COutPoint, std::set<uint256> > mapVotedOutpoints; // utxo - tx hash set
-    std::map<COutPoint, uint256> mapLockedOutpoints; // utxo - tx hash
+    //std::map<uint256, CTxLockRequest> mapLockRequestAccepted; // tx hash - tx
+    //std::map<uint256, CTxLockRequest> mapLockRequestRejected; // tx hash - tx
+    //std::map<uint256, CTxLockVote> mapTxLockVotes; // vote hash - vote
+    //std::map<uint256, CTxLockVote> mapTxLockVotesOrphan; // vote hash - vote
+    std::unordered_map<uint256, CTxLockRequest, SaltedTxidHasher> mapLockRequestAccepted; // tx hash - tx
+    std::unordered_map<uint256, CTxLockRequest, SaltedTxidHasher> mapLockRequestRejected; // tx hash - tx
+    std::unordered_map<uint256, CTxLockVote, SaltedTxidHasher> mapTxLockVotes; // vote hash - vote
+    std::unordered_map<uint256, CTxLockVote, SaltedTxidHasher> mapTxLockVotesOrphan; // vote hash - vote
+
+    //std::map<uint256, CTxLockCandidate> mapTxLockCandidates; // tx hash - lock candidate
+    std::unordered_map<uint256, CTxLockCandidate, SaltedTxidHasher> mapTxLockCandidates; // tx hash - lock candidate
+
+    //std::map<COutPoint, std::set<uint256> > mapVotedOutpoints; // utxo - tx hash set
+    //std::map<COutPoint, uint256> mapLockedOutpoints; // utxo - tx hash
+    std::unordered_map<COutPoint, std::set<uint256>, SaltedOutpointHasher> mapVotedOutpoints; // utxo - tx hash set
+    std::unordered_map<COutPoint, uint256, SaltedOutpointHasher> mapLockedOutpoints; // utxo - tx hash
 
     //track masternodes who voted with no txreq (for DOS protection)
-    std::map<COutPoint, int64_t> mapMasternodeOrphanVotes; // mn outpoint - time
+    //std::map<COutPoint, int64_t> mapMasternodeOrphanVotes; // mn outpoint - time
+    std::unordered_map<COutPoint, int64_t, SaltedOutpointHasher> mapMasternodeOrphanVotes; // mn outpoint - time
+    // EXOSIS END
 
     bool CreateTxLockCandidate(const CTxLockRequest& txLockRequest);
     void CreateEmptyTxLockCandidate(const uint256& txHash);
@@ -86,7 +103,10 @@ private:
 public:
     CCriticalSection cs_instantsend;
 
-    void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS BEGIN
+    //void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    void ProcessTxLockVoteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS END
 
     bool ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CConnman& connman);
     void Vote(const uint256& txHash, CConnman& connman);
@@ -120,6 +140,10 @@ public:
     void SyncTransaction(const CTransaction& tx, const CBlock* pblock);
 
     std::string ToString();
+    // EXOSIS BEGIN
+    /// Heap memory used by the lock maps, lock requests, lock candidates and votes
+    size_t DynamicMemoryUsage();
+    // EXOSIS END
 };
 
 class CTxLockRequest : public CTransaction
@@ -199,6 +223,9 @@ public:
     bool CheckSignature() const;
 
     void Relay(CConnman& connman) const;
+    // EXOSIS BEGIN
+    size_t DynamicMemoryUsage() const { return memusage::DynamicUsage(vchMasternodeSignature); }
+    // EXOSIS END
 };
 
 class COutPointLock
@@ -227,6 +254,9 @@ public:
     void MarkAsAttacked() { fAttacked = true; }
 
     void Relay(CConnman& connman) const;
+    // EXOSIS BEGIN
+    size_t DynamicMemoryUsage() const;
+    // EXOSIS END
 };
 
 class CTxLockCandidate
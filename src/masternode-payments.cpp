@@ -9,6 +9,10 @@
 #include <masternode-payments.h>
 #include <masternode-sync.h>
 #include <masternodeman.h>
+// EXOSIS BEGIN
+#include <core_memusage.h>
+#include <memusage.h>
+// EXOSIS END
 #include <messagesigner.h>
 #include <netfulfilledman.h>
 #include <netmessagemaker.h>
@@ -91,12 +95,13 @@ void CMasternodePayments::FillBlockPayee(CMutableTransaction& txNew, int nBlockH
     CAmount masternodePayment = GetMasternodePayment(nBlockHeight, blockReward);
 
     // EXOSIS BEGIN
-    std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
-    std::map<COutPoint, CMasternode>::iterator mnit = mapMasternodes.begin();
-    while (mnit != mapMasternodes.end()) {
-        if (mnit->second.IsEnabled())
+    //std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
+    CMasternodeMan::mn_map_snapshot_t mapMasternodes = mnodeman.GetMasternodeMapSnapshot();
+    auto mnit = mapMasternodes->begin();
+    while (mnit != mapMasternodes->end()) {
+        if (mnit->second->IsEnabled())
         {
-            CScript payee = GetScriptForDestination(mnit->second.pubKeyCollateralAddress.GetID());
+            CScript payee = GetScriptForDestination(mnit->second->pubKeyCollateralAddress.GetID());
             txoutMasternodeRet = CTxOut(masternodePayment, payee);
             txNew.vout.push_back(txoutMasternodeRet);
 
@@ -107,7 +112,7 @@ void CMasternodePayments::FillBlockPayee(CMutableTransaction& txNew, int nBlockH
         }
         else
         {
-            LogPrint(BCLog::MNPAYMENTS, "CMasternodePayments::FillBlockPayee -- Masternode payment failed to %s - outpoint %s\n", masternodePayment, mnit->second.vin.prevout.ToStringShort());
+            LogPrint(BCLog::MNPAYMENTS, "CMasternodePayments::FillBlockPayee -- Masternode payment failed to %s - outpoint %s\n", masternodePayment, mnit->second->vin.prevout.ToStringShort());
         }
         ++mnit;
     }
@@ -120,119 +125,124 @@ int CMasternodePayments::GetMinMasternodePaymentsProto() {
             : MIN_MASTERNODE_PAYMENT_PROTO_VERSION_1;
 }
 
-void CMasternodePayments::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+// EXOSIS BEGIN
+//void CMasternodePayments::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+void CMasternodePayments::ProcessPaymentSyncMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
 {
     if(fLiteMode) return; // disable all Dash specific functionality
 
-    if (strCommand == NetMsgType::MASTERNODEPAYMENTSYNC) { //Masternode Payments Request Sync
-
-        // Ignore such requests until we are fully synced.
-        // We could start processing this after masternode list is synced
-        // but this is a heavy one so it's better to finish sync first.
-        if (!masternodeSync.IsSynced()) return;
+    // Ignore such requests until we are fully synced.
+    // We could start processing this after masternode list is synced
+    // but this is a heavy one so it's better to finish sync first.
+    if (!masternodeSync.IsSynced()) return;
 
-        int nCountNeeded;
-        vRecv >> nCountNeeded;
+    int nCountNeeded;
+    vRecv >> nCountNeeded;
 
-        if(netfulfilledman.HasFulfilledRequest(pfrom->addr, NetMsgType::MASTERNODEPAYMENTSYNC)) {
-            LOCK(cs_main);
-            // Asking for the payments list multiple times in a short period of time is no good
-            LogPrintf("MASTERNODEPAYMENTSYNC -- peer already asked me for the list, peer=%d\n", pfrom->GetId());
-            Misbehaving(pfrom->GetId(), 20);
-            return;
-        }
-        netfulfilledman.AddFulfilledRequest(pfrom->addr, NetMsgType::MASTERNODEPAYMENTSYNC);
-
-        Sync(pfrom, connman);
-        LogPrintf("MASTERNODEPAYMENTSYNC -- Sent Masternode payment votes to peer %d\n", pfrom->GetId());
-
-    } else if (strCommand == NetMsgType::MASTERNODEPAYMENTVOTE) { // Masternode Payments Vote for the Winner
+    if(netfulfilledman.HasFulfilledRequest(pfrom->addr, NetMsgType::MASTERNODEPAYMENTSYNC)) {
+        LOCK(cs_main);
+        // Asking for the payments list multiple times in a short period of time is no good
+        LogPrintf("MASTERNODEPAYMENTSYNC -- peer already asked me for the list, peer=%d\n", pfrom->GetId());
+        Misbehaving(pfrom->GetId(), 20);
+        return;
+    }
+    netfulfilledman.AddFulfilledRequest(pfrom->addr, NetMsgType::MASTERNODEPAYMENTSYNC);
 
-        CMasternodePaymentVote vote;
-        vRecv >> vote;
+    Sync(pfrom, connman);
+    LogPrintf("MASTERNODEPAYMENTSYNC -- Sent Masternode payment votes to peer %d\n", pfrom->GetId());
+}
+// EXOSIS END
 
-        if(pfrom->nVersion < GetMinMasternodePaymentsProto()) return;
+// EXOSIS BEGIN
+void CMasternodePayments::ProcessPaymentVoteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fLiteMode) return; // disable all Dash specific functionality
 
-        uint256 nHash = vote.GetHash();
+    CMasternodePaymentVote vote;
+    vRecv >> vote;
 
-        pfrom->setAskFor.erase(nHash);
+    if(pfrom->nVersion < GetMinMasternodePaymentsProto()) return;
 
-        // TODO: clear setAskFor for MSG_MASTERNODE_PAYMENT_BLOCK too
+    uint256 nHash = vote.GetHash();
 
-        // Ignore any payments messages until masternode list is synced
-        if(!masternodeSync.IsMasternodeListSynced()) return;
+    pfrom->RemoveAskFor(nHash);
 
-        {
-            LOCK(cs_mapMasternodePaymentVotes);
-            if(mapMasternodePaymentVotes.count(nHash)) {
-                LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- hash=%s, nHeight=%d seen\n", nHash.ToString(), nCachedBlockHeight);
-                return;
-            }
+    // TODO: clear setAskFor for MSG_MASTERNODE_PAYMENT_BLOCK too
 
-            // Avoid processing same vote multiple times
-            mapMasternodePaymentVotes[nHash] = vote;
-            // but first mark vote as non-verified,
-            // AddPaymentVote() below should take care of it if vote is actually ok
-            mapMasternodePaymentVotes[nHash].MarkAsNotVerified();
-        }
+    // Ignore any payments messages until masternode list is synced
+    if(!masternodeSync.IsMasternodeListSynced()) return;
 
-        int nFirstBlock = nCachedBlockHeight - GetStorageLimit();
-        if(vote.nBlockHeight < nFirstBlock || vote.nBlockHeight > nCachedBlockHeight+20) {
-            LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- vote out of range: nFirstBlock=%d, nBlockHeight=%d, nHeight=%d\n", nFirstBlock, vote.nBlockHeight, nCachedBlockHeight);
+    {
+        LOCK(cs_mapMasternodePaymentVotes);
+        if(mapMasternodePaymentVotes.count(nHash)) {
+            LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- hash=%s, nHeight=%d seen\n", nHash.ToString(), nCachedBlockHeight);
             return;
         }
 
-        std::string strError = "";
-        if(!vote.IsValid(pfrom, nCachedBlockHeight, strError, connman)) {
-            LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- invalid message, error: %s\n", strError);
-            return;
-        }
+        // Avoid processing same vote multiple times
+        mapMasternodePaymentVotes[nHash] = vote;
+        // but first mark vote as non-verified,
+        // AddPaymentVote() below should take care of it if vote is actually ok
+        mapMasternodePaymentVotes[nHash].MarkAsNotVerified();
+    }
 
-        if(!CanVote(vote.vinMasternode.prevout, vote.nBlockHeight)) {
-            LogPrintf("MASTERNODEPAYMENTVOTE -- masternode already voted, masternode=%s\n", vote.vinMasternode.prevout.ToStringShort());
-            return;
-        }
+    int nFirstBlock = nCachedBlockHeight - GetStorageLimit();
+    if(vote.nBlockHeight < nFirstBlock || vote.nBlockHeight > nCachedBlockHeight+20) {
+        LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- vote out of range: nFirstBlock=%d, nBlockHeight=%d, nHeight=%d\n", nFirstBlock, vote.nBlockHeight, nCachedBlockHeight);
+        return;
+    }
 
-        masternode_info_t mnInfo;
-        if(!mnodeman.GetMasternodeInfo(vote.vinMasternode.prevout, mnInfo)) {
-            // mn was not found, so we can't check vote, some info is probably missing
-            LogPrintf("MASTERNODEPAYMENTVOTE -- masternode is missing %s\n", vote.vinMasternode.prevout.ToStringShort());
-            mnodeman.AskForMN(pfrom, vote.vinMasternode.prevout, connman);
-            return;
-        }
+    std::string strError = "";
+    if(!vote.IsValid(pfrom, nCachedBlockHeight, strError, connman)) {
+        LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- invalid message, error: %s\n", strError);
+        return;
+    }
 
-        int nDos = 0;
-        if(!vote.CheckSignature(mnInfo.pubKeyMasternode, nCachedBlockHeight, nDos)) {
-            if(nDos) {
-                LOCK(cs_main);
-                LogPrintf("MASTERNODEPAYMENTVOTE -- ERROR: invalid signature\n");
-                Misbehaving(pfrom->GetId(), nDos);
-            } else {
-                // only warn about anything non-critical (i.e. nDos == 0) in debug mode
-                LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- WARNING: invalid signature\n");
-            }
-            // Either our info or vote info could be outdated.
-            // In case our info is outdated, ask for an update,
-            mnodeman.AskForMN(pfrom, vote.vinMasternode.prevout, connman);
-            // but there is nothing we can do if vote info itself is outdated
-            // (i.e. it was signed by a mn which changed its key),
-            // so just quit here.
-            return;
+    if(!CanVote(vote.vinMasternode.prevout, vote.nBlockHeight)) {
+        LogPrintf("MASTERNODEPAYMENTVOTE -- masternode already voted, masternode=%s\n", vote.vinMasternode.prevout.ToStringShort());
+        return;
+    }
+
+    masternode_info_t mnInfo;
+    if(!mnodeman.GetMasternodeInfo(vote.vinMasternode.prevout, mnInfo)) {
+        // mn was not found, so we can't check vote, some info is probably missing
+        LogPrintf("MASTERNODEPAYMENTVOTE -- masternode is missing %s\n", vote.vinMasternode.prevout.ToStringShort());
+        mnodeman.AskForMN(pfrom, vote.vinMasternode.prevout, connman);
+        return;
+    }
+
+    int nDos = 0;
+    if(!vote.CheckSignature(mnInfo.pubKeyMasternode, nCachedBlockHeight, nDos)) {
+        if(nDos) {
+            LOCK(cs_main);
+            LogPrintf("MASTERNODEPAYMENTVOTE -- ERROR: invalid signature\n");
+            Misbehaving(pfrom->GetId(), nDos);
+        } else {
+            // only warn about anything non-critical (i.e. nDos == 0) in debug mode
+            LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- WARNING: invalid signature\n");
         }
+        // Either our info or vote info could be outdated.
+        // In case our info is outdated, ask for an update,
+        mnodeman.AskForMN(pfrom, vote.vinMasternode.prevout, connman);
+        // but there is nothing we can do if vote info itself is outdated
+        // (i.e. it was signed by a mn which changed its key),
+        // so just quit here.
+        return;
+    }
 
-        CTxDestination address1;
-        ExtractDestination(vote.payee, address1);
-        std::string address2 = EncodeDestination(address1);
+    CTxDestination address1;
+    ExtractDestination(vote.payee, address1);
+    std::string address2 = EncodeDestination(address1);
 
-        LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- vote: address=%s, nBlockHeight=%d, nHeight=%d, prevout=%s, hash=%s new\n",
-                    address2, vote.nBlockHeight, nCachedBlockHeight, vote.vinMasternode.prevout.ToStringShort(), nHash.ToString());
+    LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- vote: address=%s, nBlockHeight=%d, nHeight=%d, prevout=%s, hash=%s new\n",
+                address2, vote.nBlockHeight, nCachedBlockHeight, vote.vinMasternode.prevout.ToStringShort(), nHash.ToString());
 
-        if(AddPaymentVote(vote)){
-            vote.Relay(connman);
-            masternodeSync.BumpAssetLastTime("MASTERNODEPAYMENTVOTE");
-        }
+    if(AddPaymentVote(vote)){
+        vote.Relay(connman);
+        masternodeSync.BumpAssetLastTime("MASTERNODEPAYMENTVOTE");
     }
 }
+// EXOSIS END
 
 bool CMasternodePaymentVote::Sign()
 {
@@ -285,6 +295,26 @@ bool CMasternodePayments::IsScheduled(CMasternode& mn, int nNotBlockHeight)
     return false;
 }
 
+// EXOSIS BEGIN
+std::set<CScript> CMasternodePayments::GetScheduledPayees(int nNotBlockHeight)
+{
+    LOCK(cs_mapMasternodeBlocks);
+
+    std::set<CScript> setPayees;
+    if(!masternodeSync.IsMasternodeListSynced()) return setPayees;
+
+    CScript payee;
+    for (int64_t h = nCachedBlockHeight; h <= nCachedBlockHeight + 8; h++){
+        if(h == nNotBlockHeight) continue;
+        if(mapMasternodeBlocks.count(h) && mapMasternodeBlocks[h].GetBestPayee(payee)) {
+            setPayees.insert(payee);
+        }
+    }
+
+    return setPayees;
+}
+// EXOSIS END
+
 bool CMasternodePayments::AddPaymentVote(const CMasternodePaymentVote& vote)
 {
     uint256 blockHash = uint256();
@@ -309,10 +339,36 @@ bool CMasternodePayments::AddPaymentVote(const CMasternodePaymentVote& vote)
 bool CMasternodePayments::HasVerifiedPaymentVote(uint256 hashIn)
 {
     LOCK(cs_mapMasternodePaymentVotes);
-    std::map<uint256, CMasternodePaymentVote>::iterator it = mapMasternodePaymentVotes.find(hashIn);
+    // EXOSIS BEGIN
+    //std::map<uint256, CMasternodePaymentVote>::iterator it = mapMasternodePaymentVotes.find(hashIn);
+    auto it = mapMasternodePaymentVotes.find(hashIn);
+    // EXOSIS END
     return it != mapMasternodePaymentVotes.end() && it->second.IsVerified();
 }
 
+// EXOSIS BEGIN
+bool CMasternodePayments::HasPaymentVote(const uint256& hashIn)
+{
+    LOCK(cs_mapMasternodePaymentVotes);
+    return mapMasternodePaymentVotes.count(hashIn);
+}
+
+bool CMasternodePayments::GetPaymentVote(const uint256& hashIn, CMasternodePaymentVote& voteRet)
+{
+    LOCK(cs_mapMasternodePaymentVotes);
+    auto it = mapMasternodePaymentVotes.find(hashIn);
+    if (it == mapMasternodePaymentVotes.end()) return false;
+    voteRet = it->second;
+    return true;
+}
+
+bool CMasternodePayments::HasPayeesForBlock(int nBlockHeight)
+{
+    LOCK(cs_mapMasternodeBlocks);
+    return mapMasternodeBlocks.count(nBlockHeight);
+}
+// EXOSIS END
+
 void CMasternodeBlockPayees::AddPayee(const CMasternodePaymentVote& vote)
 {
     LOCK(cs_vecPayees);
@@ -347,6 +403,13 @@ bool CMasternodeBlockPayees::GetBestPayee(CScript& payeeRet)
     return (nVotes > -1);
 }
 
+// EXOSIS BEGIN
+size_t CMasternodePayee::DynamicMemoryUsage() const
+{
+    return RecursiveDynamicUsage(scriptPubKey) + memusage::DynamicUsage(vecVoteHashes);
+}
+// EXOSIS END
+
 bool CMasternodeBlockPayees::HasPayeeWithVotes(const CScript& payeeIn, int nVotesReq)
 {
     LOCK(cs_vecPayees);
@@ -458,7 +521,10 @@ void CMasternodePayments::CheckAndRemove()
 
     int nLimit = GetStorageLimit();
 
-    std::map<uint256, CMasternodePaymentVote>::iterator it = mapMasternodePaymentVotes.begin();
+    // EXOSIS BEGIN
+    //std::map<uint256, CMasternodePaymentVote>::iterator it = mapMasternodePaymentVotes.begin();
+    auto it = mapMasternodePaymentVotes.begin();
+    // EXOSIS END
     while(it != mapMasternodePaymentVotes.end()) {
         CMasternodePaymentVote vote = (*it).second;
 
@@ -605,7 +671,10 @@ void CMasternodePayments::CheckPreviousBlockVotes(int nPrevBlockHeight)
     debugStr += strprintf("CMasternodePayments::CheckPreviousBlockVotes -- nPrevBlockHeight=%d, expected voting MNs:\n", nPrevBlockHeight);
 
     CMasternodeMan::rank_pair_vec_t mns;
-    if (!mnodeman.GetMasternodeRanks(mns, nPrevBlockHeight - 101, GetMinMasternodePaymentsProto())) {
+    // EXOSIS BEGIN
+    //if (!mnodeman.GetMasternodeRanks(mns, nPrevBlockHeight - 101, GetMinMasternodePaymentsProto())) {
+    if (!mnodeman.GetMasternodeRanks(mns, nPrevBlockHeight - 101, GetMinMasternodePaymentsProto(), MNPAYMENTS_SIGNATURES_TOTAL)) {
+    // EXOSIS END
         debugStr += "CMasternodePayments::CheckPreviousBlockVotes -- GetMasternodeRanks failed\n";
         LogPrint(BCLog::MNPAYMENTS, "%s\n", debugStr);
         return;
@@ -621,12 +690,19 @@ void CMasternodePayments::CheckPreviousBlockVotes(int nPrevBlockHeight)
         if (mapMasternodeBlocks.count(nPrevBlockHeight)) {
             for (auto &p : mapMasternodeBlocks[nPrevBlockHeight].vecPayees) {
                 for (auto &voteHash : p.GetVoteHashes()) {
-                    if (!mapMasternodePaymentVotes.count(voteHash)) {
+                    // EXOSIS BEGIN
+                    //if (!mapMasternodePaymentVotes.count(voteHash)) {
+                    auto itVote = mapMasternodePaymentVotes.find(voteHash);
+                    if (itVote == mapMasternodePaymentVotes.end()) {
+                    // EXOSIS END
                         debugStr += strprintf("CMasternodePayments::CheckPreviousBlockVotes --   could not find vote %s\n",
                                               voteHash.ToString());
                         continue;
                     }
-                    auto vote = mapMasternodePaymentVotes[voteHash];
+                    // EXOSIS BEGIN
+                    //auto vote = mapMasternodePaymentVotes[voteHash];
+                    const CMasternodePaymentVote& vote = itVote->second;
+                    // EXOSIS END
                     if (vote.vinMasternode.prevout == mn.second.vin.prevout) {
                         payee = vote.payee;
                         found = true;
@@ -816,11 +892,39 @@ std::string CMasternodePayments::ToString() const
     std::ostringstream info;
 
     info << "Votes: " << (int)mapMasternodePaymentVotes.size() <<
-            ", Blocks: " << (int)mapMasternodeBlocks.size();
+            // EXOSIS BEGIN
+            //", Blocks: " << (int)mapMasternodeBlocks.size();
+            ", Blocks: " << (int)mapMasternodeBlocks.size() <<
+            ", memory usage: " << DynamicMemoryUsage();
+            // EXOSIS END
 
     return info.str();
 }
 
+// EXOSIS BEGIN
+size_t CMasternodePayments::DynamicMemoryUsage() const
+{
+    LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
+
+    size_t nUsage = memusage::DynamicUsage(mapMasternodePaymentVotes) +
+                    memusage::DynamicUsage(mapMasternodeBlocks) +
+                    memusage::DynamicUsage(mapMasternodesLastVote) +
+                    memusage::DynamicUsage(mapMasternodesDidNotVote);
+    for (const auto& votePair : mapMasternodePaymentVotes) {
+        nUsage += RecursiveDynamicUsage(votePair.second.payee) + RecursiveDynamicUsage(votePair.second.vinMasternode) +
+                  memusage::DynamicUsage(votePair.second.vchSig);
+    }
+    LOCK(cs_vecPayees);
+    for (const auto& blockPair : mapMasternodeBlocks) {
+        nUsage += memusage::DynamicUsage(blockPair.second.vecPayees);
+        for (const CMasternodePayee& payee : blockPair.second.vecPayees) {
+            nUsage += payee.DynamicMemoryUsage();
+        }
+    }
+    return nUsage;
+}
+// EXOSIS END
+
 bool CMasternodePayments::IsEnoughData()
 {
     float nAverageVotes = (MNPAYMENTS_SIGNATURES_TOTAL + MNPAYMENTS_SIGNATURES_REQUIRED) / 2;
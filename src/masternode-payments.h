@@ -14,6 +14,12 @@
 #include <util/strencodings.h>
 #include <util/system.h>
 
+// EXOSIS BEGIN
+#include <util/hasher.h>
+
+#include <unordered_map>
+// EXOSIS END
+
 class CMasternodePayments;
 class CMasternodePaymentVote;
 class CMasternodeBlockPayees;
@@ -72,6 +78,9 @@ public:
     void AddVoteHash(uint256 hashIn) { vecVoteHashes.push_back(hashIn); }
     std::vector<uint256> GetVoteHashes() { return vecVoteHashes; }
     int GetVoteCount() { return vecVoteHashes.size(); }
+    // EXOSIS BEGIN
+    size_t DynamicMemoryUsage() const;
+    // EXOSIS END
 };
 
 // Keep track of votes for payees from masternodes
@@ -178,10 +187,15 @@ private:
     int nCachedBlockHeight;
 
 public:
-    std::map<uint256, CMasternodePaymentVote> mapMasternodePaymentVotes;
+    // EXOSIS BEGIN
+    //std::map<uint256, CMasternodePaymentVote> mapMasternodePaymentVotes;
+    std::unordered_map<uint256, CMasternodePaymentVote, SaltedTxidHasher> mapMasternodePaymentVotes;
     std::map<int, CMasternodeBlockPayees> mapMasternodeBlocks;
-    std::map<COutPoint, int> mapMasternodesLastVote;
-    std::map<COutPoint, int> mapMasternodesDidNotVote;
+    //std::map<COutPoint, int> mapMasternodesLastVote;
+    //std::map<COutPoint, int> mapMasternodesDidNotVote;
+    std::unordered_map<COutPoint, int, SaltedOutpointHasher> mapMasternodesLastVote;
+    std::unordered_map<COutPoint, int, SaltedOutpointHasher> mapMasternodesDidNotVote;
+    // EXOSIS END
 
     CMasternodePayments() : nStorageCoeff(1.25), nMinBlocksToStore(5000) {}
 
@@ -197,6 +211,11 @@ public:
 
     bool AddPaymentVote(const CMasternodePaymentVote& vote);
     bool HasVerifiedPaymentVote(uint256 hashIn);
+    // EXOSIS BEGIN
+    bool HasPaymentVote(const uint256& hashIn);
+    bool GetPaymentVote(const uint256& hashIn, CMasternodePaymentVote& voteRet);
+    bool HasPayeesForBlock(int nBlockHeight);
+    // EXOSIS END
     bool ProcessBlock(int nBlockHeight, CConnman& connman);
     void CheckPreviousBlockVotes(int nPrevBlockHeight);
 
@@ -207,14 +226,27 @@ public:
     bool GetBlockPayee(int nBlockHeight, CScript& payee);
     bool IsTransactionValid(const CTransactionRef txNew, int nBlockHeight);
     bool IsScheduled(CMasternode& mn, int nNotBlockHeight);
+    // EXOSIS BEGIN
+    /// Payees IsScheduled() would match, for checking many masternodes at once
+    std::set<CScript> GetScheduledPayees(int nNotBlockHeight);
+    // EXOSIS END
 
     bool CanVote(COutPoint outMasternode, int nBlockHeight);
 
     int GetMinMasternodePaymentsProto();
-    void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS BEGIN
+    //void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Handlers of the MASTERNODEPAYMENTSYNC and MASTERNODEPAYMENTVOTE messages
+    void ProcessPaymentSyncMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessPaymentVoteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS END
     std::string GetRequiredPaymentsString(int nBlockHeight);
     void FillBlockPayee(CMutableTransaction& txNew, int nBlockHeight, CAmount blockReward, CTxOut& txoutMasternodeRet);
     std::string ToString() const;
+    // EXOSIS BEGIN
+    /// Heap memory used by the vote and block maps, including payee scripts and signatures
+    size_t DynamicMemoryUsage() const;
+    // EXOSIS END
 
     int GetBlockCount() { return mapMasternodeBlocks.size(); }
     int GetVoteCount() { return mapMasternodePaymentVotes.size(); }
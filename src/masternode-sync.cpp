@@ -126,20 +126,20 @@ std::string CMasternodeSync::GetSyncStatus()
     }
 }
 
-void CMasternodeSync::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv)
+// EXOSIS BEGIN
+//void CMasternodeSync::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv)
+void CMasternodeSync::ProcessSyncStatusCountMessage(CNode* pfrom, CDataStream& vRecv)
 {
-    if (strCommand == NetMsgType::SYNCSTATUSCOUNT) { //Sync status count
-
-        //do not care about stats if sync process finished or failed
-        if(IsSynced() || IsFailed()) return;
+    //do not care about stats if sync process finished or failed
+    if(IsSynced() || IsFailed()) return;
 
-        int nItemID;
-        int nCount;
-        vRecv >> nItemID >> nCount;
+    int nItemID;
+    int nCount;
+    vRecv >> nItemID >> nCount;
 
-        LogPrintf("SYNCSTATUSCOUNT -- got inventory count: nItemID=%d  nCount=%d  peer=%d\n", nItemID, nCount, pfrom->GetId());
-    }
+    LogPrintf("SYNCSTATUSCOUNT -- got inventory count: nItemID=%d  nCount=%d  peer=%d\n", nItemID, nCount, pfrom->GetId());
 }
+// EXOSIS END
 
 void CMasternodeSync::ClearFulfilledRequests(CConnman& connman)
 {
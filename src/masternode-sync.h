@@ -12,6 +12,10 @@
 
 #include <univalue.h>
 
+// EXOSIS BEGIN
+#include <atomic>
+// EXOSIS END
+
 class CMasternodeSync;
 
 static const int MASTERNODE_SYNC_FAILED          = -1;
@@ -38,17 +42,32 @@ extern CMasternodeSync masternodeSync;
 class CMasternodeSync
 {
 private:
+    // EXOSIS BEGIN
+    // The sync state is read and bumped by the Dash message queue workers
+    // while the scheduler and validation threads advance it
+    //// Keep track of current asset
+    //int nRequestedMasternodeAssets;
+    //// Count peers we've requested the asset from
+    //int nRequestedMasternodeAttempt;
+    //
+    //// Time when current masternode asset sync started
+    //int64_t nTimeAssetSyncStarted;
+    //// ... last bumped
+    //int64_t nTimeLastBumped;
+    //// ... or failed
+    //int64_t nTimeLastFailure;
     // Keep track of current asset
-    int nRequestedMasternodeAssets;
+    std::atomic<int> nRequestedMasternodeAssets;
     // Count peers we've requested the asset from
-    int nRequestedMasternodeAttempt;
+    std::atomic<int> nRequestedMasternodeAttempt;
 
     // Time when current masternode asset sync started
-    int64_t nTimeAssetSyncStarted;
+    std::atomic<int64_t> nTimeAssetSyncStarted;
     // ... last bumped
-    int64_t nTimeLastBumped;
+    std::atomic<int64_t> nTimeLastBumped;
     // ... or failed
-    int64_t nTimeLastFailure;
+    std::atomic<int64_t> nTimeLastFailure;
+    // EXOSIS END
 
     void Fail();
     void ClearFulfilledRequests(CConnman& connman);
@@ -75,7 +94,10 @@ public:
     void Reset();
     void SwitchToNextAsset(CConnman& connman);
 
-    void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv);
+    // EXOSIS BEGIN
+    //void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv);
+    void ProcessSyncStatusCountMessage(CNode* pfrom, CDataStream& vRecv);
+    // EXOSIS END
     void ProcessTick(CConnman& connman);
 
     void AcceptedBlockHeader(const CBlockIndex *pindexNew);
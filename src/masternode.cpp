@@ -67,6 +67,12 @@ bool CMasternode::UpdateFromNewBroadcast(CMasternodeBroadcast& mnb, CConnman& co
     pubKeyMasternode = mnb.pubKeyMasternode;
     sigTime = mnb.sigTime;
     vchSig = mnb.vchSig;
+    // EXOSIS BEGIN
+    if(nProtocolVersion != mnb.nProtocolVersion) {
+        // ranks are filtered by protocol version
+        mnodeman.InvalidateRankCache();
+    }
+    // EXOSIS END
     nProtocolVersion = mnb.nProtocolVersion;
     addr = mnb.addr;
     nPoSeBanScore = 0;
@@ -100,9 +106,19 @@ bool CMasternode::UpdateFromNewBroadcast(CMasternodeBroadcast& mnb, CConnman& co
 //
 arith_uint256 CMasternode::CalculateScore(const uint256& blockHash)
 {
+    // EXOSIS BEGIN
+    return CalculateScore(vin.prevout, nCollateralMinConfBlockHash, blockHash);
+}
+
+arith_uint256 CMasternode::CalculateScore(const COutPoint& outpoint, const uint256& collateralMinConfBlockHash, const uint256& blockHash)
+{
+    // EXOSIS END
     // Deterministically calculate a "score" for a Masternode based on any given (block)hash
     CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
-    ss << vin.prevout << nCollateralMinConfBlockHash << blockHash;
+    // EXOSIS BEGIN
+    //ss << vin.prevout << nCollateralMinConfBlockHash << blockHash;
+    ss << outpoint << collateralMinConfBlockHash << blockHash;
+    // EXOSIS END
     return UintToArith256(ss.GetHash());
 }
 
@@ -404,6 +420,15 @@ std::string CMasternode::GetStatus() const
     return GetStateString();
 }
 
+// EXOSIS BEGIN
+size_t CMasternode::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+    return RecursiveDynamicUsage(vin) + lastPing.DynamicMemoryUsage() + memusage::DynamicUsage(vchSig) +
+           memusage::DynamicUsage(mapGovernanceObjectsVotedOn);
+}
+// EXOSIS END
+
 void CMasternode::UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScanBack)
 {
     if(!pindex) return;
@@ -7,6 +7,9 @@
 #ifndef DASH_MASTERNODE_H
 #define DASH_MASTERNODE_H
 
+// EXOSIS BEGIN
+#include <core_memusage.h>
+// EXOSIS END
 #include <key.h>
 #include <validation.h>
 #include <spork.h>
@@ -91,6 +94,9 @@ public:
     bool SimpleCheck(int& nDos);
     bool CheckAndUpdate(CMasternode* pmn, bool fFromNewBroadcast, int& nDos, CConnman& connman);
     void Relay(CConnman& connman);
+    // EXOSIS BEGIN
+    size_t DynamicMemoryUsage() const { return RecursiveDynamicUsage(vin) + memusage::DynamicUsage(vchSig); }
+    // EXOSIS END
 };
 
 inline bool operator==(const CMasternodePing& a, const CMasternodePing& b)
@@ -220,6 +226,9 @@ public:
 
     // CALCULATE A RANK AGAINST OF GIVEN BLOCK
     arith_uint256 CalculateScore(const uint256& blockHash);
+    // EXOSIS BEGIN
+    static arith_uint256 CalculateScore(const COutPoint& outpoint, const uint256& collateralMinConfBlockHash, const uint256& blockHash);
+    // EXOSIS END
 
     bool UpdateFromNewBroadcast(CMasternodeBroadcast& mnb, CConnman& connman);
 
@@ -246,7 +255,10 @@ public:
         return nTimeToCheckAt - lastPing.sigTime < nSeconds;
     }
 
-    bool IsEnabled() { return nActiveState == MASTERNODE_ENABLED; }
+    // EXOSIS BEGIN
+    //bool IsEnabled() { return nActiveState == MASTERNODE_ENABLED; }
+    bool IsEnabled() const { return nActiveState == MASTERNODE_ENABLED; }
+    // EXOSIS END
     bool IsPreEnabled() { return nActiveState == MASTERNODE_PRE_ENABLED; }
     bool IsPoSeBanned() { return nActiveState == MASTERNODE_POSE_BAN; }
     // NOTE: this one relies on nPoSeBanScore, not on nActiveState as everything else here
@@ -294,8 +306,12 @@ public:
     std::string GetStateString() const;
     std::string GetStatus() const;
 
-    int GetLastPaidTime() { return nTimeLastPaid; }
-    int GetLastPaidBlock() { return nBlockLastPaid; }
+    // EXOSIS BEGIN
+    //int GetLastPaidTime() { return nTimeLastPaid; }
+    //int GetLastPaidBlock() { return nBlockLastPaid; }
+    int GetLastPaidTime() const { return nTimeLastPaid; }
+    int GetLastPaidBlock() const { return nBlockLastPaid; }
+    // EXOSIS END
     void UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScanBack);
 
     // KEEP TRACK OF EACH GOVERNANCE ITEM INCASE THIS NODE GOES OFFLINE, SO WE CAN RECALC THEIR STATUS
@@ -307,6 +323,11 @@ public:
 
     void UpdateWatchdogVoteTime(uint64_t nVoteTime = 0);
 
+    // EXOSIS BEGIN
+    /// Heap memory used by the entry, including its scripts and signatures
+    size_t DynamicMemoryUsage() const;
+    // EXOSIS END
+
     CMasternode& operator=(CMasternode const& from)
     {
         static_cast<masternode_info_t&>(*this)=from;
@@ -432,6 +453,12 @@ public:
         CInv inv(MSG_MASTERNODE_VERIFY, GetHash());
         g_connman->RelayInv(inv);
     }
+    // EXOSIS BEGIN
+    size_t DynamicMemoryUsage() const
+    {
+        return RecursiveDynamicUsage(vin1) + RecursiveDynamicUsage(vin2) + memusage::DynamicUsage(vchSig1) + memusage::DynamicUsage(vchSig2);
+    }
+    // EXOSIS END
 };
 
 #endif // DASH_MASTERNODE_H
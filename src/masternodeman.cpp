@@ -10,6 +10,9 @@
 #include <masternode-payments.h>
 #include <masternode-sync.h>
 #include <masternodeman.h>
+// EXOSIS BEGIN
+#include <memusage.h>
+// EXOSIS END
 #include <messagesigner.h>
 #include <netfulfilledman.h>
 #include <netmessagemaker.h>
@@ -19,6 +22,11 @@
 #include <script/standard.h>
 #include <util/system.h>
 
+// EXOSIS BEGIN
+#include <algorithm>
+#include <limits>
+// EXOSIS END
+
 // EXOSIS BEGIN
 extern void Misbehaving(NodeId nodeid, int howmuch, const std::string& message="");
 // EXOSIS END
@@ -28,24 +36,6 @@ CMasternodeMan mnodeman;
 
 const std::string CMasternodeMan::SERIALIZATION_VERSION_STRING = "CMasternodeMan-Version-7";
 
-struct CompareLastPaidBlock
-{
-    bool operator()(const std::pair<int, CMasternode*>& t1,
-                    const std::pair<int, CMasternode*>& t2) const
-    {
-        return (t1.first != t2.first) ? (t1.first < t2.first) : (t1.second->vin < t2.second->vin);
-    }
-};
-
-struct CompareScoreMN
-{
-    bool operator()(const std::pair<arith_uint256, CMasternode*>& t1,
-                    const std::pair<arith_uint256, CMasternode*>& t2) const
-    {
-        return (t1.first != t2.first) ? (t1.first < t2.first) : (t1.second->vin < t2.second->vin);
-    }
-};
-
 struct CompareByAddr
 
 {
@@ -59,6 +49,11 @@ struct CompareByAddr
 CMasternodeMan::CMasternodeMan()
 : cs(),
   mapMasternodes(),
+  // EXOSIS BEGIN
+  mapRankCache(RANK_CACHE_SIZE),
+  nRankCacheGeneration(0),
+  fSnapshotDirtyAll(true),
+  // EXOSIS END
   mAskedUsForMasternodeList(),
   mWeAskedForMasternodeList(),
   mWeAskedForMasternodeListEntry(),
@@ -83,6 +78,12 @@ bool CMasternodeMan::Add(CMasternode &mn)
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Add -- Adding new Masternode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
     mapMasternodes[mn.vin.prevout] = mn;
+    // EXOSIS BEGIN
+    AddToPayeeIndex(mn);
+    AddToPaymentQueue(mn);
+    InvalidateRankCache();
+    InvalidateSnapshot(mn.vin.prevout);
+    // EXOSIS END
     fMasternodesAdded = true;
     return true;
 }
@@ -96,11 +97,109 @@ bool CMasternodeMan::Remove(COutPoint out)
     if (mnit != mapMasternodes.end())
     {
         LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Remove -- Removing Masternode: addr=%s\n", mnit->second.addr.ToString());
+        RemoveFromPayeeIndex(mnit->second);
+        RemoveFromPaymentQueue(mnit->second);
         mapMasternodes.erase(mnit);
+        InvalidateRankCache();
+        InvalidateSnapshot(out);
     }
     fMasternodesRemoved = true;
     return true;
 }
+
+void CMasternodeMan::AddToPayeeIndex(const CMasternode& mn)
+{
+    AssertLockHeld(cs);
+    mapPayeeIndex[GetScriptForDestination(mn.pubKeyCollateralAddress.GetID())].insert(mn.vin.prevout);
+}
+
+void CMasternodeMan::RemoveFromPayeeIndex(const CMasternode& mn)
+{
+    AssertLockHeld(cs);
+    auto it = mapPayeeIndex.find(GetScriptForDestination(mn.pubKeyCollateralAddress.GetID()));
+    if (it == mapPayeeIndex.end()) return;
+    it->second.erase(mn.vin.prevout);
+    if (it->second.empty()) {
+        mapPayeeIndex.erase(it);
+    }
+}
+
+void CMasternodeMan::RebuildPayeeIndex()
+{
+    AssertLockHeld(cs);
+    mapPayeeIndex.clear();
+    for (const auto& mnpair : mapMasternodes) {
+        AddToPayeeIndex(mnpair.second);
+    }
+}
+
+void CMasternodeMan::AddToPaymentQueue(CMasternode& mn)
+{
+    AssertLockHeld(cs);
+    setPaymentQueue.emplace(mn.GetLastPaidBlock(), mn.vin.prevout);
+}
+
+void CMasternodeMan::RemoveFromPaymentQueue(CMasternode& mn)
+{
+    AssertLockHeld(cs);
+    setPaymentQueue.erase(std::make_pair(mn.GetLastPaidBlock(), mn.vin.prevout));
+}
+
+void CMasternodeMan::RebuildPaymentQueue()
+{
+    AssertLockHeld(cs);
+    setPaymentQueue.clear();
+    for (auto& mnpair : mapMasternodes) {
+        AddToPaymentQueue(mnpair.second);
+    }
+}
+
+void CMasternodeMan::InvalidateSnapshot()
+{
+    AssertLockHeld(cs);
+    // readers holding the old snapshot keep it, the next one copies every MN
+    fSnapshotDirtyAll = true;
+    setSnapshotDirty.clear();
+}
+
+void CMasternodeMan::InvalidateSnapshot(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs);
+    if (!fSnapshotDirtyAll) {
+        setSnapshotDirty.insert(outpoint);
+    }
+}
+
+CMasternodeMan::mn_map_snapshot_t CMasternodeMan::GetMasternodeMapSnapshot()
+{
+    LOCK(cs);
+    if (!fSnapshotDirtyAll && setSnapshotDirty.empty()) {
+        return mapMasternodesSnapshot;
+    }
+
+    std::shared_ptr<std::map<COutPoint, std::shared_ptr<const CMasternode> > > pmapSnapshot;
+    if (fSnapshotDirtyAll) {
+        pmapSnapshot = std::make_shared<std::map<COutPoint, std::shared_ptr<const CMasternode> > >();
+        for (const auto& mnpair : mapMasternodes) {
+            pmapSnapshot->emplace_hint(pmapSnapshot->end(), mnpair.first, std::make_shared<const CMasternode>(mnpair.second));
+        }
+    } else {
+        // share the unchanged MNs with the previous snapshot, only copy the changed ones
+        pmapSnapshot = std::make_shared<std::map<COutPoint, std::shared_ptr<const CMasternode> > >(*mapMasternodesSnapshot);
+        for (const COutPoint& outpoint : setSnapshotDirty) {
+            auto it = mapMasternodes.find(outpoint);
+            if (it == mapMasternodes.end()) {
+                pmapSnapshot->erase(outpoint);
+            } else {
+                (*pmapSnapshot)[outpoint] = std::make_shared<const CMasternode>(it->second);
+            }
+        }
+    }
+    fSnapshotDirtyAll = false;
+    setSnapshotDirty.clear();
+    mapMasternodesSnapshot = pmapSnapshot;
+    return mapMasternodesSnapshot;
+}
 // EXOSIS END
 
 void CMasternodeMan::AskForMN(CNode* pnode, const COutPoint& outpoint, CConnman& connman)
@@ -109,7 +208,10 @@ void CMasternodeMan::AskForMN(CNode* pnode, const COutPoint& outpoint, CConnman&
 
     LOCK(cs);
 
-    std::map<COutPoint, std::map<CNetAddr, int64_t> >::iterator it1 = mWeAskedForMasternodeListEntry.find(outpoint);
+    // EXOSIS BEGIN
+    //std::map<COutPoint, std::map<CNetAddr, int64_t> >::iterator it1 = mWeAskedForMasternodeListEntry.find(outpoint);
+    auto it1 = mWeAskedForMasternodeListEntry.find(outpoint);
+    // EXOSIS END
     if (it1 != mWeAskedForMasternodeListEntry.end()) {
         std::map<CNetAddr, int64_t>::iterator it2 = it1->second.find(pnode->addr);
         if (it2 != it1->second.end()) {
@@ -142,6 +244,9 @@ bool CMasternodeMan::AllowMixing(const COutPoint &outpoint)
     nDsqCount++;
     pmn->nLastDsq = nDsqCount;
     pmn->fAllowMixingTx = true;
+    // EXOSIS BEGIN
+    InvalidateSnapshot(outpoint);
+    // EXOSIS END
 
     return true;
 }
@@ -154,6 +259,9 @@ bool CMasternodeMan::DisallowMixing(const COutPoint &outpoint)
         return false;
     }
     pmn->fAllowMixingTx = false;
+    // EXOSIS BEGIN
+    InvalidateSnapshot(outpoint);
+    // EXOSIS END
 
     return true;
 }
@@ -166,10 +274,28 @@ bool CMasternodeMan::PoSeBan(const COutPoint &outpoint)
         return false;
     }
     pmn->PoSeBan();
+    // EXOSIS BEGIN
+    InvalidateSnapshot(outpoint);
+    // EXOSIS END
 
     return true;
 }
 
+// EXOSIS BEGIN
+void CMasternodeMan::CheckMasternodeState(CMasternode& mn, bool fForce)
+{
+    AssertLockHeld(cs);
+    // Check() runs for every MN on every block, only the MNs it changes need a new snapshot entry
+    const int nActiveStateOld = mn.nActiveState;
+    const int nPoSeBanScoreOld = mn.nPoSeBanScore;
+    const int nPoSeBanHeightOld = mn.nPoSeBanHeight;
+    mn.Check(fForce);
+    if (mn.nActiveState != nActiveStateOld || mn.nPoSeBanScore != nPoSeBanScoreOld || mn.nPoSeBanHeight != nPoSeBanHeightOld) {
+        InvalidateSnapshot(mn.vin.prevout);
+    }
+}
+// EXOSIS END
+
 void CMasternodeMan::Check()
 {
     // EXOSIS BEGIN
@@ -180,7 +306,10 @@ void CMasternodeMan::Check()
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Check -- nLastWatchdogVoteTime=%d, IsWatchdogActive()=%d\n", nLastWatchdogVoteTime, IsWatchdogActive());
 
     for (auto& mnpair : mapMasternodes) {
-        mnpair.second.Check();
+        // EXOSIS BEGIN
+        //mnpair.second.Check();
+        CheckMasternodeState(mnpair.second, false);
+        // EXOSIS END
     }
 }
 
@@ -215,6 +344,12 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
 
                 // and finally remove it from the list
                 it->second.FlagGovernanceItemsAsDirty();
+                // EXOSIS BEGIN
+                RemoveFromPayeeIndex(it->second);
+                RemoveFromPaymentQueue(it->second);
+                InvalidateRankCache();
+                InvalidateSnapshot(it->first);
+                // EXOSIS END
                 mapMasternodes.erase(it++);
                 fMasternodesRemoved = true;
             } else {
@@ -254,7 +389,10 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
 
         // proces replies for MASTERNODE_NEW_START_REQUIRED masternodes
         LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemove -- mMnbRecoveryGoodReplies size=%d\n", (int)mMnbRecoveryGoodReplies.size());
-        std::map<uint256, std::vector<CMasternodeBroadcast> >::iterator itMnbReplies = mMnbRecoveryGoodReplies.begin();
+        // EXOSIS BEGIN
+        //std::map<uint256, std::vector<CMasternodeBroadcast> >::iterator itMnbReplies = mMnbRecoveryGoodReplies.begin();
+        auto itMnbReplies = mMnbRecoveryGoodReplies.begin();
+        // EXOSIS END
         while(itMnbReplies != mMnbRecoveryGoodReplies.end()){
             if(mMnbRecoveryRequests[itMnbReplies->first].first < GetTime()) {
                 // all nodes we asked should have replied now
@@ -277,7 +415,10 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
         // no need for cm_main below
         LOCK(cs);
 
-        std::map<uint256, std::pair< int64_t, std::set<CNetAddr> > >::iterator itMnbRequest = mMnbRecoveryRequests.begin();
+        // EXOSIS BEGIN
+        //std::map<uint256, std::pair< int64_t, std::set<CNetAddr> > >::iterator itMnbRequest = mMnbRecoveryRequests.begin();
+        auto itMnbRequest = mMnbRecoveryRequests.begin();
+        // EXOSIS END
         while(itMnbRequest != mMnbRecoveryRequests.end()){
             // Allow this mnb to be re-verified again after MNB_RECOVERY_RETRY_SECONDS seconds
             // if mn is still in MASTERNODE_NEW_START_REQUIRED state.
@@ -309,7 +450,10 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
         }
 
         // check which Masternodes we've asked for
-        std::map<COutPoint, std::map<CNetAddr, int64_t> >::iterator it2 = mWeAskedForMasternodeListEntry.begin();
+        // EXOSIS BEGIN
+        //std::map<COutPoint, std::map<CNetAddr, int64_t> >::iterator it2 = mWeAskedForMasternodeListEntry.begin();
+        auto it2 = mWeAskedForMasternodeListEntry.begin();
+        // EXOSIS END
         while(it2 != mWeAskedForMasternodeListEntry.end()){
             std::map<CNetAddr, int64_t>::iterator it3 = it2->second.begin();
             while(it3 != it2->second.end()){
@@ -338,7 +482,10 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
         // NOTE: do not expire mapSeenMasternodeBroadcast entries here, clean them on mnb updates!
 
         // remove expired mapSeenMasternodePing
-        std::map<uint256, CMasternodePing>::iterator it4 = mapSeenMasternodePing.begin();
+        // EXOSIS BEGIN
+        //std::map<uint256, CMasternodePing>::iterator it4 = mapSeenMasternodePing.begin();
+        auto it4 = mapSeenMasternodePing.begin();
+        // EXOSIS END
         while(it4 != mapSeenMasternodePing.end()){
             if((*it4).second.IsExpired()) {
                 LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemove -- Removing expired Masternode ping: hash=%s\n", (*it4).second.GetHash().ToString());
@@ -349,7 +496,10 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
         }
 
         // remove expired mapSeenMasternodeVerification
-        std::map<uint256, CMasternodeVerification>::iterator itv2 = mapSeenMasternodeVerification.begin();
+        // EXOSIS BEGIN
+        //std::map<uint256, CMasternodeVerification>::iterator itv2 = mapSeenMasternodeVerification.begin();
+        auto itv2 = mapSeenMasternodeVerification.begin();
+        // EXOSIS END
         while(itv2 != mapSeenMasternodeVerification.end()){
             if((*itv2).second.nBlockHeight < nCachedBlockHeight - MAX_POSE_BLOCKS){
                 LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemove -- Removing expired Masternode verification: hash=%s\n", (*itv2).first.ToString());
@@ -371,6 +521,12 @@ void CMasternodeMan::Clear()
 {
     LOCK(cs);
     mapMasternodes.clear();
+    // EXOSIS BEGIN
+    mapPayeeIndex.clear();
+    setPaymentQueue.clear();
+    InvalidateRankCache();
+    InvalidateSnapshot();
+    // EXOSIS END
     mAskedUsForMasternodeList.clear();
     mWeAskedForMasternodeList.clear();
     mWeAskedForMasternodeListEntry.clear();
@@ -491,6 +647,8 @@ bool CMasternodeMan::GetMasternodeInfo(const CPubKey& pubKeyMasternode, masterno
 
 bool CMasternodeMan::GetMasternodeInfo(const CScript& payee, masternode_info_t& mnInfoRet)
 {
+    // EXOSIS BEGIN
+    /*
     LOCK(cs);
     for (auto& mnpair : mapMasternodes) {
         CScript scriptCollateralAddress = GetScriptForDestination(mnpair.second.pubKeyCollateralAddress.GetID());
@@ -500,7 +658,25 @@ bool CMasternodeMan::GetMasternodeInfo(const CScript& payee, masternode_info_t&
         }
     }
     return false;
+    */
+    return GetMasternodeInfo(payee, std::set<COutPoint>(), mnInfoRet);
+    // EXOSIS END
+}
+
+// EXOSIS BEGIN
+bool CMasternodeMan::GetMasternodeInfo(const CScript& payee, const std::set<COutPoint>& setExclude, masternode_info_t& mnInfoRet)
+{
+    LOCK(cs);
+    auto it = mapPayeeIndex.find(payee);
+    if (it == mapPayeeIndex.end()) return false;
+    for (const COutPoint& outpoint : it->second) {
+        if (setExclude.count(outpoint)) continue;
+        mnInfoRet = mapMasternodes.at(outpoint).GetInfo();
+        return true;
+    }
+    return false;
 }
+// EXOSIS END
 
 bool CMasternodeMan::Has(const COutPoint& outpoint)
 {
@@ -508,6 +684,53 @@ bool CMasternodeMan::Has(const COutPoint& outpoint)
     return mapMasternodes.find(outpoint) != mapMasternodes.end();
 }
 
+// EXOSIS BEGIN
+bool CMasternodeMan::HasSeenMasternodeBroadcast(const uint256& hash)
+{
+    LOCK(cs);
+    return mapSeenMasternodeBroadcast.count(hash);
+}
+
+bool CMasternodeMan::GetSeenMasternodeBroadcast(const uint256& hash, CMasternodeBroadcast& mnbRet)
+{
+    LOCK(cs);
+    auto it = mapSeenMasternodeBroadcast.find(hash);
+    if (it == mapSeenMasternodeBroadcast.end()) return false;
+    mnbRet = it->second.second;
+    return true;
+}
+
+bool CMasternodeMan::HasSeenMasternodePing(const uint256& hash)
+{
+    LOCK(cs);
+    return mapSeenMasternodePing.count(hash);
+}
+
+bool CMasternodeMan::GetSeenMasternodePing(const uint256& hash, CMasternodePing& mnpRet)
+{
+    LOCK(cs);
+    auto it = mapSeenMasternodePing.find(hash);
+    if (it == mapSeenMasternodePing.end()) return false;
+    mnpRet = it->second;
+    return true;
+}
+
+bool CMasternodeMan::HasSeenMasternodeVerification(const uint256& hash)
+{
+    LOCK(cs);
+    return mapSeenMasternodeVerification.count(hash);
+}
+
+bool CMasternodeMan::GetSeenMasternodeVerification(const uint256& hash, CMasternodeVerification& mnvRet)
+{
+    LOCK(cs);
+    auto it = mapSeenMasternodeVerification.find(hash);
+    if (it == mapSeenMasternodeVerification.end()) return false;
+    mnvRet = it->second;
+    return true;
+}
+// EXOSIS END
+
 //
 // Deterministically select the oldest/best masternode to pay on the network
 //
@@ -516,6 +739,30 @@ bool CMasternodeMan::GetNextMasternodeInQueueForPayment(bool fFilterSigTime, int
     return GetNextMasternodeInQueueForPayment(nCachedBlockHeight, fFilterSigTime, nCountRet, mnInfoRet);
 }
 
+// EXOSIS BEGIN
+bool CMasternodeMan::IsQualifiedForPayment(CMasternode& mn, int nMnCount, bool fFilterSigTime, const std::set<CScript>& setScheduledPayees)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs);
+
+    if(!mn.IsValidForPayment()) return false;
+
+    //check protocol version
+    if(mn.nProtocolVersion < mnpayments.GetMinMasternodePaymentsProto()) return false;
+
+    //it's in the list (up to 8 entries ahead of current block to allow propagation) -- so let's skip it
+    if(setScheduledPayees.count(GetScriptForDestination(mn.pubKeyCollateralAddress.GetID()))) return false;
+
+    //it's too new, wait for a cycle
+    if(fFilterSigTime && mn.sigTime + (nMnCount*2.6*60) > GetAdjustedTime()) return false;
+
+    //make sure it has at least as many confirmations as there are masternodes
+    if(GetUTXOConfirmations(mn.vin.prevout) < nMnCount) return false;
+
+    return true;
+}
+// EXOSIS END
+
 bool CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight, bool fFilterSigTime, int& nCountRet, masternode_info_t& mnInfoRet)
 {
     mnInfoRet = masternode_info_t();
@@ -529,69 +776,84 @@ bool CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight, bool f
     // Need LOCK2 here to ensure consistent locking order because the GetBlockHash call below locks cs_main
     LOCK2(cs_main,cs);
 
-    std::vector<std::pair<int, CMasternode*> > vecMasternodeLastPaid;
-
-    /*
-        Make a vector with all of the last paid times
-    */
-
+    // EXOSIS BEGIN
     int nMnCount = CountMasternodes();
+    const std::set<CScript> setScheduledPayees = mnpayments.GetScheduledPayees(nBlockHeight);
 
-    for (auto& mnpair : mapMasternodes) {
-        if(!mnpair.second.IsValidForPayment()) continue;
-
-        //check protocol version
-        if(mnpair.second.nProtocolVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
-
-        //it's in the list (up to 8 entries ahead of current block to allow propagation) -- so let's skip it
-        if(mnpayments.IsScheduled(mnpair.second, nBlockHeight)) continue;
-
-        //it's too new, wait for a cycle
-        if(fFilterSigTime && mnpair.second.sigTime + (nMnCount*2.6*60) > GetAdjustedTime()) continue;
-
-        //make sure it has at least as many confirmations as there are masternodes
-        if(GetUTXOConfirmations(mnpair.first) < nMnCount) continue;
-
-        vecMasternodeLastPaid.push_back(std::make_pair(mnpair.second.GetLastPaidBlock(), &mnpair.second));
+    // Look at 1/10 of the oldest nodes (by last payment), at least one
+    int nTenthNetwork = nMnCount/10;
+    const int nCandidatesMax = std::max(nTenthNetwork, 1);
+    // The queue is already ordered by last payment, so stop as soon as the candidates
+    // are known and enough masternodes qualify to not need the fallback below
+    const int nCountEnough = fFilterSigTime ? std::max(nCandidatesMax, nMnCount/3) : nCandidatesMax;
+
+    std::vector<CMasternode*> vecCandidates;
+    for (const auto& queueItem : setPaymentQueue) {
+        CMasternode& mn = mapMasternodes.at(queueItem.second);
+        if(!IsQualifiedForPayment(mn, nMnCount, fFilterSigTime, setScheduledPayees)) continue;
+
+        if((int)vecCandidates.size() < nCandidatesMax) {
+            vecCandidates.push_back(&mn);
+        }
+        if(++nCountRet >= nCountEnough) break;
     }
-
-    nCountRet = (int)vecMasternodeLastPaid.size();
+    // EXOSIS END
 
     //when the network is in the process of upgrading, don't penalize nodes that recently restarted
     if(fFilterSigTime && nCountRet < nMnCount/3)
         return GetNextMasternodeInQueueForPayment(nBlockHeight, false, nCountRet, mnInfoRet);
 
-    // Sort them low to high
-    sort(vecMasternodeLastPaid.begin(), vecMasternodeLastPaid.end(), CompareLastPaidBlock());
-
     uint256 blockHash;
     if(!GetBlockHash(blockHash, nBlockHeight - 101)) {
         LogPrintf("CMasternode::GetNextMasternodeInQueueForPayment -- ERROR: GetBlockHash() failed at nBlockHeight %d\n", nBlockHeight - 101);
         return false;
     }
-    // Look at 1/10 of the oldest nodes (by last payment), calculate their scores and pay the best one
+    // Calculate the scores of the candidates and pay the best one
     //  -- This doesn't look at who is being paid in the +8-10 blocks, allowing for double payments very rarely
     //  -- 1/100 payments should be a double payment on mainnet - (1/(3000/10))*2
     //  -- (chance per block * chances before IsScheduled will fire)
-    int nTenthNetwork = nMnCount/10;
-    int nCountTenth = 0;
     arith_uint256 nHighest = 0;
     CMasternode *pBestMasternode = NULL;
-    for (std::pair<int, CMasternode*>& s : vecMasternodeLastPaid){
-        arith_uint256 nScore = s.second->CalculateScore(blockHash);
+    // EXOSIS BEGIN
+    for (CMasternode* pmn : vecCandidates) {
+        arith_uint256 nScore = pmn->CalculateScore(blockHash);
         if(nScore > nHighest){
             nHighest = nScore;
-            pBestMasternode = s.second;
+            pBestMasternode = pmn;
         }
-        nCountTenth++;
-        if(nCountTenth >= nTenthNetwork) break;
     }
+    // EXOSIS END
     if (pBestMasternode) {
         mnInfoRet = pBestMasternode->GetInfo();
     }
     return mnInfoRet.fInfoValid;
 }
 
+// EXOSIS BEGIN
+int CMasternodeMan::CountQualifiedForPayment()
+{
+    if (!masternodeSync.IsWinnersListSynced()) return 0;
+
+    LOCK2(cs_main, cs);
+
+    int nMnCount = CountMasternodes();
+    const std::set<CScript> setScheduledPayees = mnpayments.GetScheduledPayees(nCachedBlockHeight);
+
+    int nCount = 0;
+    for (auto& mnpair : mapMasternodes) {
+        if(IsQualifiedForPayment(mnpair.second, nMnCount, true, setScheduledPayees)) nCount++;
+    }
+    if(nCount >= nMnCount/3) return nCount;
+
+    // same fallback as in GetNextMasternodeInQueueForPayment()
+    nCount = 0;
+    for (auto& mnpair : mapMasternodes) {
+        if(IsQualifiedForPayment(mnpair.second, nMnCount, false, setScheduledPayees)) nCount++;
+    }
+    return nCount;
+}
+// EXOSIS END
+
 masternode_info_t CMasternodeMan::FindRandomNotInVec(const std::vector<COutPoint> &vecToExclude, int nProtocolVersion)
 {
     LOCK(cs);
@@ -635,29 +897,100 @@ masternode_info_t CMasternodeMan::FindRandomNotInVec(const std::vector<COutPoint
     return masternode_info_t();
 }
 
-bool CMasternodeMan::GetMasternodeScores(const uint256& nBlockHash, CMasternodeMan::score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol)
+// EXOSIS BEGIN
+void CMasternodeScores::Sort(size_t nCount)
 {
-    vecMasternodeScoresRet.clear();
+    nCount = std::min(nCount, vecScores.size());
+    if (nCount <= nSorted)
+        return;
 
-    if (!masternodeSync.IsMasternodeListSynced())
+    // highest score first, ties are broken by the higher outpoint
+    std::partial_sort(vecScores.begin() + nSorted, vecScores.begin() + nCount, vecScores.end(), std::greater<std::pair<arith_uint256, COutPoint> >());
+    nSorted = nCount;
+}
+
+bool CMasternodeScores::GetRank(const COutPoint& outpoint, int& nRankRet) const
+{
+    for (size_t i = 0; i < nSorted; i++) {
+        if (vecScores[i].second == outpoint) {
+            nRankRet = i + 1;
+            return true;
+        }
+    }
+
+    // not in the sorted part, count the unsorted entries ranked above it
+    auto itUnsorted = vecScores.begin() + nSorted;
+    auto it = std::find_if(itUnsorted, vecScores.end(), [&outpoint](const std::pair<arith_uint256, COutPoint>& scorePair) {
+        return scorePair.second == outpoint;
+    });
+    if (it == vecScores.end())
         return false;
 
-    AssertLockHeld(cs);
+    nRankRet = nSorted + 1 + std::count_if(itUnsorted, vecScores.end(), [&it](const std::pair<arith_uint256, COutPoint>& scorePair) {
+        return scorePair > *it;
+    });
+    return true;
+}
 
-    if (mapMasternodes.empty())
+bool CMasternodeMan::GetMasternodeScores(const uint256& nBlockHash, int nMinProtocol, size_t nSortedMin, CMasternodeMan::rank_cache_value_t& scoresRet)
+{
+    if (!masternodeSync.IsMasternodeListSynced())
         return false;
 
-    // calculate scores
-    for (auto& mnpair : mapMasternodes) {
-        if (mnpair.second.nProtocolVersion >= nMinProtocol) {
-            vecMasternodeScoresRet.push_back(std::make_pair(mnpair.second.CalculateScore(nBlockHash), &mnpair.second));
+    // Scores do not depend on masternode state, so they only change when
+    // masternodes are added or removed or their protocol version changes
+    const rank_cache_key_t key(nBlockHash, nMinProtocol);
+    std::shared_ptr<CMasternodeScores> scores;
+    std::vector<std::pair<COutPoint, uint256> > vecSnapshot;
+    uint64_t nGeneration;
+    {
+        LOCK(cs);
+        if (mapRankCache.GetAndRefresh(key, scoresRet)) {
+            if (scoresRet->nSorted >= std::min(nSortedMin, scoresRet->vecScores.size()))
+                return true;
+            // reuse the scores, only more of them need to be sorted
+            scores = std::make_shared<CMasternodeScores>(*scoresRet);
+        } else {
+            for (const auto& mnpair : mapMasternodes) {
+                if (mnpair.second.nProtocolVersion >= nMinProtocol) {
+                    vecSnapshot.emplace_back(mnpair.first, mnpair.second.nCollateralMinConfBlockHash);
+                }
+            }
+            if (vecSnapshot.empty())
+                return false;
         }
+        nGeneration = nRankCacheGeneration;
     }
 
-    sort(vecMasternodeScoresRet.rbegin(), vecMasternodeScoresRet.rend(), CompareScoreMN());
-    return !vecMasternodeScoresRet.empty();
+    if (!scores) {
+        // calculate scores, one hash per masternode is too little work to be worth threads
+        scores = std::make_shared<CMasternodeScores>();
+        scores->vecScores.reserve(vecSnapshot.size());
+        for (const auto& snapshotPair : vecSnapshot) {
+            scores->vecScores.emplace_back(CMasternode::CalculateScore(snapshotPair.first, snapshotPair.second, nBlockHash), snapshotPair.first);
+        }
+    }
+    scores->Sort(nSortedMin);
+
+    {
+        LOCK(cs);
+        if (nGeneration == nRankCacheGeneration) {
+            mapRankCache.Insert(key, scores);
+        }
+    }
+
+    scoresRet = scores;
+    return true;
 }
 
+void CMasternodeMan::InvalidateRankCache()
+{
+    LOCK(cs);
+    mapRankCache.Clear();
+    nRankCacheGeneration++;
+}
+// EXOSIS END
+
 bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet, int nBlockHeight, int nMinProtocol)
 {
     nRankRet = -1;
@@ -672,25 +1005,22 @@ bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet,
         return false;
     }
 
-    LOCK(cs);
-
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    // EXOSIS BEGIN
+    //LOCK(cs);
+    //
+    //score_pair_vec_t vecMasternodeScores;
+    //if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    //    return false;
+    // no sorting needed, the rank is one more than the number of better scores
+    rank_cache_value_t scores;
+    if (!GetMasternodeScores(nBlockHash, nMinProtocol, 0, scores))
         return false;
 
-    int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
-        nRank++;
-        if(scorePair.second->vin.prevout == outpoint) {
-            nRankRet = nRank;
-            return true;
-        }
-    }
-
-    return false;
+    return scores->GetRank(outpoint, nRankRet);
+    // EXOSIS END
 }
 
-bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight, int nMinProtocol)
+bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight, int nMinProtocol, int nRanksMax)
 {
     vecMasternodeRanksRet.clear();
 
@@ -704,17 +1034,28 @@ bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMast
         return false;
     }
 
-    LOCK(cs);
-
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    // EXOSIS BEGIN
+    //LOCK(cs);
+    //
+    //score_pair_vec_t vecMasternodeScores;
+    //if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    //    return false;
+    rank_cache_value_t scores;
+    const size_t nCount = nRanksMax < 0 ? std::numeric_limits<size_t>::max() : nRanksMax;
+    if (!GetMasternodeScores(nBlockHash, nMinProtocol, nCount, scores))
         return false;
 
-    int nRank = 0;
-    for (auto& scorePair : vecMasternodeScores) {
-        nRank++;
-        vecMasternodeRanksRet.push_back(std::make_pair(nRank, *scorePair.second));
+    LOCK(cs);
+
+    vecMasternodeRanksRet.reserve(std::min(nCount, scores->nSorted));
+    for (size_t i = 0; i < nCount && i < scores->nSorted; i++) {
+        // skip masternodes removed since the scores were calculated
+        const CMasternode* pmn = Find(scores->vecScores[i].second);
+        if (pmn) {
+            vecMasternodeRanksRet.push_back(std::make_pair((int)i + 1, *pmn));
+        }
     }
+    // EXOSIS END
 
     return true;
 }
@@ -768,172 +1109,189 @@ std::pair<CService, std::set<uint256> > CMasternodeMan::PopScheduledMnbRequestCo
 }
 
 
-void CMasternodeMan::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+// EXOSIS BEGIN
+//void CMasternodeMan::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+void CMasternodeMan::ProcessAnnounceMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
 {
     if(fLiteMode) return; // disable all Dash specific functionality
 
-    if (strCommand == NetMsgType::MNANNOUNCE) { //Masternode Broadcast
-
-        CMasternodeBroadcast mnb;
-        vRecv >> mnb;
+    CMasternodeBroadcast mnb;
+    vRecv >> mnb;
 
-        pfrom->setAskFor.erase(mnb.GetHash());
+    pfrom->RemoveAskFor(mnb.GetHash());
 
-        if(!masternodeSync.IsBlockchainSynced()) return;
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        LogPrint(BCLog::MASTERNODE, "MNANNOUNCE -- Masternode announce, masternode=%s\n", mnb.vin.prevout.ToStringShort());
+    LogPrint(BCLog::MASTERNODE, "MNANNOUNCE -- Masternode announce, masternode=%s\n", mnb.vin.prevout.ToStringShort());
 
-        int nDos = 0;
+    int nDos = 0;
 
-        if (CheckMnbAndUpdateMasternodeList(pfrom, mnb, nDos, connman)) {
-            // use announced Masternode as a peer
-            connman.AddNewAddress(CAddress(mnb.addr, NODE_NETWORK), pfrom->addr, 2*60*60);
-        } else if(nDos > 0) {
-            LOCK(cs_main);
-            Misbehaving(pfrom->GetId(), nDos);
-        }
-
-        if(fMasternodesAdded) {
-            NotifyMasternodeUpdates(connman);
-        }
-    } else if (strCommand == NetMsgType::MNPING) { //Masternode Ping
-
-        CMasternodePing mnp;
-        vRecv >> mnp;
+    if (CheckMnbAndUpdateMasternodeList(pfrom, mnb, nDos, connman)) {
+        // use announced Masternode as a peer
+        connman.AddNewAddress(CAddress(mnb.addr, NODE_NETWORK), pfrom->addr, 2*60*60);
+    } else if(nDos > 0) {
+        LOCK(cs_main);
+        Misbehaving(pfrom->GetId(), nDos);
+    }
 
-        uint256 nHash = mnp.GetHash();
+    if(fMasternodesAdded) {
+        NotifyMasternodeUpdates(connman);
+    }
+}
+// EXOSIS END
 
-        pfrom->setAskFor.erase(nHash);
+// EXOSIS BEGIN
+void CMasternodeMan::ProcessPingMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fLiteMode) return; // disable all Dash specific functionality
 
-        if(!masternodeSync.IsBlockchainSynced()) return;
+    CMasternodePing mnp;
+    vRecv >> mnp;
 
-        LogPrint(BCLog::MASTERNODE, "MNPING -- Masternode ping, masternode=%s\n", mnp.vin.prevout.ToStringShort());
+    uint256 nHash = mnp.GetHash();
 
-        // Need LOCK2 here to ensure consistent locking order because the CheckAndUpdate call below locks cs_main
-        LOCK2(cs_main, cs);
+    pfrom->RemoveAskFor(nHash);
 
-        if(mapSeenMasternodePing.count(nHash)) return; //seen
-        mapSeenMasternodePing.insert(std::make_pair(nHash, mnp));
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        LogPrint(BCLog::MASTERNODE, "MNPING -- Masternode ping, masternode=%s new\n", mnp.vin.prevout.ToStringShort());
+    LogPrint(BCLog::MASTERNODE, "MNPING -- Masternode ping, masternode=%s\n", mnp.vin.prevout.ToStringShort());
 
-        // see if we have this Masternode
-        CMasternode* pmn = Find(mnp.vin.prevout);
+    // Need LOCK2 here to ensure consistent locking order because the CheckAndUpdate call below locks cs_main
+    LOCK2(cs_main, cs);
 
-        // if masternode uses sentinel ping instead of watchdog
-        // we shoud update nTimeLastWatchdogVote here if sentinel
-        // ping flag is actual
-        if(pmn && mnp.fSentinelIsCurrent)
-            UpdateWatchdogVoteTime(mnp.vin.prevout, mnp.sigTime);
+    if(mapSeenMasternodePing.count(nHash)) return; //seen
+    mapSeenMasternodePing.insert(std::make_pair(nHash, mnp));
 
-        // too late, new MNANNOUNCE is required
-        // EXOSIS BEGIN
-        // allow resync after wallet restart or resumed from standby
-        //if(pmn && pmn->IsNewStartRequired()) return;
-        if(pmn && pmn->IsExpired()) return;
-        // EXOSIS END
+    LogPrint(BCLog::MASTERNODE, "MNPING -- Masternode ping, masternode=%s new\n", mnp.vin.prevout.ToStringShort());
 
-        int nDos = 0;
-        if(mnp.CheckAndUpdate(pmn, false, nDos, connman)) return;
+    // see if we have this Masternode
+    CMasternode* pmn = Find(mnp.vin.prevout);
 
-        if(nDos > 0) {
-            // if anything significant failed, mark that node
-            Misbehaving(pfrom->GetId(), nDos);
-        } else if(pmn != NULL) {
-            // nothing significant failed, mn is a known one too
-            return;
-        }
+    // if masternode uses sentinel ping instead of watchdog
+    // we shoud update nTimeLastWatchdogVote here if sentinel
+    // ping flag is actual
+    if(pmn && mnp.fSentinelIsCurrent)
+        UpdateWatchdogVoteTime(mnp.vin.prevout, mnp.sigTime);
 
-        // something significant is broken or mn is unknown,
-        // we might have to ask for a masternode entry once
-        AskForMN(pfrom, mnp.vin.prevout, connman);
+    // too late, new MNANNOUNCE is required
+    // allow resync after wallet restart or resumed from standby
+    //if(pmn && pmn->IsNewStartRequired()) return;
+    if(pmn && pmn->IsExpired()) return;
+
+    int nDos = 0;
+    // the ping updates the known MN only
+    if(pmn) InvalidateSnapshot(mnp.vin.prevout);
+    if(mnp.CheckAndUpdate(pmn, false, nDos, connman)) return;
+
+    if(nDos > 0) {
+        // if anything significant failed, mark that node
+        Misbehaving(pfrom->GetId(), nDos);
+    } else if(pmn != NULL) {
+        // nothing significant failed, mn is a known one too
+        return;
+    }
 
-    } else if (strCommand == NetMsgType::DSEG) { //Get Masternode list or specific entry
-        // Ignore such requests until we are fully synced.
-        // We could start processing this after masternode list is synced
-        // but this is a heavy one so it's better to finish sync first.
-        if (!masternodeSync.IsSynced()) return;
+    // something significant is broken or mn is unknown,
+    // we might have to ask for a masternode entry once
+    AskForMN(pfrom, mnp.vin.prevout, connman);
+}
+// EXOSIS END
 
-        CTxIn vin;
-        vRecv >> vin;
+// EXOSIS BEGIN
+void CMasternodeMan::ProcessDsegMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fLiteMode) return; // disable all Dash specific functionality
 
-        LogPrint(BCLog::MASTERNODE, "DSEG -- Masternode list, masternode=%s\n", vin.prevout.ToStringShort());
+    // Ignore such requests until we are fully synced.
+    // We could start processing this after masternode list is synced
+    // but this is a heavy one so it's better to finish sync first.
+    if (!masternodeSync.IsSynced()) return;
 
-        LOCK2(cs_main, cs);
+    CTxIn vin;
+    vRecv >> vin;
 
-        if(vin == CTxIn()) { //only should ask for this once
-            //local network
-            bool isLocal = (pfrom->addr.IsRFC1918() || pfrom->addr.IsLocal());
+    LogPrint(BCLog::MASTERNODE, "DSEG -- Masternode list, masternode=%s\n", vin.prevout.ToStringShort());
 
-            if(!isLocal && Params().NetworkIDString() == CBaseChainParams::MAIN) {
-                std::map<CNetAddr, int64_t>::iterator it = mAskedUsForMasternodeList.find(pfrom->addr);
-                if (it != mAskedUsForMasternodeList.end() && it->second > GetTime()) {
-                    Misbehaving(pfrom->GetId(), 34);
-                    LogPrintf("DSEG -- peer already asked me for the list, peer=%d\n", pfrom->GetId());
-                    return;
-                }
-                int64_t askAgain = GetTime() + DSEG_UPDATE_SECONDS;
-                mAskedUsForMasternodeList[pfrom->addr] = askAgain;
-            }
-        } //else, asking for a specific node which is ok
+    LOCK2(cs_main, cs);
 
-        int nInvCount = 0;
+    if(vin == CTxIn()) { //only should ask for this once
+        //local network
+        bool isLocal = (pfrom->addr.IsRFC1918() || pfrom->addr.IsLocal());
 
-        for (auto& mnpair : mapMasternodes) {
-            if (vin != CTxIn() && vin != mnpair.second.vin) continue; // asked for specific vin but we are not there yet
-            if (mnpair.second.addr.IsRFC1918() || mnpair.second.addr.IsLocal()) continue; // do not send local network masternode
-            if (mnpair.second.IsUpdateRequired()) continue; // do not send outdated masternodes
-
-            LogPrint(BCLog::MASTERNODE, "DSEG -- Sending Masternode entry: masternode=%s  addr=%s\n", mnpair.first.ToStringShort(), mnpair.second.addr.ToString());
-            CMasternodeBroadcast mnb = CMasternodeBroadcast(mnpair.second);
-            CMasternodePing mnp = mnpair.second.lastPing;
-            uint256 hashMNB = mnb.GetHash();
-            uint256 hashMNP = mnp.GetHash();
-            pfrom->PushInventory(CInv(MSG_MASTERNODE_ANNOUNCE, hashMNB));
-            pfrom->PushInventory(CInv(MSG_MASTERNODE_PING, hashMNP));
-            nInvCount++;
-
-            mapSeenMasternodeBroadcast.insert(std::make_pair(hashMNB, std::make_pair(GetTime(), mnb)));
-            mapSeenMasternodePing.insert(std::make_pair(hashMNP, mnp));
-
-            if (vin.prevout == mnpair.first) {
-                LogPrintf("DSEG -- Sent 1 Masternode inv to peer %d\n", pfrom->GetId());
+        if(!isLocal && Params().NetworkIDString() == CBaseChainParams::MAIN) {
+            std::map<CNetAddr, int64_t>::iterator it = mAskedUsForMasternodeList.find(pfrom->addr);
+            if (it != mAskedUsForMasternodeList.end() && it->second > GetTime()) {
+                Misbehaving(pfrom->GetId(), 34);
+                LogPrintf("DSEG -- peer already asked me for the list, peer=%d\n", pfrom->GetId());
                 return;
             }
+            int64_t askAgain = GetTime() + DSEG_UPDATE_SECONDS;
+            mAskedUsForMasternodeList[pfrom->addr] = askAgain;
         }
+    } //else, asking for a specific node which is ok
+
+    int nInvCount = 0;
 
-        if(vin == CTxIn()) {
-            connman.PushMessage(pfrom, CNetMsgMaker(pfrom->GetSendVersion()).Make(NetMsgType::SYNCSTATUSCOUNT, MASTERNODE_SYNC_LIST, nInvCount));
-            LogPrintf("DSEG -- Sent %d Masternode invs to peer %d\n", nInvCount, pfrom->GetId());
+    for (auto& mnpair : mapMasternodes) {
+        if (vin != CTxIn() && vin != mnpair.second.vin) continue; // asked for specific vin but we are not there yet
+        if (mnpair.second.addr.IsRFC1918() || mnpair.second.addr.IsLocal()) continue; // do not send local network masternode
+        if (mnpair.second.IsUpdateRequired()) continue; // do not send outdated masternodes
+
+        LogPrint(BCLog::MASTERNODE, "DSEG -- Sending Masternode entry: masternode=%s  addr=%s\n", mnpair.first.ToStringShort(), mnpair.second.addr.ToString());
+        CMasternodeBroadcast mnb = CMasternodeBroadcast(mnpair.second);
+        CMasternodePing mnp = mnpair.second.lastPing;
+        uint256 hashMNB = mnb.GetHash();
+        uint256 hashMNP = mnp.GetHash();
+        pfrom->PushInventory(CInv(MSG_MASTERNODE_ANNOUNCE, hashMNB));
+        pfrom->PushInventory(CInv(MSG_MASTERNODE_PING, hashMNP));
+        nInvCount++;
+
+        mapSeenMasternodeBroadcast.insert(std::make_pair(hashMNB, std::make_pair(GetTime(), mnb)));
+        mapSeenMasternodePing.insert(std::make_pair(hashMNP, mnp));
+
+        if (vin.prevout == mnpair.first) {
+            LogPrintf("DSEG -- Sent 1 Masternode inv to peer %d\n", pfrom->GetId());
             return;
         }
-        // smth weird happen - someone asked us for vin we have no idea about?
-        LogPrint(BCLog::MASTERNODE, "DSEG -- No invs sent to peer %d\n", pfrom->GetId());
+    }
 
-    } else if (strCommand == NetMsgType::MNVERIFY) { // Masternode Verify
+    if(vin == CTxIn()) {
+        connman.PushMessage(pfrom, CNetMsgMaker(pfrom->GetSendVersion()).Make(NetMsgType::SYNCSTATUSCOUNT, MASTERNODE_SYNC_LIST, nInvCount));
+        LogPrintf("DSEG -- Sent %d Masternode invs to peer %d\n", nInvCount, pfrom->GetId());
+        return;
+    }
+    // smth weird happen - someone asked us for vin we have no idea about?
+    LogPrint(BCLog::MASTERNODE, "DSEG -- No invs sent to peer %d\n", pfrom->GetId());
+}
+// EXOSIS END
 
-        // Need LOCK2 here to ensure consistent locking order because the all functions below call GetBlockHash which locks cs_main
-        LOCK2(cs_main, cs);
+// EXOSIS BEGIN
+void CMasternodeMan::ProcessVerifyMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fLiteMode) return; // disable all Dash specific functionality
 
-        CMasternodeVerification mnv;
-        vRecv >> mnv;
+    // Need LOCK2 here to ensure consistent locking order because the all functions below call GetBlockHash which locks cs_main
+    LOCK2(cs_main, cs);
 
-        pfrom->setAskFor.erase(mnv.GetHash());
+    CMasternodeVerification mnv;
+    vRecv >> mnv;
 
-        if(!masternodeSync.IsMasternodeListSynced()) return;
+    pfrom->RemoveAskFor(mnv.GetHash());
 
-        if(mnv.vchSig1.empty()) {
-            // CASE 1: someone asked me to verify myself /IP we are using/
-            SendVerifyReply(pfrom, mnv, connman);
-        } else if (mnv.vchSig2.empty()) {
-            // CASE 2: we _probably_ got verification we requested from some masternode
-            ProcessVerifyReply(pfrom, mnv);
-        } else {
-            // CASE 3: we _probably_ got verification broadcast signed by some masternode which verified another one
-            ProcessVerifyBroadcast(pfrom, mnv);
-        }
+    if(!masternodeSync.IsMasternodeListSynced()) return;
+
+    if(mnv.vchSig1.empty()) {
+        // CASE 1: someone asked me to verify myself /IP we are using/
+        SendVerifyReply(pfrom, mnv, connman);
+    } else if (mnv.vchSig2.empty()) {
+        // CASE 2: we _probably_ got verification we requested from some masternode
+        ProcessVerifyReply(pfrom, mnv);
+    } else {
+        // CASE 3: we _probably_ got verification broadcast signed by some masternode which verified another one
+        ProcessVerifyBroadcast(pfrom, mnv);
     }
 }
+// EXOSIS END
 
 // Verification of masternodes via unique direct requests.
 
@@ -942,6 +1300,17 @@ void CMasternodeMan::DoFullVerificationStep(CConnman& connman)
     if(activeMasternode.outpoint == COutPoint()) return;
     if(!masternodeSync.IsSynced()) return;
 
+    // EXOSIS BEGIN
+    // only rank the whole list if we are in top MAX_POSE_RANK
+    int nRank;
+    if (!GetMasternodeRank(activeMasternode.outpoint, nRank, nCachedBlockHeight - 1, MIN_POSE_PROTO_VERSION)) return;
+    if (nRank > MAX_POSE_RANK) {
+        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::DoFullVerificationStep -- Must be in top %d to send verify request\n",
+                    (int)MAX_POSE_RANK);
+        return;
+    }
+    // EXOSIS END
+
     rank_pair_vec_t vecMasternodeRanks;
     GetMasternodeRanks(vecMasternodeRanks, nCachedBlockHeight - 1, MIN_POSE_PROTO_VERSION);
 
@@ -1065,9 +1434,15 @@ void CMasternodeMan::CheckSameAddr()
     }
 
     // ban duplicates
+    // EXOSIS BEGIN
+    LOCK(cs);
+    // EXOSIS END
     for (auto* pmn : vBan) {
         LogPrintf("CMasternodeMan::CheckSameAddr -- increasing PoSe ban score for masternode %s\n", pmn->vin.prevout.ToStringShort());
         pmn->IncreasePoSeBanScore();
+        // EXOSIS BEGIN
+        InvalidateSnapshot(pmn->vin.prevout);
+        // EXOSIS END
     }
 }
 
@@ -1196,6 +1571,9 @@ void CMasternodeMan::ProcessVerifyReply(CNode* pnode, CMasternodeVerification& m
                     prealMasternode = &mnpair.second;
                     if(!mnpair.second.IsPoSeVerified()) {
                         mnpair.second.DecreasePoSeBanScore();
+                        // EXOSIS BEGIN
+                        InvalidateSnapshot(mnpair.first);
+                        // EXOSIS END
                     }
                     netfulfilledman.AddFulfilledRequest(pnode->addr, strprintf("%s", NetMsgType::MNVERIFY)+"-done");
 
@@ -1242,6 +1620,9 @@ void CMasternodeMan::ProcessVerifyReply(CNode* pnode, CMasternodeVerification& m
         // increase ban score for everyone else
         for (auto* pmn : vpMasternodesToBan) {
             pmn->IncreasePoSeBanScore();
+            // EXOSIS BEGIN
+            InvalidateSnapshot(pmn->vin.prevout);
+            // EXOSIS END
             LogPrint(BCLog::MASTERNODE, "CMasternodeMan::ProcessVerifyReply -- increased PoSe ban score for %s addr %s, new score %d\n",
                         prealMasternode->vin.prevout.ToStringShort(), pnode->addr.ToString(), pmn->nPoSeBanScore);
         }
@@ -1336,6 +1717,9 @@ void CMasternodeMan::ProcessVerifyBroadcast(CNode* pnode, const CMasternodeVerif
 
         if(!pmn1->IsPoSeVerified()) {
             pmn1->DecreasePoSeBanScore();
+            // EXOSIS BEGIN
+            InvalidateSnapshot(pmn1->vin.prevout);
+            // EXOSIS END
         }
         mnv.Relay();
 
@@ -1347,6 +1731,9 @@ void CMasternodeMan::ProcessVerifyBroadcast(CNode* pnode, const CMasternodeVerif
         for (auto& mnpair : mapMasternodes) {
             if(mnpair.second.addr != mnv.addr || mnpair.first == mnv.vin1.prevout) continue;
             mnpair.second.IncreasePoSeBanScore();
+            // EXOSIS BEGIN
+            InvalidateSnapshot(mnpair.first);
+            // EXOSIS END
             nCount++;
             LogPrint(BCLog::MASTERNODE, "CMasternodeMan::ProcessVerifyBroadcast -- increased PoSe ban score for %s addr %s, new score %d\n",
                         mnpair.first.ToStringShort(), mnpair.second.addr.ToString(), mnpair.second.nPoSeBanScore);
@@ -1365,14 +1752,65 @@ std::string CMasternodeMan::ToString() const
             ", peers who asked us for Masternode list: " << (int)mAskedUsForMasternodeList.size() <<
             ", peers we asked for Masternode list: " << (int)mWeAskedForMasternodeList.size() <<
             ", entries in Masternode list we asked for: " << (int)mWeAskedForMasternodeListEntry.size() <<
-            ", nDsqCount: " << (int)nDsqCount;
+            // EXOSIS BEGIN
+            //", nDsqCount: " << (int)nDsqCount;
+            ", nDsqCount: " << (int)nDsqCount <<
+            ", memory usage: " << DynamicMemoryUsage();
+            // EXOSIS END
 
     return info.str();
 }
 
+// EXOSIS BEGIN
+size_t CMasternodeMan::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+
+    size_t nUsage = memusage::DynamicUsage(mapMasternodes) +
+                    memusage::DynamicUsage(mAskedUsForMasternodeList) +
+                    memusage::DynamicUsage(mWeAskedForMasternodeList) +
+                    memusage::DynamicUsage(mWeAskedForMasternodeListEntry) +
+                    memusage::DynamicUsage(mWeAskedForVerification) +
+                    memusage::DynamicUsage(mMnbRecoveryRequests) +
+                    memusage::DynamicUsage(mMnbRecoveryGoodReplies) +
+                    memusage::DynamicUsage(mapSeenMasternodeBroadcast) +
+                    memusage::DynamicUsage(mapSeenMasternodePing) +
+                    memusage::DynamicUsage(mapSeenMasternodeVerification) +
+                    memusage::DynamicUsage(setPaymentQueue);
+    for (const auto& entryPair : mWeAskedForMasternodeListEntry) {
+        nUsage += memusage::DynamicUsage(entryPair.second);
+    }
+    for (const auto& requestPair : mMnbRecoveryRequests) {
+        nUsage += memusage::DynamicUsage(requestPair.second.second);
+    }
+    for (const auto& repliesPair : mMnbRecoveryGoodReplies) {
+        nUsage += memusage::DynamicUsage(repliesPair.second);
+        for (const auto& mnb : repliesPair.second) {
+            nUsage += mnb.DynamicMemoryUsage();
+        }
+    }
+    for (const auto& mnpair : mapMasternodes) {
+        nUsage += mnpair.second.DynamicMemoryUsage();
+    }
+    for (const auto& mnbPair : mapSeenMasternodeBroadcast) {
+        nUsage += mnbPair.second.second.DynamicMemoryUsage();
+    }
+    for (const auto& mnpPair : mapSeenMasternodePing) {
+        nUsage += mnpPair.second.DynamicMemoryUsage();
+    }
+    for (const auto& mnvPair : mapSeenMasternodeVerification) {
+        nUsage += mnvPair.second.DynamicMemoryUsage();
+    }
+    return nUsage;
+}
+// EXOSIS END
+
 void CMasternodeMan::UpdateMasternodeList(CMasternodeBroadcast mnb, CConnman& connman)
 {
     LOCK2(cs_main, cs);
+    // EXOSIS BEGIN
+    InvalidateSnapshot(mnb.vin.prevout);
+    // EXOSIS END
     mapSeenMasternodePing.insert(std::make_pair(mnb.lastPing.GetHash(), mnb.lastPing));
     mapSeenMasternodeBroadcast.insert(std::make_pair(mnb.GetHash(), std::make_pair(GetTime(), mnb)));
 
@@ -1446,6 +1884,9 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
         // search Masternode list
         CMasternode* pmn = Find(mnb.vin.prevout);
         if(pmn) {
+            // EXOSIS BEGIN
+            InvalidateSnapshot(mnb.vin.prevout);
+            // EXOSIS END
             CMasternodeBroadcast mnbOld = mapSeenMasternodeBroadcast[CMasternodeBroadcast(*pmn).GetHash()].second;
             if(!mnb.Update(pmn, nDos, connman)) {
                 LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckMnbAndUpdateMasternodeList -- Update() failed, masternode=%s\n", mnb.vin.prevout.ToStringShort());
@@ -1503,7 +1944,17 @@ void CMasternodeMan::UpdateLastPaid(const CBlockIndex* pindex)
     //                         nCachedBlockHeight, nMaxBlocksToScanBack, IsFirstRun ? "true" : "false");
 
     for (auto& mnpair: mapMasternodes) {
+        // EXOSIS BEGIN
+        //mnpair.second.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
+        const int nBlockLastPaidOld = mnpair.second.GetLastPaidBlock();
         mnpair.second.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
+        if (mnpair.second.GetLastPaidBlock() != nBlockLastPaidOld) {
+            // move it in the payment queue
+            setPaymentQueue.erase(std::make_pair(nBlockLastPaidOld, mnpair.first));
+            AddToPaymentQueue(mnpair.second);
+            InvalidateSnapshot(mnpair.first);
+        }
+        // EXOSIS END
     }
 
     IsFirstRun = false;
@@ -1518,6 +1969,9 @@ void CMasternodeMan::UpdateWatchdogVoteTime(const COutPoint& outpoint, uint64_t
     }
     pmn->UpdateWatchdogVoteTime(nVoteTime);
     nLastWatchdogVoteTime = GetTime();
+    // EXOSIS BEGIN
+    InvalidateSnapshot(outpoint);
+    // EXOSIS END
 }
 
 bool CMasternodeMan::IsWatchdogActive()
@@ -1535,6 +1989,9 @@ bool CMasternodeMan::AddGovernanceVote(const COutPoint& outpoint, uint256 nGover
         return false;
     }
     pmn->AddGovernanceVote(nGovernanceObjectHash);
+    // EXOSIS BEGIN
+    InvalidateSnapshot(outpoint);
+    // EXOSIS END
     return true;
 }
 
@@ -1542,7 +1999,13 @@ void CMasternodeMan::RemoveGovernanceObject(uint256 nGovernanceObjectHash)
 {
     LOCK(cs);
     for(auto& mnpair : mapMasternodes) {
-        mnpair.second.RemoveGovernanceObject(nGovernanceObjectHash);
+        // EXOSIS BEGIN
+        //mnpair.second.RemoveGovernanceObject(nGovernanceObjectHash);
+        if (mnpair.second.mapGovernanceObjectsVotedOn.count(nGovernanceObjectHash)) {
+            mnpair.second.RemoveGovernanceObject(nGovernanceObjectHash);
+            InvalidateSnapshot(mnpair.first);
+        }
+        // EXOSIS END
     }
 }
 
@@ -1554,7 +2017,10 @@ void CMasternodeMan::CheckMasternode(const CPubKey& pubKeyMasternode, bool fForc
     // EXOSIS END
     for (auto& mnpair : mapMasternodes) {
         if (mnpair.second.pubKeyMasternode == pubKeyMasternode) {
-            mnpair.second.Check(fForce);
+            // EXOSIS BEGIN
+            //mnpair.second.Check(fForce);
+            CheckMasternodeState(mnpair.second, fForce);
+            // EXOSIS END
             return;
         }
     }
@@ -1575,6 +2041,9 @@ void CMasternodeMan::SetMasternodeLastPing(const COutPoint& outpoint, const CMas
         return;
     }
     pmn->lastPing = mnp;
+    // EXOSIS BEGIN
+    InvalidateSnapshot(outpoint);
+    // EXOSIS END
     // if masternode uses sentinel ping instead of watchdog
     // we shoud update nTimeLastWatchdogVote here if sentinel
     // ping flag is actual
@@ -7,9 +7,19 @@
 #ifndef DASH_MASTERNODEMAN_H
 #define DASH_MASTERNODEMAN_H
 
+// EXOSIS BEGIN
+#include <cachemap.h>
+// EXOSIS END
 #include <masternode.h>
 #include <sync.h>
 
+// EXOSIS BEGIN
+#include <util/hasher.h>
+
+#include <memory>
+#include <unordered_map>
+// EXOSIS END
+
 using namespace std;
 
 class CMasternodeMan;
@@ -17,6 +27,24 @@ class CConnman;
 
 extern CMasternodeMan mnodeman;
 
+// EXOSIS BEGIN
+/**
+ * Scores of the masternodes for one block hash. Only the first nSorted entries
+ * are in rank order (highest score first), the rest are all ranked below them.
+ */
+struct CMasternodeScores
+{
+    std::vector<std::pair<arith_uint256, COutPoint> > vecScores;
+    size_t nSorted;
+
+    CMasternodeScores() : nSorted(0) {}
+
+    /// Make sure at least the first nCount entries are in rank order
+    void Sort(size_t nCount);
+    bool GetRank(const COutPoint& outpoint, int& nRankRet) const;
+};
+// EXOSIS END
+
 class CMasternodeMan
 {
 public:
@@ -24,6 +52,9 @@ public:
     typedef std::vector<score_pair_t> score_pair_vec_t;
     typedef std::pair<int, CMasternode> rank_pair_t;
     typedef std::vector<rank_pair_t> rank_pair_vec_t;
+    // EXOSIS BEGIN
+    typedef std::shared_ptr<const std::map<COutPoint, std::shared_ptr<const CMasternode> > > mn_map_snapshot_t;
+    // EXOSIS END
 
 private:
     static const std::string SERIALIZATION_VERSION_STRING;
@@ -43,6 +74,13 @@ private:
     static const int MNB_RECOVERY_WAIT_SECONDS      = 60;
     static const int MNB_RECOVERY_RETRY_SECONDS     = 3 * 60 * 60;
 
+    // EXOSIS BEGIN
+    static const int RANK_CACHE_SIZE            = 16;
+
+    typedef std::pair<uint256, int> rank_cache_key_t;
+    typedef std::shared_ptr<const CMasternodeScores> rank_cache_value_t;
+    // EXOSIS END
+
 
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
@@ -52,18 +90,41 @@ private:
 
     // map to hold all MNs
     std::map<COutPoint, CMasternode> mapMasternodes;
+    // EXOSIS BEGIN
+    // index of MNs by collateral payee script, outpoints in mapMasternodes order
+    std::map<CScript, std::set<COutPoint> > mapPayeeIndex;
+    // MN scores for (block hash, min protocol), see GetMasternodeScores()
+    CacheMap<rank_cache_key_t, rank_cache_value_t> mapRankCache;
+    // bumped on every InvalidateRankCache() so scores computed from an outdated list are not cached
+    uint64_t nRankCacheGeneration;
+    // MNs ordered by last paid block, then by outpoint, see GetNextMasternodeInQueueForPayment()
+    std::set<std::pair<int, COutPoint> > setPaymentQueue;
+    // immutable copy of mapMasternodes shared by readers, the next snapshot shares all entries
+    // but the changed ones with the previous one
+    mn_map_snapshot_t mapMasternodesSnapshot;
+    // MNs added, removed or changed since mapMasternodesSnapshot was taken
+    std::set<COutPoint> setSnapshotDirty;
+    bool fSnapshotDirtyAll;
+    // EXOSIS END
     // who's asked for the Masternode list and the last time
     std::map<CNetAddr, int64_t> mAskedUsForMasternodeList;
     // who we asked for the Masternode list and the last time
     std::map<CNetAddr, int64_t> mWeAskedForMasternodeList;
     // which Masternodes we've asked for
-    std::map<COutPoint, std::map<CNetAddr, int64_t> > mWeAskedForMasternodeListEntry;
+    // EXOSIS BEGIN
+    //std::map<COutPoint, std::map<CNetAddr, int64_t> > mWeAskedForMasternodeListEntry;
+    std::unordered_map<COutPoint, std::map<CNetAddr, int64_t>, SaltedOutpointHasher> mWeAskedForMasternodeListEntry;
+    // EXOSIS END
     // who we asked for the masternode verification
     std::map<CNetAddr, CMasternodeVerification> mWeAskedForVerification;
 
     // these maps are used for masternode recovery from MASTERNODE_NEW_START_REQUIRED state
-    std::map<uint256, std::pair< int64_t, std::set<CNetAddr> > > mMnbRecoveryRequests;
-    std::map<uint256, std::vector<CMasternodeBroadcast> > mMnbRecoveryGoodReplies;
+    // EXOSIS BEGIN
+    //std::map<uint256, std::pair< int64_t, std::set<CNetAddr> > > mMnbRecoveryRequests;
+    //std::map<uint256, std::vector<CMasternodeBroadcast> > mMnbRecoveryGoodReplies;
+    std::unordered_map<uint256, std::pair< int64_t, std::set<CNetAddr> >, SaltedTxidHasher> mMnbRecoveryRequests;
+    std::unordered_map<uint256, std::vector<CMasternodeBroadcast>, SaltedTxidHasher> mMnbRecoveryGoodReplies;
+    // EXOSIS END
     std::list< std::pair<CService, uint256> > listScheduledMnbRequestConnections;
 
     /// Set when masternodes are added, cleared when CGovernanceManager is notified
@@ -80,15 +141,41 @@ private:
     /// Find an entry
     CMasternode* Find(const COutPoint& outpoint);
 
-    bool GetMasternodeScores(const uint256& nBlockHash, score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol = 0);
+    // EXOSIS BEGIN
+    void AddToPayeeIndex(const CMasternode& mn);
+    void RemoveFromPayeeIndex(const CMasternode& mn);
+    void RebuildPayeeIndex();
+    void AddToPaymentQueue(CMasternode& mn);
+    void RemoveFromPaymentQueue(CMasternode& mn);
+    void RebuildPaymentQueue();
+    bool IsQualifiedForPayment(CMasternode& mn, int nMnCount, bool fFilterSigTime, const std::set<CScript>& setScheduledPayees);
+    /// Must be called with cs held, before the lock is released after changing the whole list
+    void InvalidateSnapshot();
+    /// Must be called with cs held, before the lock is released after adding, removing or changing one MN
+    void InvalidateSnapshot(const COutPoint& outpoint);
+    /// Check() one MN, invalidating its snapshot entry if its state changed
+    void CheckMasternodeState(CMasternode& mn, bool fForce);
+    // EXOSIS END
+
+    // EXOSIS BEGIN
+    //bool GetMasternodeScores(const uint256& nBlockHash, score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol = 0);
+    /// Scores are computed outside of cs, with at least the top nSortedMin ranks sorted
+    bool GetMasternodeScores(const uint256& nBlockHash, int nMinProtocol, size_t nSortedMin, rank_cache_value_t& scoresRet);
+    // EXOSIS END
 
 public:
+    // EXOSIS BEGIN
+    // Lookup-only maps (AlreadyHave, relay, vote processing), so they are hashed with a random salt
     // Keep track of all broadcasts I've seen
-    std::map<uint256, std::pair<int64_t, CMasternodeBroadcast> > mapSeenMasternodeBroadcast;
+    //std::map<uint256, std::pair<int64_t, CMasternodeBroadcast> > mapSeenMasternodeBroadcast;
+    std::unordered_map<uint256, std::pair<int64_t, CMasternodeBroadcast>, SaltedTxidHasher> mapSeenMasternodeBroadcast;
     // Keep track of all pings I've seen
-    std::map<uint256, CMasternodePing> mapSeenMasternodePing;
+    //std::map<uint256, CMasternodePing> mapSeenMasternodePing;
+    std::unordered_map<uint256, CMasternodePing, SaltedTxidHasher> mapSeenMasternodePing;
     // Keep track of all verifications I've seen
-    std::map<uint256, CMasternodeVerification> mapSeenMasternodeVerification;
+    //std::map<uint256, CMasternodeVerification> mapSeenMasternodeVerification;
+    std::unordered_map<uint256, CMasternodeVerification, SaltedTxidHasher> mapSeenMasternodeVerification;
+    // EXOSIS END
     // keep track of dsq count to prevent masternodes from gaming darksend queue
     int64_t nDsqCount;
 
@@ -121,6 +208,14 @@ public:
         if(ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
+        // EXOSIS BEGIN
+        if(ser_action.ForRead()) {
+            RebuildPayeeIndex();
+            RebuildPaymentQueue();
+            InvalidateRankCache();
+            InvalidateSnapshot();
+        }
+        // EXOSIS END
     }
 
     CMasternodeMan();
@@ -169,24 +264,52 @@ public:
     bool GetMasternodeInfo(const COutPoint& outpoint, masternode_info_t& mnInfoRet);
     bool GetMasternodeInfo(const CPubKey& pubKeyMasternode, masternode_info_t& mnInfoRet);
     bool GetMasternodeInfo(const CScript& payee, masternode_info_t& mnInfoRet);
+    // EXOSIS BEGIN
+    /// Same as above, skipping the masternodes in setExclude
+    bool GetMasternodeInfo(const CScript& payee, const std::set<COutPoint>& setExclude, masternode_info_t& mnInfoRet);
+    // EXOSIS END
 
     /// Find an entry in the masternode list that is next to be paid
     bool GetNextMasternodeInQueueForPayment(int nBlockHeight, bool fFilterSigTime, int& nCountRet, masternode_info_t& mnInfoRet);
     /// Same as above but use current block height
     bool GetNextMasternodeInQueueForPayment(bool fFilterSigTime, int& nCountRet, masternode_info_t& mnInfoRet);
+    // EXOSIS BEGIN
+    /// Count Masternodes qualified for payment at current block height.
+    /// GetNextMasternodeInQueueForPayment() stops counting once the winner is known.
+    int CountQualifiedForPayment();
+    // EXOSIS END
 
     /// Find a random entry
     masternode_info_t FindRandomNotInVec(const std::vector<COutPoint> &vecToExclude, int nProtocolVersion = -1);
 
-    std::map<COutPoint, CMasternode> GetFullMasternodeMap() { return mapMasternodes; }
+    // EXOSIS BEGIN
+    //std::map<COutPoint, CMasternode> GetFullMasternodeMap() { return mapMasternodes; }
+    /// Shared read-only copy of the masternode list, only copied again after the list changed
+    mn_map_snapshot_t GetMasternodeMapSnapshot();
+    // EXOSIS END
 
-    bool GetMasternodeRanks(rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight = -1, int nMinProtocol = 0);
+    // EXOSIS BEGIN
+    //bool GetMasternodeRanks(rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight = -1, int nMinProtocol = 0);
+    /// Returns up to nRanksMax top ranked masternodes, all of them if nRanksMax is negative
+    bool GetMasternodeRanks(rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight = -1, int nMinProtocol = 0, int nRanksMax = -1);
+    // EXOSIS END
     bool GetMasternodeRank(const COutPoint &outpoint, int& nRankRet, int nBlockHeight = -1, int nMinProtocol = 0);
+    // EXOSIS BEGIN
+    /// Must be called when a masternode is added or removed or its protocol version changes
+    void InvalidateRankCache();
+    // EXOSIS END
 
     void ProcessMasternodeConnections(CConnman& connman);
     std::pair<CService, std::set<uint256> > PopScheduledMnbRequestConnection();
 
-    void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS BEGIN
+    //void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Handlers of the MNANNOUNCE, MNPING, DSEG and MNVERIFY messages
+    void ProcessAnnounceMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessPingMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessDsegMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessVerifyMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS END
 
     void DoFullVerificationStep(CConnman& connman);
     void CheckSameAddr();
@@ -199,12 +322,26 @@ public:
     int size() { return mapMasternodes.size(); }
 
     std::string ToString() const;
+    // EXOSIS BEGIN
+    /// Heap memory used by the list and the lookup maps, including the signatures and scripts of their entries
+    size_t DynamicMemoryUsage() const;
+    // EXOSIS END
 
     /// Update masternode list and maps using provided CMasternodeBroadcast
     void UpdateMasternodeList(CMasternodeBroadcast mnb, CConnman& connman);
     /// Perform complete check and only then update list and maps
     bool CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBroadcast mnb, int& nDos, CConnman& connman);
-    bool IsMnbRecoveryRequested(const uint256& hash) { return mMnbRecoveryRequests.count(hash); }
+    // EXOSIS BEGIN
+    //bool IsMnbRecoveryRequested(const uint256& hash) { return mMnbRecoveryRequests.count(hash); }
+    bool IsMnbRecoveryRequested(const uint256& hash) { LOCK(cs); return mMnbRecoveryRequests.count(hash); }
+
+    bool HasSeenMasternodeBroadcast(const uint256& hash);
+    bool GetSeenMasternodeBroadcast(const uint256& hash, CMasternodeBroadcast& mnbRet);
+    bool HasSeenMasternodePing(const uint256& hash);
+    bool GetSeenMasternodePing(const uint256& hash, CMasternodePing& mnpRet);
+    bool HasSeenMasternodeVerification(const uint256& hash);
+    bool GetSeenMasternodeVerification(const uint256& hash, CMasternodeVerification& mnvRet);
+    // EXOSIS END
 
     void UpdateLastPaid(const CBlockIndex* pindex);
 
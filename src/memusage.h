@@ -12,6 +12,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -87,6 +88,17 @@ static inline size_t DynamicUsage(const std::vector<X>& v)
     return MallocUsage(v.capacity() * sizeof(X));
 }
 
+// EXOSIS BEGIN
+static inline size_t DynamicUsage(const std::string& s)
+{
+    // Short strings live in the object itself
+    const char* p = s.data();
+    if (p >= reinterpret_cast<const char*>(&s) && p < reinterpret_cast<const char*>(&s + 1))
+        return 0;
+    return MallocUsage(s.capacity() + 1);
+}
+// EXOSIS END
+
 template<unsigned int N, typename X, typename S, typename D>
 static inline size_t DynamicUsage(const prevector<N, X, S, D>& v)
 {
@@ -4,12 +4,91 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+// EXOSIS BEGIN
+#include <checkqueue.h>
+#include <crypto/sha256.h>
+#include <cuckoocache.h>
+// EXOSIS END
 #include <hash.h>
 #include <key_io.h>
 #include <validation.h> // For strMessageMagic
 #include <messagesigner.h>
+// EXOSIS BEGIN
+#include <random.h>
+#include <script/sigcache.h>
+// EXOSIS END
 #include <tinyformat.h>
 #include <util/strencodings.h>
+// EXOSIS BEGIN
+#include <util/system.h>
+// EXOSIS END
+
+// EXOSIS BEGIN
+#include <boost/thread.hpp>
+
+namespace {
+/**
+ * Valid masternode message signature cache. Masternode broadcasts, pings, votes and governance
+ * objects get verified again when they are relayed, synced to peers or reprocessed as orphans.
+ */
+class CMessageSignatureCache
+{
+private:
+    //! Entries are SHA256(nonce || hash || public key || signature):
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_sigcache;
+
+public:
+    //! Room for 2^16 entries
+    static const size_t CACHE_BYTES = 2 << 20;
+
+    CMessageSignatureCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+        setValid.setup_bytes(CACHE_BYTES);
+    }
+
+    void
+    ComputeEntry(uint256& entry, const uint256 &hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubkey)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(hash.begin(), 32).Write(pubkey.begin(), pubkey.size()).Write(vchSig.data(), vchSig.size()).Finalize(entry.begin());
+    }
+
+    bool
+    Get(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
+        return setValid.contains(entry, false);
+    }
+
+    void Set(uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
+        setValid.insert(entry);
+    }
+};
+
+static CMessageSignatureCache messageSignatureCache;
+static CCheckQueue<CHashSignatureCheck> messagesigcheckqueue(128);
+} // namespace
+
+void ThreadMessageSignatureCheck() {
+    RenameThread("exosis-msgsigch");
+    messagesigcheckqueue.Thread();
+}
+
+bool CHashSignatureCheck::operator()()
+{
+    std::string strError;
+    const bool fValid = CHashSigner::VerifyHash(hash, pubkey, vchSig, strError);
+    if (pfValidRet) {
+        *pfValidRet = fValid;
+    }
+    return true;
+}
+// EXOSIS END
 
 bool CMessageSigner::GetKeysFromSecret(const std::string strSecret, CKey& keyRet, CPubKey& pubkeyRet)
 {
@@ -31,13 +110,27 @@ bool CMessageSigner::SignMessage(const std::string strMessage, std::vector<unsig
 }
 
 bool CMessageSigner::VerifyMessage(const CPubKey pubkey, const std::vector<unsigned char>& vchSig, const std::string strMessage, std::string& strErrorRet)
+{
+    // EXOSIS BEGIN
+    //CHashWriter ss(SER_GETHASH, 0);
+    //ss << strMessageMagic;
+    //ss << strMessage;
+    //
+    //return CHashSigner::VerifyHash(ss.GetHash(), pubkey, vchSig, strErrorRet);
+    return CHashSigner::VerifyHash(GetMessageHash(strMessage), pubkey, vchSig, strErrorRet);
+    // EXOSIS END
+}
+
+// EXOSIS BEGIN
+uint256 CMessageSigner::GetMessageHash(const std::string& strMessage)
 {
     CHashWriter ss(SER_GETHASH, 0);
     ss << strMessageMagic;
     ss << strMessage;
 
-    return CHashSigner::VerifyHash(ss.GetHash(), pubkey, vchSig, strErrorRet);
+    return ss.GetHash();
 }
+// EXOSIS END
 
 bool CHashSigner::SignHash(const uint256& hash, const CKey key, std::vector<unsigned char>& vchSigRet)
 {
@@ -46,6 +139,14 @@ bool CHashSigner::SignHash(const uint256& hash, const CKey key, std::vector<unsi
 
 bool CHashSigner::VerifyHash(const uint256& hash, const CPubKey pubkey, const std::vector<unsigned char>& vchSig, std::string& strErrorRet)
 {
+    // EXOSIS BEGIN
+    uint256 entry;
+    messageSignatureCache.ComputeEntry(entry, hash, vchSig, pubkey);
+    if (messageSignatureCache.Get(entry)) {
+        return true;
+    }
+    // EXOSIS END
+
     CPubKey pubkeyFromSig;
     if(!pubkeyFromSig.RecoverCompact(hash, vchSig)) {
         strErrorRet = "Error recovering public key.";
@@ -59,5 +160,31 @@ bool CHashSigner::VerifyHash(const uint256& hash, const CPubKey pubkey, const st
         return false;
     }
 
+    // EXOSIS BEGIN
+    messageSignatureCache.Set(entry);
+    // EXOSIS END
+
     return true;
 }
+
+// EXOSIS BEGIN
+void CHashSigner::VerifyHashes(std::vector<CHashSignatureCheck>& vChecks)
+{
+    if (!nScriptCheckThreads) {
+        for (CHashSignatureCheck& check : vChecks) {
+            check();
+        }
+        return;
+    }
+    CCheckQueueControl<CHashSignatureCheck> control(&messagesigcheckqueue);
+    control.Add(vChecks);
+    control.Wait();
+}
+
+bool CHashSigner::IsSignatureCached(const uint256& hash, const CPubKey& pubkey, const std::vector<unsigned char>& vchSig)
+{
+    uint256 entry;
+    messageSignatureCache.ComputeEntry(entry, hash, vchSig, pubkey);
+    return messageSignatureCache.Get(entry);
+}
+// EXOSIS END
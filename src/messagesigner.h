@@ -20,8 +20,42 @@ public:
     static bool SignMessage(const std::string strMessage, std::vector<unsigned char>& vchSigRet, const CKey key);
     /// Verify the message signature, returns true if succcessful
     static bool VerifyMessage(const CPubKey pubkey, const std::vector<unsigned char>& vchSig, const std::string strMessage, std::string& strErrorRet);
+    // EXOSIS BEGIN
+    /// Hash that SignMessage() signs and VerifyMessage() checks
+    static uint256 GetMessageHash(const std::string& strMessage);
+    // EXOSIS END
 };
 
+// EXOSIS BEGIN
+/** Closure representing one hash signature check, see CHashSigner::VerifyHashes()
+ */
+class CHashSignatureCheck
+{
+private:
+    uint256 hash;
+    CPubKey pubkey;
+    std::vector<unsigned char> vchSig;
+    bool* pfValidRet;
+
+public:
+    CHashSignatureCheck() : pfValidRet(nullptr) {}
+    /// If pfValidRetIn is set it receives the result of the check
+    CHashSignatureCheck(const uint256& hashIn, const CPubKey& pubkeyIn, const std::vector<unsigned char>& vchSigIn, bool* pfValidRetIn = nullptr) :
+        hash(hashIn), pubkey(pubkeyIn), vchSig(vchSigIn), pfValidRet(pfValidRetIn) {}
+
+    /// Always succeeds, an invalid signature must not stop the rest of the batch
+    bool operator()();
+
+    void swap(CHashSignatureCheck& check)
+    {
+        std::swap(hash, check.hash);
+        std::swap(pubkey, check.pubkey);
+        vchSig.swap(check.vchSig);
+        std::swap(pfValidRet, check.pfValidRet);
+    }
+};
+// EXOSIS END
+
 /** Helper class for signing hashes and checking their signatures
  */
 class CHashSigner
@@ -31,6 +65,19 @@ public:
     static bool SignHash(const uint256& hash, const CKey key, std::vector<unsigned char>& vchSigRet);
     /// Verify the hash signature, returns true if succcessful
     static bool VerifyHash(const uint256& hash, const CPubKey pubkey, const std::vector<unsigned char>& vchSig, std::string& strErrorRet);
+    // EXOSIS BEGIN
+    /// Verify many signatures at once on the signature check threads. Valid signatures are
+    /// remembered in the signature cache, so the VerifyHash() calls for them that follow are cheap.
+    /// The checks are moved out of vChecks.
+    static void VerifyHashes(std::vector<CHashSignatureCheck>& vChecks);
+    /// Return true if the signature was verified before and is still in the signature cache
+    static bool IsSignatureCached(const uint256& hash, const CPubKey& pubkey, const std::vector<unsigned char>& vchSig);
+    // EXOSIS END
 };
 
+// EXOSIS BEGIN
+/** Run a masternode message signature check thread */
+void ThreadMessageSignatureCheck();
+// EXOSIS END
+
 #endif // DASH_MESSAGESIGNER_H
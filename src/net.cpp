@@ -2961,11 +2961,21 @@ CNode::~CNode()
 
 void CNode::AskFor(const CInv& inv)
 {
-    if (mapAskFor.size() > MAPASKFOR_MAX_SZ || setAskFor.size() > SETASKFOR_MAX_SZ)
-        return;
-    // a peer may not have multiple non-responded queue positions for a single inv item
-    if (!setAskFor.insert(inv.hash).second)
-        return;
+    // EXOSIS BEGIN
+    //if (mapAskFor.size() > MAPASKFOR_MAX_SZ || setAskFor.size() > SETASKFOR_MAX_SZ)
+    //    return;
+    //// a peer may not have multiple non-responded queue positions for a single inv item
+    //if (!setAskFor.insert(inv.hash).second)
+    //    return;
+    {
+        LOCK(cs_askfor);
+        if (mapAskFor.size() > MAPASKFOR_MAX_SZ || setAskFor.size() > SETASKFOR_MAX_SZ)
+            return;
+        // a peer may not have multiple non-responded queue positions for a single inv item
+        if (!setAskFor.insert(inv.hash).second)
+            return;
+    }
+    // EXOSIS END
 
     // We're using mapAskFor as a priority queue,
     // the key is the earliest time the request can be sent
@@ -2993,6 +3003,20 @@ void CNode::AskFor(const CInv& inv)
     mapAskFor.insert(std::make_pair(nRequestTime, inv));
 }
 
+// EXOSIS BEGIN
+void CNode::RemoveAskFor(const uint256& hash)
+{
+    LOCK(cs_askfor);
+    setAskFor.erase(hash);
+}
+
+size_t CNode::GetAskForCount()
+{
+    LOCK(cs_askfor);
+    return setAskFor.size();
+}
+// EXOSIS END
+
 bool CConnman::NodeFullyConnected(const CNode* pnode)
 {
     return pnode && pnode->fSuccessfullyConnected && !pnode->fDisconnect;
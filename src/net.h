@@ -839,7 +839,12 @@ public:
     // and in the order requested.
     std::vector<uint256> vInventoryBlockToSend GUARDED_BY(cs_inventory);
     CCriticalSection cs_inventory;
-    std::set<uint256> setAskFor;
+    // EXOSIS BEGIN
+    //std::set<uint256> setAskFor;
+    // Dash messages are processed off the message handler thread and clear their entries from there
+    CCriticalSection cs_askfor;
+    std::set<uint256> setAskFor GUARDED_BY(cs_askfor);
+    // EXOSIS END
     std::multimap<int64_t, CInv> mapAskFor;
     int64_t nNextInvSend{0};
     // Dash
@@ -998,6 +1003,10 @@ public:
     }
 
     void AskFor(const CInv& inv);
+    // EXOSIS BEGIN
+    void RemoveAskFor(const uint256& hash);
+    size_t GetAskForCount();
+    // EXOSIS END
 
     void CloseSocketDisconnect();
 
@@ -33,7 +33,13 @@
 #include <util/moneystr.h>
 #include <util/strencodings.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 // Dash
 #include <spork.h>
@@ -1103,22 +1109,32 @@ bool static AlreadyHave(const CInv& inv) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
         return instantsend.AlreadyHave(inv.hash);
 
     case MSG_SPORK:
-        return mapSporks.count(inv.hash);
+        // EXOSIS BEGIN
+        //return mapSporks.count(inv.hash);
+        return sporkManager.HasSpork(inv.hash);
+        // EXOSIS END
 
+    // EXOSIS BEGIN
+    // the Dash maps are updated by the message queue workers, only use their locked accessors
     case MSG_MASTERNODE_PAYMENT_VOTE:
-        return mnpayments.mapMasternodePaymentVotes.count(inv.hash);
+        //return mnpayments.mapMasternodePaymentVotes.count(inv.hash);
+        return mnpayments.HasPaymentVote(inv.hash);
 
     case MSG_MASTERNODE_PAYMENT_BLOCK:
         {
             BlockMap::iterator mi = mapBlockIndex.find(inv.hash);
-            return mi != mapBlockIndex.end() && mnpayments.mapMasternodeBlocks.find(mi->second->nHeight) != mnpayments.mapMasternodeBlocks.end();
+            //return mi != mapBlockIndex.end() && mnpayments.mapMasternodeBlocks.find(mi->second->nHeight) != mnpayments.mapMasternodeBlocks.end();
+            return mi != mapBlockIndex.end() && mnpayments.HasPayeesForBlock(mi->second->nHeight);
         }
 
     case MSG_MASTERNODE_ANNOUNCE:
-        return mnodeman.mapSeenMasternodeBroadcast.count(inv.hash) && !mnodeman.IsMnbRecoveryRequested(inv.hash);
+        //return mnodeman.mapSeenMasternodeBroadcast.count(inv.hash) && !mnodeman.IsMnbRecoveryRequested(inv.hash);
+        return mnodeman.HasSeenMasternodeBroadcast(inv.hash) && !mnodeman.IsMnbRecoveryRequested(inv.hash);
 
     case MSG_MASTERNODE_PING:
-        return mnodeman.mapSeenMasternodePing.count(inv.hash);
+        //return mnodeman.mapSeenMasternodePing.count(inv.hash);
+        return mnodeman.HasSeenMasternodePing(inv.hash);
+    // EXOSIS END
 
     case MSG_DSTX: {
         return static_cast<bool>(CPrivateSend::GetDSTX(inv.hash));
@@ -1129,7 +1145,10 @@ bool static AlreadyHave(const CInv& inv) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
         return ! governance.ConfirmInventoryRequest(inv);
 
     case MSG_MASTERNODE_VERIFY:
-        return mnodeman.mapSeenMasternodeVerification.count(inv.hash);
+        // EXOSIS BEGIN
+        //return mnodeman.mapSeenMasternodeVerification.count(inv.hash);
+        return mnodeman.HasSeenMasternodeVerification(inv.hash);
+        // EXOSIS END
     }
     //
 
@@ -1451,20 +1470,34 @@ void static ProcessGetData(CNode* pfrom, const CChainParams& chainparams, CConnm
                 }
 
                 if (!pushed && inv.type == MSG_SPORK) {
-                    if(mapSporks.count(inv.hash)) {
+                    // EXOSIS BEGIN
+                    //if(mapSporks.count(inv.hash)) {
+                    CSporkMessage spork;
+                    if(sporkManager.GetSporkByHash(inv.hash, spork)) {
+                    // EXOSIS END
                         CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
                         ss.reserve(1000);
-                        ss << mapSporks[inv.hash];
+                        // EXOSIS BEGIN
+                        //ss << mapSporks[inv.hash];
+                        ss << spork;
+                        // EXOSIS END
                         connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SPORK, ss));
                         pushed = true;
                     }
                 }
 
                 if (!pushed && inv.type == MSG_MASTERNODE_PAYMENT_VOTE) {
-                    if(mnpayments.HasVerifiedPaymentVote(inv.hash)) {
+                    // EXOSIS BEGIN
+                    //if(mnpayments.HasVerifiedPaymentVote(inv.hash)) {
+                    CMasternodePaymentVote vote;
+                    if(mnpayments.GetPaymentVote(inv.hash, vote) && vote.IsVerified()) {
+                    // EXOSIS END
                         CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
                         ss.reserve(1000);
-                        ss << mnpayments.mapMasternodePaymentVotes[inv.hash];
+                        // EXOSIS BEGIN
+                        //ss << mnpayments.mapMasternodePaymentVotes[inv.hash];
+                        ss << vote;
+                        // EXOSIS END
                         connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MASTERNODEPAYMENTVOTE, ss));
                         pushed = true;
                     }
@@ -1477,10 +1510,17 @@ void static ProcessGetData(CNode* pfrom, const CChainParams& chainparams, CConnm
                         for (CMasternodePayee& payee : mnpayments.mapMasternodeBlocks[mi->second->nHeight].vecPayees) {
                             std::vector<uint256> vecVoteHashes = payee.GetVoteHashes();
                             for (uint256& hash : vecVoteHashes) {
-                                if(mnpayments.HasVerifiedPaymentVote(hash)) {
+                                // EXOSIS BEGIN
+                                //if(mnpayments.HasVerifiedPaymentVote(hash)) {
+                                CMasternodePaymentVote vote;
+                                if(mnpayments.GetPaymentVote(hash, vote) && vote.IsVerified()) {
+                                // EXOSIS END
                                     CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
                                     ss.reserve(1000);
-                                    ss << mnpayments.mapMasternodePaymentVotes[hash];
+                                    // EXOSIS BEGIN
+                                    //ss << mnpayments.mapMasternodePaymentVotes[hash];
+                                    ss << vote;
+                                    // EXOSIS END
                                     connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MASTERNODEPAYMENTVOTE, ss));
                                 }
                             }
@@ -1490,20 +1530,34 @@ void static ProcessGetData(CNode* pfrom, const CChainParams& chainparams, CConnm
                 }
 
                 if (!pushed && inv.type == MSG_MASTERNODE_ANNOUNCE) {
-                    if(mnodeman.mapSeenMasternodeBroadcast.count(inv.hash)){
+                    // EXOSIS BEGIN
+                    //if(mnodeman.mapSeenMasternodeBroadcast.count(inv.hash)){
+                    CMasternodeBroadcast mnb;
+                    if(mnodeman.GetSeenMasternodeBroadcast(inv.hash, mnb)){
+                    // EXOSIS END
                         CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
                         ss.reserve(1000);
-                        ss << mnodeman.mapSeenMasternodeBroadcast[inv.hash].second;
+                        // EXOSIS BEGIN
+                        //ss << mnodeman.mapSeenMasternodeBroadcast[inv.hash].second;
+                        ss << mnb;
+                        // EXOSIS END
                         connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNANNOUNCE, ss));
                         pushed = true;
                     }
                 }
 
                 if (!pushed && inv.type == MSG_MASTERNODE_PING) {
-                    if(mnodeman.mapSeenMasternodePing.count(inv.hash)) {
+                    // EXOSIS BEGIN
+                    //if(mnodeman.mapSeenMasternodePing.count(inv.hash)) {
+                    CMasternodePing mnp;
+                    if(mnodeman.GetSeenMasternodePing(inv.hash, mnp)) {
+                    // EXOSIS END
                         CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
                         ss.reserve(1000);
-                        ss << mnodeman.mapSeenMasternodePing[inv.hash];
+                        // EXOSIS BEGIN
+                        //ss << mnodeman.mapSeenMasternodePing[inv.hash];
+                        ss << mnp;
+                        // EXOSIS END
                         connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNPING, ss));
                         pushed = true;
                     }
@@ -1558,10 +1612,17 @@ void static ProcessGetData(CNode* pfrom, const CChainParams& chainparams, CConnm
                 }
 
                 if (!pushed && inv.type == MSG_MASTERNODE_VERIFY) {
-                    if(mnodeman.mapSeenMasternodeVerification.count(inv.hash)) {
+                    // EXOSIS BEGIN
+                    //if(mnodeman.mapSeenMasternodeVerification.count(inv.hash)) {
+                    CMasternodeVerification mnv;
+                    if(mnodeman.GetSeenMasternodeVerification(inv.hash, mnv)) {
+                    // EXOSIS END
                         CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
                         ss.reserve(1000);
-                        ss << mnodeman.mapSeenMasternodeVerification[inv.hash];
+                        // EXOSIS BEGIN
+                        //ss << mnodeman.mapSeenMasternodeVerification[inv.hash];
+                        ss << mnv;
+                        // EXOSIS END
                         connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::MNVERIFY, ss));
                         pushed = true;
                     }
@@ -1903,6 +1964,417 @@ void static ProcessOrphanTx(CConnman* connman, std::set<uint256>& orphan_work_se
     }
 }
 
+// EXOSIS BEGIN
+namespace {
+
+/** Maximum number of messages a peer may have waiting in the Dash message queues */
+static const size_t MAX_DASH_QUEUE_MESSAGES_PER_PEER = 100;
+/** Maximum size of the messages a peer may have waiting in the Dash message queues */
+static const size_t MAX_DASH_QUEUE_BYTES_PER_PEER = 1000000;
+
+class CDashMessageQueue;
+
+/**
+ * Dash messages of one peer handed to a worker and not finished yet.
+ * They all wait in one queue, the peer's next message for another queue is
+ * held back until they are done so the peer's messages keep their order
+ * (an mnw is never checked before the mnb it refers to).
+ */
+struct CDashPeerPending
+{
+    CDashMessageQueue* pqueue{nullptr};
+    size_t nMessages{0};
+    size_t nBytes{0};
+};
+
+std::mutex csDashPeers;
+std::map<NodeId, CDashPeerPending> mapDashPeers;
+
+/** Account a message handed to queue, its bytes keep counting towards the peer's receive flood size */
+void AddDashMessage(CNode* pnode, CDashMessageQueue* pqueue, size_t nBytes, CConnman* connman)
+{
+    {
+        std::lock_guard<std::mutex> lock(csDashPeers);
+        CDashPeerPending& pending = mapDashPeers[pnode->GetId()];
+        pending.pqueue = pqueue;
+        pending.nMessages++;
+        pending.nBytes += nBytes;
+    }
+    LOCK(pnode->cs_vProcessMsg);
+    pnode->nProcessQueueSize += nBytes;
+    pnode->fPauseRecv = pnode->nProcessQueueSize > connman->GetReceiveFloodSize();
+}
+
+/** Release the accounting of a message once its worker is done with it */
+void FinishDashMessage(CNode* pnode, size_t nBytes, CConnman* connman)
+{
+    {
+        LOCK(pnode->cs_vProcessMsg);
+        pnode->nProcessQueueSize -= nBytes;
+        pnode->fPauseRecv = pnode->nProcessQueueSize > connman->GetReceiveFloodSize();
+    }
+    {
+        std::lock_guard<std::mutex> lock(csDashPeers);
+        auto it = mapDashPeers.find(pnode->GetId());
+        assert(it != mapDashPeers.end() && it->second.nMessages > 0);
+        it->second.nBytes -= nBytes;
+        if (--it->second.nMessages == 0) {
+            mapDashPeers.erase(it);
+        }
+    }
+    // the message handler may be holding this peer's next message back
+    connman->WakeMessageHandler();
+}
+
+/** Registered handler of one Dash-layer command, with its timing counters */
+struct CDashMessageHandler
+{
+    typedef std::function<void(CNode*, CDataStream&, CConnman&)> Function;
+
+    const std::string strCommand;
+    CDashMessageQueue& queue;
+    const Function function;
+
+    std::atomic<uint64_t> nCount{0};
+    std::atomic<int64_t> nTotalMicros{0};
+    std::atomic<int64_t> nMaxMicros{0};
+
+    CDashMessageHandler(const std::string& strCommandIn, CDashMessageQueue& queueIn, Function functionIn) :
+        strCommand(strCommandIn), queue(queueIn), function(functionIn) {}
+
+    void Process(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+    {
+        const int64_t nStart = GetTimeMicros();
+        try {
+            function(pfrom, vRecv, connman);
+        } catch (...) {
+            AddTime(GetTimeMicros() - nStart);
+            throw;
+        }
+        AddTime(GetTimeMicros() - nStart);
+    }
+
+private:
+    void AddTime(int64_t nMicros)
+    {
+        nCount++;
+        nTotalMicros += nMicros;
+        int64_t nMax = nMaxMicros;
+        while (nMicros > nMax && !nMaxMicros.compare_exchange_weak(nMax, nMicros)) {}
+    }
+};
+
+/**
+ * Worker thread processing the Dash-layer messages of one subsystem
+ * (masternodes, governance, ...) off the message handler thread.
+ * Peers are served round-robin, one message at a time, so a peer flooding
+ * one subsystem neither starves other peers nor delays block, header and
+ * transaction processing.
+ */
+class CDashMessageQueue
+{
+private:
+    struct CQueuedMessage
+    {
+        CNode* pnode;
+        CDashMessageHandler* phandler;
+        CDataStream vRecv;
+        size_t nBytes;
+        CConnman* connman;
+
+        CQueuedMessage(CNode* pnodeIn, CDashMessageHandler* phandlerIn, CDataStream&& vRecvIn, size_t nBytesIn, CConnman* connmanIn) :
+            pnode(pnodeIn), phandler(phandlerIn), vRecv(std::move(vRecvIn)), nBytes(nBytesIn), connman(connmanIn) {}
+    };
+
+    const std::string strName;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::map<NodeId, std::deque<CQueuedMessage>> mapPending;
+    // peers with pending messages, in the order they are served
+    std::deque<NodeId> vReadyPeers;
+    size_t nPending;
+    bool fRunning;
+    std::thread thread;
+
+public:
+    explicit CDashMessageQueue(const std::string& strNameIn) :
+        strName(strNameIn), nPending(0), fRunning(false) {}
+
+    const std::string& GetName() const { return strName; }
+
+    void Start()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fRunning) return;
+        fRunning = true;
+        thread = std::thread(&TraceThread<std::function<void()>>, strName.c_str(), std::function<void()>(std::bind(&CDashMessageQueue::ThreadMain, this)));
+    }
+
+    /** Stop the worker and drop the messages still waiting */
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!fRunning) return;
+            fRunning = false;
+        }
+        cond.notify_all();
+        thread.join();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& pair : mapPending) {
+            for (CQueuedMessage& msg : pair.second) {
+                FinishDashMessage(msg.pnode, msg.nBytes, msg.connman);
+                msg.pnode->Release();
+            }
+        }
+        mapPending.clear();
+        vReadyPeers.clear();
+        nPending = 0;
+    }
+
+    /** Hand a message over to the worker, false if it is not running and the caller has to process it */
+    bool Push(CNode* pnode, CDashMessageHandler* phandler, CDataStream& vRecv, CConnman* connman)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!fRunning) return false;
+            const size_t nBytes = vRecv.size() + CMessageHeader::HEADER_SIZE;
+            AddDashMessage(pnode, this, nBytes, connman);
+            std::deque<CQueuedMessage>& vPeerMessages = mapPending[pnode->GetId()];
+            if (vPeerMessages.empty()) {
+                vReadyPeers.push_back(pnode->GetId());
+            }
+            vPeerMessages.emplace_back(pnode->AddRef(), phandler, std::move(vRecv), nBytes, connman);
+            nPending++;
+        }
+        cond.notify_one();
+        return true;
+    }
+
+    size_t GetPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return nPending;
+    }
+
+private:
+    void ThreadMain()
+    {
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this] { return !fRunning || !vReadyPeers.empty(); });
+            if (!fRunning) return;
+
+            const NodeId nodeid = vReadyPeers.front();
+            vReadyPeers.pop_front();
+            auto it = mapPending.find(nodeid);
+            CQueuedMessage msg(std::move(it->second.front()));
+            it->second.pop_front();
+            nPending--;
+            if (it->second.empty()) {
+                mapPending.erase(it);
+            } else {
+                vReadyPeers.push_back(nodeid);
+            }
+            lock.unlock();
+
+            Process(msg);
+            FinishDashMessage(msg.pnode, msg.nBytes, msg.connman);
+            msg.pnode->Release();
+        }
+    }
+
+    void Process(CQueuedMessage& msg)
+    {
+        if (msg.pnode->fDisconnect) return;
+        try {
+            msg.phandler->Process(msg.pnode, msg.vRecv, *msg.connman);
+        } catch (const std::ios_base::failure& e) {
+            LogPrint(BCLog::NET, "%s(%s, %u bytes): Exception '%s' caught in %s\n", __func__, SanitizeString(msg.phandler->strCommand), msg.vRecv.size(), e.what(), strName);
+        } catch (const std::exception& e) {
+            PrintExceptionContinue(&e, "CDashMessageQueue::Process()");
+        } catch (...) {
+            PrintExceptionContinue(nullptr, "CDashMessageQueue::Process()");
+        }
+    }
+};
+
+CDashMessageQueue dashQueuePrivateSend("dsqueue");
+CDashMessageQueue dashQueueMasternodes("mnqueue");
+CDashMessageQueue dashQueuePayments("mnpqueue");
+CDashMessageQueue dashQueueInstantSend("isqueue");
+CDashMessageQueue dashQueueSporks("sporkqueue");
+CDashMessageQueue dashQueueSync("mnsqueue");
+CDashMessageQueue dashQueueGovernance("govqueue");
+
+CDashMessageQueue* const vDashQueues[] = {
+    &dashQueuePrivateSend, &dashQueueMasternodes, &dashQueuePayments, &dashQueueInstantSend,
+    &dashQueueSporks, &dashQueueSync, &dashQueueGovernance,
+};
+
+/** Dispatch table from Dash-layer command to the single handler processing it */
+class CDashMessageDispatcher
+{
+private:
+    std::map<std::string, std::unique_ptr<CDashMessageHandler>> mapHandlers;
+
+public:
+    void Register(const std::string& strCommand, CDashMessageQueue& queue, CDashMessageHandler::Function function)
+    {
+        bool fInserted = mapHandlers.emplace(strCommand, MakeUnique<CDashMessageHandler>(strCommand, queue, function)).second;
+        assert(fInserted);
+    }
+
+    CDashMessageHandler* Get(const std::string& strCommand) const
+    {
+        auto it = mapHandlers.find(strCommand);
+        return it == mapHandlers.end() ? nullptr : it->second.get();
+    }
+
+    const std::map<std::string, std::unique_ptr<CDashMessageHandler>>& GetHandlers() const { return mapHandlers; }
+};
+
+void RegisterDashMessageHandlers(CDashMessageDispatcher& dispatcher)
+{
+    // masternodes relay queues, clients join them
+    dispatcher.Register(NetMsgType::DSQUEUE, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        if (fMasterNode) {
+            privateSendServer.ProcessQueueMessage(pfrom, vRecv, connman);
+            return;
+        }
+#ifdef ENABLE_WALLET
+        privateSendClient.ProcessQueueMessage(pfrom, vRecv, connman);
+#endif // ENABLE_WALLET
+    });
+    dispatcher.Register(NetMsgType::DSACCEPT, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        privateSendServer.ProcessAcceptMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::DSVIN, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        privateSendServer.ProcessVinMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::DSSIGNFINALTX, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        privateSendServer.ProcessSignFinalTxMessage(pfrom, vRecv, connman);
+    });
+#ifdef ENABLE_WALLET
+    dispatcher.Register(NetMsgType::DSCOMPLETE, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        privateSendClient.ProcessCompleteMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::DSFINALTX, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        privateSendClient.ProcessFinalTxMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::DSSTATUSUPDATE, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        privateSendClient.ProcessStatusUpdateMessage(pfrom, vRecv, connman);
+    });
+#else
+    // still registered so they are consumed instead of reaching the unknown command path
+    for (const char* pszCommand : {NetMsgType::DSCOMPLETE, NetMsgType::DSFINALTX, NetMsgType::DSSTATUSUPDATE}) {
+        dispatcher.Register(pszCommand, dashQueuePrivateSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {});
+    }
+#endif // ENABLE_WALLET
+    dispatcher.Register(NetMsgType::MNANNOUNCE, dashQueueMasternodes, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        mnodeman.ProcessAnnounceMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::MNPING, dashQueueMasternodes, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        mnodeman.ProcessPingMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::DSEG, dashQueueMasternodes, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        mnodeman.ProcessDsegMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::MNVERIFY, dashQueueMasternodes, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        mnodeman.ProcessVerifyMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::MASTERNODEPAYMENTSYNC, dashQueuePayments, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        mnpayments.ProcessPaymentSyncMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::MASTERNODEPAYMENTVOTE, dashQueuePayments, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        mnpayments.ProcessPaymentVoteMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::TXLOCKVOTE, dashQueueInstantSend, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        instantsend.ProcessTxLockVoteMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::SPORK, dashQueueSporks, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        sporkManager.ProcessSporkMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::GETSPORKS, dashQueueSporks, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        sporkManager.ProcessGetSporksMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::SYNCSTATUSCOUNT, dashQueueSync, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        masternodeSync.ProcessSyncStatusCountMessage(pfrom, vRecv);
+    });
+    dispatcher.Register(NetMsgType::MNGOVERNANCEOBJECT, dashQueueGovernance, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        governance.ProcessObjectMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::MNGOVERNANCEOBJECTVOTE, dashQueueGovernance, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        governance.ProcessObjectVoteMessage(pfrom, vRecv, connman);
+    });
+    dispatcher.Register(NetMsgType::MNGOVERNANCESYNC, dashQueueGovernance, [](CNode* pfrom, CDataStream& vRecv, CConnman& connman) {
+        governance.ProcessSyncMessage(pfrom, vRecv, connman);
+    });
+}
+
+const CDashMessageDispatcher& GetDashMessageDispatcher()
+{
+    static const CDashMessageDispatcher dispatcher = [] {
+        CDashMessageDispatcher dispatcherInit;
+        RegisterDashMessageHandlers(dispatcherInit);
+        return dispatcherInit;
+    }();
+    return dispatcher;
+}
+
+/**
+ * Whether the peer's next message has to wait for its Dash messages in the queues,
+ * because they are in another queue or the peer already has too many waiting
+ */
+bool IsDashMessageHeld(NodeId nodeid, const std::string& strCommand, size_t nBytes)
+{
+    CDashMessageHandler* phandler = GetDashMessageDispatcher().Get(strCommand);
+    if (!phandler) return false;
+    std::lock_guard<std::mutex> lock(csDashPeers);
+    auto it = mapDashPeers.find(nodeid);
+    if (it == mapDashPeers.end()) return false;
+    const CDashPeerPending& pending = it->second;
+    return pending.pqueue != &phandler->queue || pending.nMessages >= MAX_DASH_QUEUE_MESSAGES_PER_PEER ||
+           pending.nBytes + nBytes > MAX_DASH_QUEUE_BYTES_PER_PEER;
+}
+
+} // namespace
+
+void StartDashMessageQueues()
+{
+    // build the dispatch table before the first message arrives
+    GetDashMessageDispatcher();
+    for (CDashMessageQueue* pqueue : vDashQueues) {
+        pqueue->Start();
+    }
+}
+
+void StopDashMessageQueues()
+{
+    for (CDashMessageQueue* pqueue : vDashQueues) {
+        pqueue->Stop();
+    }
+}
+
+void GetDashMessageStats(std::vector<CDashMessageStats>& vStats)
+{
+    vStats.clear();
+    for (const auto& pair : GetDashMessageDispatcher().GetHandlers()) {
+        const CDashMessageHandler& handler = *pair.second;
+        CDashMessageStats stats;
+        stats.strCommand = handler.strCommand;
+        stats.strQueue = handler.queue.GetName();
+        stats.nQueuePending = handler.queue.GetPendingCount();
+        stats.nCount = handler.nCount;
+        stats.nTotalMicros = handler.nTotalMicros;
+        stats.nMaxMicros = handler.nMaxMicros;
+        vStats.push_back(stats);
+    }
+}
+// EXOSIS END
+
 bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman* connman, const std::atomic<bool>& interruptMsgProc, bool enable_bip61)
 {
     LogPrint(BCLog::NET, "received: %s (%u bytes) peer=%d\n", SanitizeString(strCommand), vRecv.size(), pfrom->GetId());
@@ -2584,7 +3056,10 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         bool fMissingInputs = false;
         CValidationState state;
 
-        pfrom->setAskFor.erase(inv.hash);
+        // EXOSIS BEGIN
+        //pfrom->setAskFor.erase(inv.hash);
+        pfrom->RemoveAskFor(inv.hash);
+        // EXOSIS END
         mapAlreadyAskedFor.erase(inv.hash);
         // Dash
         // Process custom logic, no matter if tx will be accepted to mempool later or not
@@ -3326,38 +3801,17 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         // message would be undesirable as we transmit it ourselves.
         return true;
     }
-    else
-    {
-        // Dash
-        bool found = false;
-        const std::vector<std::string> &allMessages = getAllNetMessageTypes();
-        for (const std::string msg : allMessages) {
-            if(msg == strCommand) {
-                found = true;
-                break;
-            }
-        }
-
-        if (found)
-        {
-            //probably one the extensions
-#ifdef ENABLE_WALLET
-            privateSendClient.ProcessMessage(pfrom, strCommand, vRecv, *connman);
-#endif // ENABLE_WALLET
-            privateSendServer.ProcessMessage(pfrom, strCommand, vRecv, *connman);
-            mnodeman.ProcessMessage(pfrom, strCommand, vRecv, *connman);
-            mnpayments.ProcessMessage(pfrom, strCommand, vRecv, *connman);
-            instantsend.ProcessMessage(pfrom, strCommand, vRecv, *connman);
-            sporkManager.ProcessSpork(pfrom, strCommand, vRecv, *connman);
-            masternodeSync.ProcessMessage(pfrom, strCommand, vRecv);
-            governance.ProcessMessage(pfrom, strCommand, vRecv, *connman);
 
-            return true;
-        }
-        //
+    // EXOSIS BEGIN
     // Dash
+    CDashMessageHandler* phandler = GetDashMessageDispatcher().Get(strCommand);
+    if (phandler) {
+        if (!phandler->queue.Push(pfrom, phandler, vRecv, connman)) {
+            phandler->Process(pfrom, vRecv, *connman);
+        }
+        return true;
     }
-    //
+    // EXOSIS END
 
     // Ignore unknown commands for extensibility
     LogPrint(BCLog::NET, "Unknown command \"%s\" from peer=%d\n", SanitizeString(strCommand), pfrom->GetId());
@@ -3439,6 +3893,13 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
         LOCK(pfrom->cs_vProcessMsg);
         if (pfrom->vProcessMsg.empty())
             return false;
+        // EXOSIS BEGIN
+        // Leave the message where it is while it has to wait for the peer's
+        // Dash messages in the queues, the workers wake us up again
+        const CNetMessage& msgNext = pfrom->vProcessMsg.front();
+        if (IsDashMessageHeld(pfrom->GetId(), msgNext.hdr.GetCommand(), msgNext.vRecv.size() + CMessageHeader::HEADER_SIZE))
+            return false;
+        // EXOSIS END
         // Just take one message
         msgs.splice(msgs.begin(), pfrom->vProcessMsg, pfrom->vProcessMsg.begin());
         pfrom->nProcessQueueSize -= msgs.front().vRecv.size() + CMessageHeader::HEADER_SIZE;
@@ -4259,7 +4720,10 @@ bool PeerLogicValidation::SendMessages(CNode* pto)
             } else {
                 //If we're not going to ask, don't expect a response.
                 LogPrint(BCLog::NET, "Request already have inv = %s peer=%d\n", inv.ToString(), pto->GetId());
-                pto->setAskFor.erase(inv.hash);
+                // EXOSIS BEGIN
+                //pto->setAskFor.erase(inv.hash);
+                pto->RemoveAskFor(inv.hash);
+                // EXOSIS END
             }
             pto->mapAskFor.erase(pto->mapAskFor.begin());
         }
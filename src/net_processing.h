@@ -92,4 +92,23 @@ struct CNodeStateStats {
 /** Get statistics from node state */
 bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats);
 
+// EXOSIS BEGIN
+/** Start the worker threads processing Dash-layer messages */
+void StartDashMessageQueues();
+/** Stop the Dash-layer message workers, messages received afterwards are processed inline */
+void StopDashMessageQueues();
+
+struct CDashMessageStats {
+    std::string strCommand;
+    std::string strQueue;
+    size_t nQueuePending;
+    uint64_t nCount;
+    int64_t nTotalMicros;
+    int64_t nMaxMicros;
+};
+
+/** Get processing statistics of every registered Dash-layer command */
+void GetDashMessageStats(std::vector<CDashMessageStats>& vStats);
+// EXOSIS END
+
 #endif // BITCOIN_NET_PROCESSING_H
@@ -15,13 +15,68 @@
 #include <primitives/block.h>
 #include <uint256.h>
 
-unsigned int static DarkGravityWave(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params) {
-    if (params.fPowNoRetargeting)
-        return pindexLast->nBits;
+#include <algorithm>
+#include <mutex>
 
-    // block spacing fix active
-    const bool fFix = (pindexLast->nHeight >= sporkManager.GetSporkValue(SPORK_EXOSIS_05_FIX_HEIGHT));
+// EXOSIS BEGIN
+namespace {
+/**
+ * Normalized DarkGravityWave targets of recently seen parents. The result only depends on
+ * the parent's ancestry, the algo and the fork state, so block templates and validation of
+ * a just accepted header find the window already averaged.
+ */
+class CDarkGravityWaveCache
+{
+private:
+    struct Entry {
+        uint256 hashBlock;
+        const Consensus::Params* params;
+        int32_t nVersion;
+        bool fFix;
+        bool fEnoughBlocks;
+        arith_uint256 bnTarget;
+    };
+
+    static const size_t SIZE = 8;
+
+    std::mutex mutex;
+    Entry entries[SIZE];
+    size_t nEntries = 0;
+    size_t nNext = 0;
+
+public:
+    bool Get(const uint256& hashBlock, const Consensus::Params& params, int32_t nVersion, bool fFix, bool& fEnoughBlocks, arith_uint256& bnTarget)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < nEntries; i++) {
+            const Entry& entry = entries[i];
+            if (entry.hashBlock == hashBlock && entry.params == &params && entry.nVersion == nVersion && entry.fFix == fFix) {
+                fEnoughBlocks = entry.fEnoughBlocks;
+                bnTarget = entry.bnTarget;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Put(const uint256& hashBlock, const Consensus::Params& params, int32_t nVersion, bool fFix, bool fEnoughBlocks, const arith_uint256& bnTarget)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[nNext] = Entry{hashBlock, &params, nVersion, fFix, fEnoughBlocks, bnTarget};
+        nNext = (nNext + 1) % SIZE;
+        nEntries = std::max(nEntries, nNext == 0 ? SIZE : nNext);
+    }
+};
 
+CDarkGravityWaveCache dgwCache;
+} // namespace
+
+/**
+ * Averaged and retargeted target for the block after pindexLast, normalized by algo efficiency.
+ * Returns false when the chain is still too short for the averages.
+ */
+static bool DarkGravityWaveTarget(const CBlockIndex* pindexLast, int32_t nVersion, bool fFix, const Consensus::Params& params, arith_uint256& bnNew)
+{
     const arith_uint256 bnPowLimit = UintToArith256(params.powLimit);
 
     const int64_t nPastAlgoFastBlocks = 5; // fast average for algo
@@ -40,7 +95,7 @@ unsigned int static DarkGravityWave(const CBlockIndex* pindexLast, const CBlockH
     // make sure we have at least ALGO_ACTIVE_COUNT blocks, otherwise just return powLimit
     if (!pindexLast || pindexLast->nHeight < nPastBlocks) {
         if (pindexLast->nHeight < nPastAlgoBlocks)
-            return bnPowLimit.GetCompact();
+            return false;
         else
             nPastBlocks = pindexLast->nHeight;
     }
@@ -56,8 +111,7 @@ unsigned int static DarkGravityWave(const CBlockIndex* pindexLast, const CBlockH
     arith_uint256 bnPastAlgoTargetAvg(0);
     arith_uint256 bnPastAlgoTargetAvgFast(0);
 
-    // count blocks mined by actual algo for secondary average
-    int32_t nVersion = pblock->nVersion & ALGO_VERSION_MASK;
+    // count blocks mined by actual algo (nVersion) for secondary average
 
     unsigned int nCountBlocks = 0;
     unsigned int nCountFastBlocks = 0;
@@ -65,7 +119,7 @@ unsigned int static DarkGravityWave(const CBlockIndex* pindexLast, const CBlockH
     unsigned int nCountAlgoFastBlocks = 0;
 
     while (nCountBlocks < nPastBlocks && nCountAlgoBlocks < nPastAlgoBlocks) {
-        arith_uint256 bnTarget = arith_uint256().SetCompact(pindex->nBits) / pindex->GetBlockHeader().GetAlgoEfficiency(pindex->nHeight); // convert to normalized target by algo efficiency
+        arith_uint256 bnTarget = arith_uint256().SetCompact(pindex->nBits) / CBlockHeader::GetAlgoEfficiency(pindex->nVersion, pindex->nHeight); // convert to normalized target by algo efficiency
 
         // calculate algo average
         if (nVersion == (pindex->nVersion & ALGO_VERSION_MASK))
@@ -114,7 +168,7 @@ unsigned int static DarkGravityWave(const CBlockIndex* pindexLast, const CBlockH
         bnPastTargetAvg = bnPastTargetAvgFast;
     }
 
-    arith_uint256 bnNew(bnPastTargetAvg);
+    bnNew = bnPastTargetAvg;
 
     if (pindexAlgo && pindexAlgoLast && nCountAlgoBlocks > 1)
     {
@@ -160,6 +214,30 @@ unsigned int static DarkGravityWave(const CBlockIndex* pindexLast, const CBlockH
     bnNew *= nActualTimespan;
     bnNew /= nTargetTimespan;
 
+    return true;
+}
+
+static unsigned int DarkGravityWave(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params) {
+    if (params.fPowNoRetargeting)
+        return pindexLast->nBits;
+
+    // block spacing fix active
+    const bool fFix = (pindexLast->nHeight >= sporkManager.GetSporkValue(SPORK_EXOSIS_05_FIX_HEIGHT));
+
+    const arith_uint256 bnPowLimit = UintToArith256(params.powLimit);
+
+    const int32_t nVersion = pblock->nVersion & ALGO_VERSION_MASK;
+    bool fEnoughBlocks;
+    arith_uint256 bnNew;
+    // Block indexes without a hash are only built by tests, never cache those
+    if (!pindexLast->phashBlock || !dgwCache.Get(pindexLast->GetBlockHash(), params, nVersion, fFix, fEnoughBlocks, bnNew)) {
+        fEnoughBlocks = DarkGravityWaveTarget(pindexLast, nVersion, fFix, params, bnNew);
+        if (pindexLast->phashBlock)
+            dgwCache.Put(pindexLast->GetBlockHash(), params, nVersion, fFix, fEnoughBlocks, bnNew);
+    }
+    if (!fEnoughBlocks)
+        return bnPowLimit.GetCompact();
+
     // at least PoW limit
     if ((bnPowLimit / pblock->GetAlgoEfficiency(pindexLast->nHeight+1)) > bnNew)
         bnNew *= pblock->GetAlgoEfficiency(pindexLast->nHeight+1); // convert normalized target to actual algo target
@@ -174,6 +252,7 @@ unsigned int static DarkGravityWave(const CBlockIndex* pindexLast, const CBlockH
 
     return bnNew.GetCompact();
 }
+// EXOSIS END
 
 unsigned int GetNextWorkRequiredBTC(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params)
 {
@@ -22,7 +22,15 @@ uint256 CBlockHeader::GetHash() const
 {
     // EXOSIS BEGIN
     //return SerializeHash(*this);
-    return HashTimeTravel(BEGIN(nVersion), END(nNonce), GetBlockTime()); //TimeTravel
+    static_assert(offsetof(CBlockHeader, nNonce) + sizeof(uint32_t) - offsetof(CBlockHeader, nVersion) == CBlockHeaderHashCache::HEADER_SIZE, "header fields must be contiguous");
+
+    uint256 hash;
+    if (hashCache.Get(BEGIN(nVersion), hash)) {
+        return hash;
+    }
+    hash = HashTimeTravel(BEGIN(nVersion), END(nNonce), GetBlockTime()); //TimeTravel
+    hashCache.Set(BEGIN(nVersion), hash);
+    return hash;
     // EXOSIS END
 }
 
@@ -34,15 +42,61 @@ uint256 CBlockHeader::GetPoWHash() const
     switch (nVersion & ALGO_VERSION_MASK)
     {
         case ALGO_EXOSIS:  powHash = GetHash(); break;
-        case ALGO_X16R:    powHash = HashX16R(BEGIN(nVersion), END(nNonce), hashPrevBlock); break;
+        case ALGO_X16R:    powHash = X16RHasher(hashPrevBlock).Hash(BEGIN(nVersion), END(nNonce)); break;
         default:           break; // EXOSIS TODO: we should not be here
     }
 
     return powHash;
 }
+
+uint256 CBlockHeader::GetPoWHash(const X16RHasher& hasher) const
+{
+    assert(hasher.GetPrevBlockHash() == hashPrevBlock);
+
+    uint256 powHash = uint256S("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+
+    switch (nVersion & ALGO_VERSION_MASK)
+    {
+        case ALGO_EXOSIS:  powHash = GetHash(); break;
+        case ALGO_X16R:    powHash = hasher.Hash(BEGIN(nVersion), END(nNonce)); break;
+        default:           break; // EXOSIS TODO: we should not be here
+    }
+
+    return powHash;
+}
+
+void CBlockHeader::GetPoWHashes(const X16RHasher& hasher, uint256 powHashes[]) const
+{
+    assert(hasher.GetPrevBlockHash() == hashPrevBlock);
+
+    if ((nVersion & ALGO_VERSION_MASK) != ALGO_X16R) {
+        CBlockHeader header(*this);
+        for (int lane = 0; lane < X16R_LANES; lane++) {
+            header.nNonce = nNonce + lane;
+            powHashes[lane] = header.GetPoWHash(hasher);
+        }
+        return;
+    }
+
+    unsigned char vchHeaders[X16R_LANES][CBlockHeaderHashCache::HEADER_SIZE];
+    const unsigned char* pinputs[X16R_LANES];
+    for (int lane = 0; lane < X16R_LANES; lane++) {
+        memcpy(vchHeaders[lane], BEGIN(nVersion), CBlockHeaderHashCache::HEADER_SIZE);
+        WriteLE32(vchHeaders[lane] + CBlockHeaderHashCache::HEADER_SIZE - sizeof(uint32_t), nNonce + lane);
+        pinputs[lane] = vchHeaders[lane];
+    }
+    hasher.HashLanes(pinputs, CBlockHeaderHashCache::HEADER_SIZE, powHashes);
+}
 // EXOSIS END
 
+// EXOSIS BEGIN
 unsigned int CBlockHeader::GetAlgoEfficiency(int nBlockHeight) const
+{
+    return GetAlgoEfficiency(nVersion, nBlockHeight);
+}
+
+unsigned int CBlockHeader::GetAlgoEfficiency(int32_t nVersion, int nBlockHeight)
+// EXOSIS END
 {
     switch (nVersion & ALGO_VERSION_MASK)
     {
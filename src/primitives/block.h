@@ -13,6 +13,9 @@
 #include <serialize.h>
 #include <uint256.h>
 
+#include <mutex>
+#include <string.h>
+
 // EXOSIS BEGIN
 // Algo number in nVersion
 enum {
@@ -25,6 +28,62 @@ enum {
 };
 
 const unsigned int ALGO_ACTIVE_COUNT = 1; // X16R only
+
+class X16RHasher;
+
+/** Memory only cache of a block header's TimeTravel hash.
+ *
+ * CBlockHeader exposes its fields publicly, so instead of tracking every write
+ * the cache remembers the header bytes the hash was computed from and is only
+ * used while they still match. Copies carry the cached hash along.
+ */
+class CBlockHeaderHashCache
+{
+public:
+    //! Size of the header fields covered by the hash (nVersion .. nNonce)
+    static const size_t HEADER_SIZE = 80;
+
+    CBlockHeaderHashCache() : fValid(false) {}
+
+    CBlockHeaderHashCache(const CBlockHeaderHashCache& other) : fValid(false)
+    {
+        *this = other;
+    }
+
+    CBlockHeaderHashCache& operator=(const CBlockHeaderHashCache& other)
+    {
+        if (this == &other) return *this;
+        std::lock(mutex, other.mutex);
+        std::lock_guard<std::mutex> lock(mutex, std::adopt_lock);
+        std::lock_guard<std::mutex> lockOther(other.mutex, std::adopt_lock);
+        fValid = other.fValid;
+        memcpy(vchHeader, other.vchHeader, HEADER_SIZE);
+        hash = other.hash;
+        return *this;
+    }
+
+    bool Get(const char* pheader, uint256& hashOut) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!fValid || memcmp(vchHeader, pheader, HEADER_SIZE) != 0) return false;
+        hashOut = hash;
+        return true;
+    }
+
+    void Set(const char* pheader, const uint256& hashIn) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        memcpy(vchHeader, pheader, HEADER_SIZE);
+        hash = hashIn;
+        fValid = true;
+    }
+
+private:
+    mutable std::mutex mutex;
+    mutable bool fValid;
+    mutable char vchHeader[HEADER_SIZE];
+    mutable uint256 hash;
+};
 // EXOSIS END
 
 /** Nodes collect new transactions into a block, hash them into a hash tree,
@@ -46,6 +105,9 @@ public:
     uint32_t nNonce;
     // EXOSIS BEGIN
     uint64_t nMoneySupply;
+
+    // memory only
+    CBlockHeaderHashCache hashCache;
     // EXOSIS END
 
     CBlockHeader()
@@ -86,7 +148,18 @@ public:
 
     uint256 GetPoWHash() const;
 
+    // EXOSIS BEGIN
+    //! Same as GetPoWHash(), reusing a hasher prepared for hashPrevBlock (e.g. while grinding nonces)
+    uint256 GetPoWHash(const X16RHasher& hasher) const;
+    //! Proof-of-work hashes of this header with nonces nNonce to nNonce + X16R_LANES - 1
+    void GetPoWHashes(const X16RHasher& hasher, uint256 powHashes[]) const;
+    // EXOSIS END
+
     unsigned int GetAlgoEfficiency(int nBlockHeight) const;
+    // EXOSIS BEGIN
+    //! Same as GetAlgoEfficiency() for a header of the given version, e.g. from a CBlockIndex
+    static unsigned int GetAlgoEfficiency(int32_t nVersion, int nBlockHeight);
+    // EXOSIS END
 
     int64_t GetBlockTime() const
     {
@@ -145,17 +218,10 @@ public:
 
     CBlockHeader GetBlockHeader() const
     {
-        CBlockHeader block;
-        block.nVersion       = nVersion;
-        block.hashPrevBlock  = hashPrevBlock;
-        block.hashMerkleRoot = hashMerkleRoot;
-        block.nTime          = nTime;
-        block.nBits          = nBits;
-        block.nNonce         = nNonce;
         // EXOSIS BEGIN
-        block.nMoneySupply   = nMoneySupply;
+        // Copy the header fields together with the cached hash
+        return *this;
         // EXOSIS END
-        return block;
     }
 
     std::string ToString() const;
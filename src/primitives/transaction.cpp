@@ -12,6 +12,10 @@
 #include <tinyformat.h>
 #include <util/strencodings.h>
 
+// EXOSIS BEGIN
+#include <string.h>
+// EXOSIS END
+
 std::string COutPoint::ToString() const
 {
     return strprintf("COutPoint(%s, %u)", hash.ToString().substr(0,10), n);
@@ -57,7 +61,6 @@ CTxOut::CTxOut(const CAmount& nValueIn, CScript scriptPubKeyIn)
 {
     nValue = nValueIn;
     scriptPubKey = scriptPubKeyIn;
-    nRounds = -10;
 }
 
 // EXOSIS BEGIN
@@ -65,9 +68,72 @@ CTxOut::CTxOut(const CAmount& nValueIn, CScript scriptPubKeyIn, std::string mast
 {
     nValue = nValueIn;
     scriptPubKey = scriptPubKeyIn;
-    masternodeIP = masternodeIPIn;
-    pubKeyMN = pubKeyMNIn;
-    nRounds = -10;
+    SetMasternodeData(masternodeIPIn, pubKeyMNIn);
+}
+
+CTxOut::CTxOut(const CTxOut& other) : nValue(other.nValue), scriptPubKey(other.scriptPubKey)
+{
+    if (other.extension)
+        extension.reset(new CTxOutExtension(*other.extension));
+}
+
+CTxOut& CTxOut::operator=(const CTxOut& other)
+{
+    nValue = other.nValue;
+    scriptPubKey = other.scriptPubKey;
+    if (other.extension)
+        SetExtension(*other.extension);
+    else
+        extension.reset();
+    return *this;
+}
+
+void CTxOut::SetExtension(const CTxOutExtension& extensionIn)
+{
+    if (extensionIn.IsNull())
+        extension.reset();
+    else if (extension)
+        *extension = extensionIn;
+    else
+        extension.reset(new CTxOutExtension(extensionIn));
+}
+
+const std::string& CTxOut::GetMasternodeIP() const
+{
+    static const std::string strEmpty;
+    return extension ? extension->masternodeIP : strEmpty;
+}
+
+const CPubKey& CTxOut::GetPubKeyMN() const
+{
+    static const CPubKey pubKeyEmpty;
+    return extension ? extension->pubKeyMN : pubKeyEmpty;
+}
+
+void CTxOut::SetMasternodeData(const std::string& masternodeIPIn, const CPubKey& pubKeyMNIn)
+{
+    CTxOutExtension extensionNew;
+    extensionNew.masternodeIP = masternodeIPIn;
+    extensionNew.pubKeyMN = pubKeyMNIn;
+    extensionNew.nRounds = GetRounds();
+    SetExtension(extensionNew);
+}
+
+void CTxOut::SetRounds(int nRoundsIn)
+{
+    CTxOutExtension extensionNew = extension ? *extension : CTxOutExtension();
+    extensionNew.nRounds = nRoundsIn;
+    SetExtension(extensionNew);
+}
+
+bool CTxOut::IsScriptWithoutMasternodeData(const CScript& scriptPubKey)
+{
+    // 76a9142512f68cb0d161dee3c70f66caf6ba3ce8bb4e2788ac, 100000 coin outputs to it never carry masternode data
+    static const unsigned char script[] = {
+        0x76, 0xa9, 0x14, 0x25, 0x12, 0xf6, 0x8c, 0xb0, 0xd1, 0x61, 0xde, 0xe3, 0xc7,
+        0x0f, 0x66, 0xca, 0xf6, 0xba, 0x3c, 0xe8, 0xbb, 0x4e, 0x27, 0x88, 0xac
+    };
+    return scriptPubKey.size() == sizeof(script) && memcmp(scriptPubKey.data(), script, sizeof(script)) == 0;
 }
 // EXOSIS END
 
@@ -75,7 +141,7 @@ std::string CTxOut::ToString() const
 {
     // EXOSIS BEGIN
     //return strprintf("CTxOut(nValue=%d.%08d, scriptPubKey=%s)", nValue / COIN, nValue % COIN, HexStr(scriptPubKey).substr(0, 30));
-    return strprintf("CTxOut(nValue=%d.%08d, scriptPubKey=%s, masternodeIP=%s, pubKeyMN=%s)", nValue / COIN, nValue % COIN, HexStr(scriptPubKey).substr(0, 30), masternodeIP, HexStr(pubKeyMN));
+    return strprintf("CTxOut(nValue=%d.%08d, scriptPubKey=%s, masternodeIP=%s, pubKeyMN=%s)", nValue / COIN, nValue % COIN, HexStr(scriptPubKey).substr(0, 30), GetMasternodeIP(), HexStr(GetPubKeyMN()));
     // EXOSIS END
 }
 
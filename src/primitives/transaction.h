@@ -19,6 +19,10 @@
 #include <serialize.h>
 #include <uint256.h>
 
+// EXOSIS BEGIN
+#include <memory>
+// EXOSIS END
+
 static const int SERIALIZE_TRANSACTION_NO_WITNESS = 0x40000000;
 
 /** An outpoint - a combination of a transaction hash and an index n into its vout */
@@ -140,6 +144,24 @@ public:
     std::string ToString() const;
 };
 
+// EXOSIS BEGIN
+/** Output data used by few outputs only (masternode collaterals, mixed denominations) */
+struct CTxOutExtension
+{
+    std::string masternodeIP;
+    CPubKey pubKeyMN;
+
+    // Dash
+    int nRounds = -10; // an initial value, should be no way to get this by calculations
+    //
+
+    bool IsNull() const
+    {
+        return masternodeIP.empty() && !pubKeyMN.size() && nRounds == -10;
+    }
+};
+// EXOSIS END
+
 /** An output of a transaction.  It contains the public key that the next input
  * must be able to sign with to claim it.
  */
@@ -149,15 +171,15 @@ public:
     CAmount nValue;
     CScript scriptPubKey;
 
+private:
     // EXOSIS BEGIN
-    std::string masternodeIP;
-    CPubKey pubKeyMN;
-    // EXOSIS END
+    // Allocated only while some of its fields differ from their defaults
+    std::unique_ptr<CTxOutExtension> extension;
 
-    // Dash
-    int nRounds;
-    //
+    void SetExtension(const CTxOutExtension& extensionIn);
+    // EXOSIS END
 
+public:
     CTxOut()
     {
         SetNull();
@@ -166,6 +188,38 @@ public:
     CTxOut(const CAmount& nValueIn, CScript scriptPubKeyIn);
     // EXOSIS BEGIN
     CTxOut(const CAmount& nValueIn, CScript scriptPubKeyIn, std::string masternodeIP, CPubKey pubKeyMN);
+
+    CTxOut(const CTxOut& other);
+    CTxOut(CTxOut&& other) = default;
+    CTxOut& operator=(const CTxOut& other);
+    CTxOut& operator=(CTxOut&& other) = default;
+
+    const CTxOutExtension* GetExtension() const { return extension.get(); }
+
+    const std::string& GetMasternodeIP() const;
+    const CPubKey& GetPubKeyMN() const;
+    void SetMasternodeData(const std::string& masternodeIP, const CPubKey& pubKeyMN);
+
+    int GetRounds() const { return extension ? extension->nRounds : -10; }
+    void SetRounds(int nRounds);
+
+    /** Whether an output of nValue to scriptPubKey (de)serializes masternodeIP and pubKeyMN */
+    static bool HasMasternodeData(const CAmount& nValue, const CScript& scriptPubKey)
+    {
+        return nValue == 100000 * COIN && !IsScriptWithoutMasternodeData(scriptPubKey);
+    }
+    static bool IsScriptWithoutMasternodeData(const CScript& scriptPubKey);
+
+    /** (Un)serialize the masternode collateral data, shared with CTxOutCompressor */
+    template <typename Stream, typename Operation>
+    inline void SerializationOpMasternodeData(Stream& s, Operation ser_action) {
+        std::string masternodeIP = GetMasternodeIP();
+        CPubKey pubKeyMN = GetPubKeyMN();
+        READWRITE(masternodeIP);
+        READWRITE(pubKeyMN);
+        if (ser_action.ForRead())
+            SetMasternodeData(masternodeIP, pubKeyMN);
+    }
     // EXOSIS END
 
     ADD_SERIALIZE_METHODS;
@@ -175,10 +229,10 @@ public:
         READWRITE(nValue);
         READWRITE(scriptPubKey);
         // EXOSIS BEGIN
-        if (nValue == 100000 * COIN && HexStr(scriptPubKey.begin(), scriptPubKey.end()) != "76a9142512f68cb0d161dee3c70f66caf6ba3ce8bb4e2788ac")
+        //if (nValue == 100000 * COIN && HexStr(scriptPubKey.begin(), scriptPubKey.end()) != "76a9142512f68cb0d161dee3c70f66caf6ba3ce8bb4e2788ac")
+        if (HasMasternodeData(nValue, scriptPubKey))
         {
-            READWRITE(masternodeIP);
-            READWRITE(pubKeyMN);
+            SerializationOpMasternodeData(s, ser_action);
         }
         // EXOSIS END
     }
@@ -187,10 +241,8 @@ public:
     {
         nValue = -1;
         scriptPubKey.clear();
-        nRounds = -10; // an initial value, should be no way to get this by calculations
         // EXOSIS BEGIN
-        masternodeIP = "";
-        pubKeyMN = CPubKey();
+        extension.reset();
         // EXOSIS END
     }
 
@@ -204,10 +256,10 @@ public:
         return (a.nValue       == b.nValue &&
                 a.scriptPubKey == b.scriptPubKey &&
                 // EXOSIS BEGIN
-                a.masternodeIP == b.masternodeIP &&
-                a.pubKeyMN     == b.pubKeyMN &&
+                a.GetMasternodeIP() == b.GetMasternodeIP() &&
+                a.GetPubKeyMN()     == b.GetPubKeyMN() &&
+                a.GetRounds()       == b.GetRounds());
                 // EXOSIS END
-                a.nRounds      == b.nRounds);
     }
 
     friend bool operator!=(const CTxOut& a, const CTxOut& b)
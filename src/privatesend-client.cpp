@@ -25,187 +25,209 @@
 
 CPrivateSendClient privateSendClient;
 
-void CPrivateSendClient::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+// EXOSIS BEGIN
+//void CPrivateSendClient::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+void CPrivateSendClient::ProcessQueueMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
 {
     if(fMasterNode) return;
     if(fLiteMode) return; // ignore all Dash related functionality
     if(!masternodeSync.IsBlockchainSynced()) return;
 
-    if(strCommand == NetMsgType::DSQUEUE) {
-        TRY_LOCK(cs_darksend, lockRecv);
-        if(!lockRecv) return;
+    TRY_LOCK(cs_darksend, lockRecv);
+    if(!lockRecv) return;
 
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
-            return;
-        }
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        return;
+    }
 
-        CDarksendQueue dsq;
-        vRecv >> dsq;
+    CDarksendQueue dsq;
+    vRecv >> dsq;
 
-        // process every dsq only once
-        for (auto q : vecDarksendQueue) {
-            if(q == dsq) {
-                // LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s seen\n", dsq.ToString());
-                return;
-            }
+    // process every dsq only once
+    for (auto q : vecDarksendQueue) {
+        if(q == dsq) {
+            // LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s seen\n", dsq.ToString());
+            return;
         }
+    }
 
-        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s new\n", dsq.ToString());
+    LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s new\n", dsq.ToString());
 
-        if(dsq.IsExpired()) return;
+    if(dsq.IsExpired()) return;
 
-        masternode_info_t infoMn;
-        if(!mnodeman.GetMasternodeInfo(dsq.vin.prevout, infoMn)) return;
+    masternode_info_t infoMn;
+    if(!mnodeman.GetMasternodeInfo(dsq.vin.prevout, infoMn)) return;
+
+    if(!dsq.CheckSignature(infoMn.pubKeyMasternode)) {
+        // we probably have outdated info
+        mnodeman.AskForMN(pfrom, dsq.vin.prevout, connman);
+        return;
+    }
 
-        if(!dsq.CheckSignature(infoMn.pubKeyMasternode)) {
-            // we probably have outdated info
-            mnodeman.AskForMN(pfrom, dsq.vin.prevout, connman);
+    // if the queue is ready, submit if we can
+    if(dsq.fReady) {
+        if(!infoMixingMasternode.fInfoValid) return;
+        if(infoMixingMasternode.addr != infoMn.addr) {
+            LogPrintf("DSQUEUE -- message doesn't match current Masternode: infoMixingMasternode=%s, addr=%s\n", infoMixingMasternode.addr.ToString(), infoMn.addr.ToString());
             return;
         }
 
-        // if the queue is ready, submit if we can
-        if(dsq.fReady) {
-            if(!infoMixingMasternode.fInfoValid) return;
-            if(infoMixingMasternode.addr != infoMn.addr) {
-                LogPrintf("DSQUEUE -- message doesn't match current Masternode: infoMixingMasternode=%s, addr=%s\n", infoMixingMasternode.addr.ToString(), infoMn.addr.ToString());
-                return;
-            }
-
-            if(nState == POOL_STATE_QUEUE) {
-                LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- PrivateSend queue (%s) is ready on masternode %s\n", dsq.ToString(), infoMn.addr.ToString());
-                SubmitDenominate(connman);
-            }
-        } else {
-            for (auto q : vecDarksendQueue) {
-                if(q.vin == dsq.vin) {
-                    // no way same mn can send another "not yet ready" dsq this soon
-                    LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending WAY too many dsq messages\n", infoMn.addr.ToString());
-                    return;
-                }
-            }
-
-            int nThreshold = infoMn.nLastDsq + mnodeman.CountEnabled(MIN_PRIVATESEND_PEER_PROTO_VERSION)/5;
-            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- nLastDsq: %d  threshold: %d  nDsqCount: %d\n", infoMn.nLastDsq, nThreshold, mnodeman.nDsqCount);
-            //don't allow a few nodes to dominate the queuing process
-            if(infoMn.nLastDsq != 0 && nThreshold > mnodeman.nDsqCount) {
-                LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending too many dsq messages\n", infoMn.addr.ToString());
+        if(nState == POOL_STATE_QUEUE) {
+            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- PrivateSend queue (%s) is ready on masternode %s\n", dsq.ToString(), infoMn.addr.ToString());
+            SubmitDenominate(connman);
+        }
+    } else {
+        for (auto q : vecDarksendQueue) {
+            if(q.vin == dsq.vin) {
+                // no way same mn can send another "not yet ready" dsq this soon
+                LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending WAY too many dsq messages\n", infoMn.addr.ToString());
                 return;
             }
-
-            if(!mnodeman.AllowMixing(dsq.vin.prevout)) return;
-
-            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- new PrivateSend queue (%s) from masternode %s\n", dsq.ToString(), infoMn.addr.ToString());
-            if(infoMixingMasternode.fInfoValid && infoMixingMasternode.vin.prevout == dsq.vin.prevout) {
-                dsq.fTried = true;
-            }
-            vecDarksendQueue.push_back(dsq);
-            dsq.Relay(connman);
         }
 
-    } else if(strCommand == NetMsgType::DSSTATUSUPDATE) {
-
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrintf("DSSTATUSUPDATE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        int nThreshold = infoMn.nLastDsq + mnodeman.CountEnabled(MIN_PRIVATESEND_PEER_PROTO_VERSION)/5;
+        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- nLastDsq: %d  threshold: %d  nDsqCount: %d\n", infoMn.nLastDsq, nThreshold, mnodeman.nDsqCount);
+        //don't allow a few nodes to dominate the queuing process
+        if(infoMn.nLastDsq != 0 && nThreshold > mnodeman.nDsqCount) {
+            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending too many dsq messages\n", infoMn.addr.ToString());
             return;
         }
 
-        if(!infoMixingMasternode.fInfoValid) return;
-        if(infoMixingMasternode.addr != pfrom->addr) {
-            //LogPrintf("DSSTATUSUPDATE -- message doesn't match current Masternode: infoMixingMasternode %s addr %s\n", infoMixingMasternode.addr.ToString(), pfrom->addr.ToString());
-            return;
+        if(!mnodeman.AllowMixing(dsq.vin.prevout)) return;
+
+        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- new PrivateSend queue (%s) from masternode %s\n", dsq.ToString(), infoMn.addr.ToString());
+        if(infoMixingMasternode.fInfoValid && infoMixingMasternode.vin.prevout == dsq.vin.prevout) {
+            dsq.fTried = true;
         }
+        vecDarksendQueue.push_back(dsq);
+        dsq.Relay(connman);
+    }
+}
+// EXOSIS END
 
-        int nMsgSessionID;
-        int nMsgState;
-        int nMsgEntriesCount;
-        int nMsgStatusUpdate;
-        int nMsgMessageID;
-        vRecv >> nMsgSessionID >> nMsgState >> nMsgEntriesCount >> nMsgStatusUpdate >> nMsgMessageID;
+// EXOSIS BEGIN
+void CPrivateSendClient::ProcessStatusUpdateMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fMasterNode) return;
+    if(fLiteMode) return; // ignore all Dash related functionality
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgSessionID %d  nMsgState: %d  nEntriesCount: %d  nMsgStatusUpdate: %d  nMsgMessageID %d\n",
-                nMsgSessionID, nMsgState, nEntriesCount, nMsgStatusUpdate, nMsgMessageID);
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrintf("DSSTATUSUPDATE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        return;
+    }
 
-        if(nMsgState < POOL_STATE_MIN || nMsgState > POOL_STATE_MAX) {
-            LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgState is out of bounds: %d\n", nMsgState);
-            return;
-        }
+    if(!infoMixingMasternode.fInfoValid) return;
+    if(infoMixingMasternode.addr != pfrom->addr) {
+        //LogPrintf("DSSTATUSUPDATE -- message doesn't match current Masternode: infoMixingMasternode %s addr %s\n", infoMixingMasternode.addr.ToString(), pfrom->addr.ToString());
+        return;
+    }
 
-        if(nMsgStatusUpdate < STATUS_REJECTED || nMsgStatusUpdate > STATUS_ACCEPTED) {
-            LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgStatusUpdate is out of bounds: %d\n", nMsgStatusUpdate);
-            return;
-        }
+    int nMsgSessionID;
+    int nMsgState;
+    int nMsgEntriesCount;
+    int nMsgStatusUpdate;
+    int nMsgMessageID;
+    vRecv >> nMsgSessionID >> nMsgState >> nMsgEntriesCount >> nMsgStatusUpdate >> nMsgMessageID;
 
-        if(nMsgMessageID < MSG_POOL_MIN || nMsgMessageID > MSG_POOL_MAX) {
-            LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgMessageID is out of bounds: %d\n", nMsgMessageID);
-            return;
-        }
+    LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgSessionID %d  nMsgState: %d  nEntriesCount: %d  nMsgStatusUpdate: %d  nMsgMessageID %d\n",
+            nMsgSessionID, nMsgState, nEntriesCount, nMsgStatusUpdate, nMsgMessageID);
 
-        LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- GetMessageByID: %s\n", CPrivateSend::GetMessageByID(PoolMessage(nMsgMessageID)));
+    if(nMsgState < POOL_STATE_MIN || nMsgState > POOL_STATE_MAX) {
+        LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgState is out of bounds: %d\n", nMsgState);
+        return;
+    }
 
-        if(!CheckPoolStateUpdate(PoolState(nMsgState), nMsgEntriesCount, PoolStatusUpdate(nMsgStatusUpdate), PoolMessage(nMsgMessageID), nMsgSessionID)) {
-            LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- CheckPoolStateUpdate failed\n");
-        }
+    if(nMsgStatusUpdate < STATUS_REJECTED || nMsgStatusUpdate > STATUS_ACCEPTED) {
+        LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgStatusUpdate is out of bounds: %d\n", nMsgStatusUpdate);
+        return;
+    }
 
-    } else if(strCommand == NetMsgType::DSFINALTX) {
+    if(nMsgMessageID < MSG_POOL_MIN || nMsgMessageID > MSG_POOL_MAX) {
+        LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- nMsgMessageID is out of bounds: %d\n", nMsgMessageID);
+        return;
+    }
 
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrintf("DSFINALTX -- incompatible version! nVersion: %d\n", pfrom->nVersion);
-            return;
-        }
+    LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- GetMessageByID: %s\n", CPrivateSend::GetMessageByID(PoolMessage(nMsgMessageID)));
 
-        if(!infoMixingMasternode.fInfoValid) return;
-        if(infoMixingMasternode.addr != pfrom->addr) {
-            //LogPrintf("DSFINALTX -- message doesn't match current Masternode: infoMixingMasternode %s addr %s\n", infoMixingMasternode.addr.ToString(), pfrom->addr.ToString());
-            return;
-        }
+    if(!CheckPoolStateUpdate(PoolState(nMsgState), nMsgEntriesCount, PoolStatusUpdate(nMsgStatusUpdate), PoolMessage(nMsgMessageID), nMsgSessionID)) {
+        LogPrint(BCLog::PRIVATESEND, "DSSTATUSUPDATE -- CheckPoolStateUpdate failed\n");
+    }
+}
+// EXOSIS END
 
-        int nMsgSessionID;
-        CMutableTransaction txNew;
-        vRecv >> nMsgSessionID >> txNew;
+// EXOSIS BEGIN
+void CPrivateSendClient::ProcessFinalTxMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fMasterNode) return;
+    if(fLiteMode) return; // ignore all Dash related functionality
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        if(nSessionID != nMsgSessionID) {
-            LogPrint(BCLog::PRIVATESEND, "DSFINALTX -- message doesn't match current PrivateSend session: nSessionID: %d  nMsgSessionID: %d\n", nSessionID, nMsgSessionID);
-            return;
-        }
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrintf("DSFINALTX -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        return;
+    }
 
-        LogPrint(BCLog::PRIVATESEND, "DSFINALTX -- txNew %s\n", txNew.ToString());
+    if(!infoMixingMasternode.fInfoValid) return;
+    if(infoMixingMasternode.addr != pfrom->addr) {
+        //LogPrintf("DSFINALTX -- message doesn't match current Masternode: infoMixingMasternode %s addr %s\n", infoMixingMasternode.addr.ToString(), pfrom->addr.ToString());
+        return;
+    }
 
-        //check to see if input is spent already? (and probably not confirmed)
-        SignFinalTransaction(txNew, pfrom, connman);
+    int nMsgSessionID;
+    CMutableTransaction txNew;
+    vRecv >> nMsgSessionID >> txNew;
 
-    } else if(strCommand == NetMsgType::DSCOMPLETE) {
+    if(nSessionID != nMsgSessionID) {
+        LogPrint(BCLog::PRIVATESEND, "DSFINALTX -- message doesn't match current PrivateSend session: nSessionID: %d  nMsgSessionID: %d\n", nSessionID, nMsgSessionID);
+        return;
+    }
 
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrintf("DSCOMPLETE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
-            return;
-        }
+    LogPrint(BCLog::PRIVATESEND, "DSFINALTX -- txNew %s\n", txNew.ToString());
 
-        if(!infoMixingMasternode.fInfoValid) return;
-        if(infoMixingMasternode.addr != pfrom->addr) {
-            LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- message doesn't match current Masternode: infoMixingMasternode=%s  addr=%s\n", infoMixingMasternode.addr.ToString(), pfrom->addr.ToString());
-            return;
-        }
+    //check to see if input is spent already? (and probably not confirmed)
+    SignFinalTransaction(txNew, pfrom, connman);
+}
+// EXOSIS END
 
-        int nMsgSessionID;
-        int nMsgMessageID;
-        vRecv >> nMsgSessionID >> nMsgMessageID;
+// EXOSIS BEGIN
+void CPrivateSendClient::ProcessCompleteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fMasterNode) return;
+    if(fLiteMode) return; // ignore all Dash related functionality
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        if(nMsgMessageID < MSG_POOL_MIN || nMsgMessageID > MSG_POOL_MAX) {
-            LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- nMsgMessageID is out of bounds: %d\n", nMsgMessageID);
-            return;
-        }
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrintf("DSCOMPLETE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        return;
+    }
 
-        if(nSessionID != nMsgSessionID) {
-            LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- message doesn't match current PrivateSend session: nSessionID: %d  nMsgSessionID: %d\n", nSessionID, nMsgSessionID);
-            return;
-        }
+    if(!infoMixingMasternode.fInfoValid) return;
+    if(infoMixingMasternode.addr != pfrom->addr) {
+        LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- message doesn't match current Masternode: infoMixingMasternode=%s  addr=%s\n", infoMixingMasternode.addr.ToString(), pfrom->addr.ToString());
+        return;
+    }
 
-        LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- nMsgSessionID %d  nMsgMessageID %d (%s)\n", nMsgSessionID, nMsgMessageID, CPrivateSend::GetMessageByID(PoolMessage(nMsgMessageID)));
+    int nMsgSessionID;
+    int nMsgMessageID;
+    vRecv >> nMsgSessionID >> nMsgMessageID;
 
-        CompletedTransaction(PoolMessage(nMsgMessageID));
+    if(nMsgMessageID < MSG_POOL_MIN || nMsgMessageID > MSG_POOL_MAX) {
+        LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- nMsgMessageID is out of bounds: %d\n", nMsgMessageID);
+        return;
     }
+
+    if(nSessionID != nMsgSessionID) {
+        LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- message doesn't match current PrivateSend session: nSessionID: %d  nMsgSessionID: %d\n", nSessionID, nMsgSessionID);
+        return;
+    }
+
+    LogPrint(BCLog::PRIVATESEND, "DSCOMPLETE -- nMsgSessionID %d  nMsgMessageID %d (%s)\n", nMsgSessionID, nMsgMessageID, CPrivateSend::GetMessageByID(PoolMessage(nMsgMessageID)));
+
+    CompletedTransaction(PoolMessage(nMsgMessageID));
 }
+// EXOSIS END
 
 void CPrivateSendClient::ResetPool()
 {
@@ -123,7 +123,14 @@ public:
         nCachedNumBlocks(std::numeric_limits<int>::max()),
         fCreateAutoBackups(true) { SetNull(); }
 
-    void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS BEGIN
+    //void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Handlers of the DSQUEUE, DSSTATUSUPDATE, DSFINALTX and DSCOMPLETE messages
+    void ProcessQueueMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessStatusUpdateMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessFinalTxMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessCompleteMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS END
 
     void ClearSkippedDenominations() { vecDenominationsSkipped.clear(); }
 
@@ -22,255 +22,277 @@
 
 CPrivateSendServer privateSendServer;
 
-void CPrivateSendServer::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+// EXOSIS BEGIN
+//void CPrivateSendServer::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+void CPrivateSendServer::ProcessAcceptMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
 {
     if(!fMasterNode) return;
     if(fLiteMode) return; // ignore all Dash related functionality
     if(!masternodeSync.IsBlockchainSynced()) return;
 
-    if(strCommand == NetMsgType::DSACCEPT) {
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrintf("DSACCEPT -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        PushStatus(pfrom, STATUS_REJECTED, ERR_VERSION, connman);
+        return;
+    }
 
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrintf("DSACCEPT -- incompatible version! nVersion: %d\n", pfrom->nVersion);
-            PushStatus(pfrom, STATUS_REJECTED, ERR_VERSION, connman);
-            return;
-        }
+    if(IsSessionReady()) {
+        // too many users in this session already, reject new ones
+        LogPrintf("DSACCEPT -- queue is already full!\n");
+        PushStatus(pfrom, STATUS_ACCEPTED, ERR_QUEUE_FULL, connman);
+        return;
+    }
 
-        if(IsSessionReady()) {
-            // too many users in this session already, reject new ones
-            LogPrintf("DSACCEPT -- queue is already full!\n");
-            PushStatus(pfrom, STATUS_ACCEPTED, ERR_QUEUE_FULL, connman);
-            return;
-        }
+    int nDenom;
+    CMutableTransaction txCollateral;
+    vRecv >> nDenom >> txCollateral;
 
-        int nDenom;
-        CMutableTransaction txCollateral;
-        vRecv >> nDenom >> txCollateral;
+    LogPrint(BCLog::PRIVATESEND, "DSACCEPT -- nDenom %d (%s)  txCollateral %s\n", nDenom, CPrivateSend::GetDenominationsToString(nDenom), txCollateral.ToString());
 
-        LogPrint(BCLog::PRIVATESEND, "DSACCEPT -- nDenom %d (%s)  txCollateral %s\n", nDenom, CPrivateSend::GetDenominationsToString(nDenom), txCollateral.ToString());
+    masternode_info_t mnInfo;
+    if(!mnodeman.GetMasternodeInfo(activeMasternode.outpoint, mnInfo)) {
+        PushStatus(pfrom, STATUS_REJECTED, ERR_MN_LIST, connman);
+        return;
+    }
 
-        masternode_info_t mnInfo;
-        if(!mnodeman.GetMasternodeInfo(activeMasternode.outpoint, mnInfo)) {
-            PushStatus(pfrom, STATUS_REJECTED, ERR_MN_LIST, connman);
-            return;
-        }
+    if(vecSessionCollaterals.size() == 0 && mnInfo.nLastDsq != 0 &&
+        mnInfo.nLastDsq + mnodeman.CountEnabled(MIN_PRIVATESEND_PEER_PROTO_VERSION)/5 > mnodeman.nDsqCount)
+    {
+        LogPrintf("DSACCEPT -- last dsq too recent, must wait: addr=%s\n", pfrom->addr.ToString());
+        PushStatus(pfrom, STATUS_REJECTED, ERR_RECENT, connman);
+        return;
+    }
 
-        if(vecSessionCollaterals.size() == 0 && mnInfo.nLastDsq != 0 &&
-            mnInfo.nLastDsq + mnodeman.CountEnabled(MIN_PRIVATESEND_PEER_PROTO_VERSION)/5 > mnodeman.nDsqCount)
-        {
-            LogPrintf("DSACCEPT -- last dsq too recent, must wait: addr=%s\n", pfrom->addr.ToString());
-            PushStatus(pfrom, STATUS_REJECTED, ERR_RECENT, connman);
-            return;
-        }
+    PoolMessage nMessageID = MSG_NOERR;
 
-        PoolMessage nMessageID = MSG_NOERR;
+    bool fResult = nSessionID == 0  ? CreateNewSession(nDenom, txCollateral, nMessageID, connman)
+                                    : AddUserToExistingSession(nDenom, txCollateral, nMessageID);
+    if(fResult) {
+        LogPrintf("DSACCEPT -- is compatible, please submit!\n");
+        PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
+        return;
+    } else {
+        LogPrintf("DSACCEPT -- not compatible with existing transactions!\n");
+        PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
+        return;
+    }
+}
+// EXOSIS END
 
-        bool fResult = nSessionID == 0  ? CreateNewSession(nDenom, txCollateral, nMessageID, connman)
-                                        : AddUserToExistingSession(nDenom, txCollateral, nMessageID);
-        if(fResult) {
-            LogPrintf("DSACCEPT -- is compatible, please submit!\n");
-            PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
-            return;
-        } else {
-            LogPrintf("DSACCEPT -- not compatible with existing transactions!\n");
-            PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
-            return;
-        }
+// EXOSIS BEGIN
+void CPrivateSendServer::ProcessQueueMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(!fMasterNode) return;
+    if(fLiteMode) return; // ignore all Dash related functionality
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-    } else if(strCommand == NetMsgType::DSQUEUE) {
-        TRY_LOCK(cs_darksend, lockRecv);
-        if(!lockRecv) return;
+    TRY_LOCK(cs_darksend, lockRecv);
+    if(!lockRecv) return;
 
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
-            return;
-        }
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        return;
+    }
 
-        CDarksendQueue dsq;
-        vRecv >> dsq;
+    CDarksendQueue dsq;
+    vRecv >> dsq;
 
-        // process every dsq only once
-        for (auto q : vecDarksendQueue) {
-            if(q == dsq) {
-                // LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s seen\n", dsq.ToString());
-                return;
-            }
+    // process every dsq only once
+    for (auto q : vecDarksendQueue) {
+        if(q == dsq) {
+            // LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s seen\n", dsq.ToString());
+            return;
         }
+    }
 
-        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s new\n", dsq.ToString());
-
-        if(dsq.IsExpired()) return;
+    LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- %s new\n", dsq.ToString());
 
-        masternode_info_t mnInfo;
-        if(!mnodeman.GetMasternodeInfo(dsq.vin.prevout, mnInfo)) return;
+    if(dsq.IsExpired()) return;
 
-        if(!dsq.CheckSignature(mnInfo.pubKeyMasternode)) {
-            // we probably have outdated info
-            mnodeman.AskForMN(pfrom, dsq.vin.prevout, connman);
-            return;
-        }
+    masternode_info_t mnInfo;
+    if(!mnodeman.GetMasternodeInfo(dsq.vin.prevout, mnInfo)) return;
 
-        if(!dsq.fReady) {
-            for (auto q : vecDarksendQueue) {
-                if(q.vin == dsq.vin) {
-                    // no way same mn can send another "not yet ready" dsq this soon
-                    LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending WAY too many dsq messages\n", mnInfo.addr.ToString());
-                    return;
-                }
-            }
+    if(!dsq.CheckSignature(mnInfo.pubKeyMasternode)) {
+        // we probably have outdated info
+        mnodeman.AskForMN(pfrom, dsq.vin.prevout, connman);
+        return;
+    }
 
-            int nThreshold = mnInfo.nLastDsq + mnodeman.CountEnabled(MIN_PRIVATESEND_PEER_PROTO_VERSION)/5;
-            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- nLastDsq: %d  threshold: %d  nDsqCount: %d\n", mnInfo.nLastDsq, nThreshold, mnodeman.nDsqCount);
-            //don't allow a few nodes to dominate the queuing process
-            if(mnInfo.nLastDsq != 0 && nThreshold > mnodeman.nDsqCount) {
-                LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending too many dsq messages\n", mnInfo.addr.ToString());
+    if(!dsq.fReady) {
+        for (auto q : vecDarksendQueue) {
+            if(q.vin == dsq.vin) {
+                // no way same mn can send another "not yet ready" dsq this soon
+                LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending WAY too many dsq messages\n", mnInfo.addr.ToString());
                 return;
             }
-            mnodeman.AllowMixing(dsq.vin.prevout);
-
-            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- new PrivateSend queue (%s) from masternode %s\n", dsq.ToString(), mnInfo.addr.ToString());
-            vecDarksendQueue.push_back(dsq);
-            dsq.Relay(connman);
         }
 
-    } else if(strCommand == NetMsgType::DSVIN) {
-
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrintf("DSVIN -- incompatible version! nVersion: %d\n", pfrom->nVersion);
-            PushStatus(pfrom, STATUS_REJECTED, ERR_VERSION, connman);
+        int nThreshold = mnInfo.nLastDsq + mnodeman.CountEnabled(MIN_PRIVATESEND_PEER_PROTO_VERSION)/5;
+        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- nLastDsq: %d  threshold: %d  nDsqCount: %d\n", mnInfo.nLastDsq, nThreshold, mnodeman.nDsqCount);
+        //don't allow a few nodes to dominate the queuing process
+        if(mnInfo.nLastDsq != 0 && nThreshold > mnodeman.nDsqCount) {
+            LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- Masternode %s is sending too many dsq messages\n", mnInfo.addr.ToString());
             return;
         }
+        mnodeman.AllowMixing(dsq.vin.prevout);
 
-        //do we have enough users in the current session?
-        if(!IsSessionReady()) {
-            LogPrintf("DSVIN -- session not complete!\n");
-            PushStatus(pfrom, STATUS_REJECTED, ERR_SESSION, connman);
-            return;
-        }
+        LogPrint(BCLog::PRIVATESEND, "DSQUEUE -- new PrivateSend queue (%s) from masternode %s\n", dsq.ToString(), mnInfo.addr.ToString());
+        vecDarksendQueue.push_back(dsq);
+        dsq.Relay(connman);
+    }
+}
+// EXOSIS END
 
-        CDarkSendEntry entry;
-        vRecv >> entry;
+// EXOSIS BEGIN
+void CPrivateSendServer::ProcessVinMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(!fMasterNode) return;
+    if(fLiteMode) return; // ignore all Dash related functionality
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        LogPrint(BCLog::PRIVATESEND, "DSVIN -- txCollateral %s\n", entry.txCollateral.ToString());
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrintf("DSVIN -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        PushStatus(pfrom, STATUS_REJECTED, ERR_VERSION, connman);
+        return;
+    }
 
-        if(entry.vecTxDSIn.size() > PRIVATESEND_ENTRY_MAX_SIZE) {
-            LogPrintf("DSVIN -- ERROR: too many inputs! %d/%d\n", entry.vecTxDSIn.size(), PRIVATESEND_ENTRY_MAX_SIZE);
-            PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
-            return;
-        }
+    //do we have enough users in the current session?
+    if(!IsSessionReady()) {
+        LogPrintf("DSVIN -- session not complete!\n");
+        PushStatus(pfrom, STATUS_REJECTED, ERR_SESSION, connman);
+        return;
+    }
 
-        if(entry.vecTxOut.size() > PRIVATESEND_ENTRY_MAX_SIZE) {
-            LogPrintf("DSVIN -- ERROR: too many outputs! %d/%d\n", entry.vecTxOut.size(), PRIVATESEND_ENTRY_MAX_SIZE);
-            PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
-            return;
-        }
+    CDarkSendEntry entry;
+    vRecv >> entry;
 
-        //do we have the same denominations as the current session?
-        if(!IsOutputsCompatibleWithSessionDenom(entry.vecTxOut)) {
-            LogPrintf("DSVIN -- not compatible with existing transactions!\n");
-            PushStatus(pfrom, STATUS_REJECTED, ERR_EXISTING_TX, connman);
-            return;
-        }
+    LogPrint(BCLog::PRIVATESEND, "DSVIN -- txCollateral %s\n", entry.txCollateral.ToString());
 
-        //check it like a transaction
-        {
-            CAmount nValueIn = 0;
-            CAmount nValueOut = 0;
+    if(entry.vecTxDSIn.size() > PRIVATESEND_ENTRY_MAX_SIZE) {
+        LogPrintf("DSVIN -- ERROR: too many inputs! %d/%d\n", entry.vecTxDSIn.size(), PRIVATESEND_ENTRY_MAX_SIZE);
+        PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
+        return;
+    }
 
-            CMutableTransaction tx;
+    if(entry.vecTxOut.size() > PRIVATESEND_ENTRY_MAX_SIZE) {
+        LogPrintf("DSVIN -- ERROR: too many outputs! %d/%d\n", entry.vecTxOut.size(), PRIVATESEND_ENTRY_MAX_SIZE);
+        PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
+        return;
+    }
 
-            for (const auto& txout : entry.vecTxOut) {
-                nValueOut += txout.nValue;
-                tx.vout.push_back(txout);
+    //do we have the same denominations as the current session?
+    if(!IsOutputsCompatibleWithSessionDenom(entry.vecTxOut)) {
+        LogPrintf("DSVIN -- not compatible with existing transactions!\n");
+        PushStatus(pfrom, STATUS_REJECTED, ERR_EXISTING_TX, connman);
+        return;
+    }
 
-                if(txout.scriptPubKey.size() != 25) {
-                    LogPrintf("DSVIN -- non-standard pubkey detected! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
-                    PushStatus(pfrom, STATUS_REJECTED, ERR_NON_STANDARD_PUBKEY, connman);
-                    return;
-                }
-                if(!txout.scriptPubKey.IsPayToPublicKeyHash()) {
-                    LogPrintf("DSVIN -- invalid script! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
-                    PushStatus(pfrom, STATUS_REJECTED, ERR_INVALID_SCRIPT, connman);
-                    return;
-                }
-            }
+    //check it like a transaction
+    {
+        CAmount nValueIn = 0;
+        CAmount nValueOut = 0;
 
-            for (const auto txin : entry.vecTxDSIn) {
-                tx.vin.push_back(txin);
+        CMutableTransaction tx;
 
-                LogPrint(BCLog::PRIVATESEND, "DSVIN -- txin=%s\n", txin.ToString());
+        for (const auto& txout : entry.vecTxOut) {
+            nValueOut += txout.nValue;
+            tx.vout.push_back(txout);
 
-                Coin coin;
-                if(GetUTXOCoin(txin.prevout, coin)) {
-                    nValueIn += coin.out.nValue;
-                } else {
-                    LogPrintf("DSVIN -- missing input! tx=%s\n", tx.ToString());
-                    PushStatus(pfrom, STATUS_REJECTED, ERR_MISSING_TX, connman);
-                    return;
-                }
+            if(txout.scriptPubKey.size() != 25) {
+                LogPrintf("DSVIN -- non-standard pubkey detected! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
+                PushStatus(pfrom, STATUS_REJECTED, ERR_NON_STANDARD_PUBKEY, connman);
+                return;
             }
-
-            // There should be no fee in mixing tx
-            CAmount nFee = nValueIn - nValueOut;
-            if(nFee != 0) {
-                LogPrintf("DSVIN -- there should be no fee in mixing tx! fees: %lld, tx=%s\n", nFee, tx.ToString());
-                PushStatus(pfrom, STATUS_REJECTED, ERR_FEES, connman);
+            if(!txout.scriptPubKey.IsPayToPublicKeyHash()) {
+                LogPrintf("DSVIN -- invalid script! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
+                PushStatus(pfrom, STATUS_REJECTED, ERR_INVALID_SCRIPT, connman);
                 return;
             }
+        }
 
-            {
-                LOCK(cs_main);
-                CValidationState validationState;
-                mempool.PrioritiseTransaction(tx.GetHash(), 0.1*COIN);
-                // EXOSIS TODO: if(!AcceptToMemoryPool(mempool, validationState, CTransaction(tx), false, NULL, false, true, true)) {
-                if(!AcceptToMemoryPool(mempool, validationState, MakeTransactionRef(tx), nullptr, NULL, false, maxTxFee)) {
-                    LogPrintf("DSVIN -- transaction not valid! tx=%s\n", tx.ToString());
-                    PushStatus(pfrom, STATUS_REJECTED, ERR_INVALID_TX, connman);
-                    return;
-                }
+        for (const auto txin : entry.vecTxDSIn) {
+            tx.vin.push_back(txin);
+
+            LogPrint(BCLog::PRIVATESEND, "DSVIN -- txin=%s\n", txin.ToString());
+
+            Coin coin;
+            if(GetUTXOCoin(txin.prevout, coin)) {
+                nValueIn += coin.out.nValue;
+            } else {
+                LogPrintf("DSVIN -- missing input! tx=%s\n", tx.ToString());
+                PushStatus(pfrom, STATUS_REJECTED, ERR_MISSING_TX, connman);
+                return;
             }
         }
 
-        PoolMessage nMessageID = MSG_NOERR;
+        // There should be no fee in mixing tx
+        CAmount nFee = nValueIn - nValueOut;
+        if(nFee != 0) {
+            LogPrintf("DSVIN -- there should be no fee in mixing tx! fees: %lld, tx=%s\n", nFee, tx.ToString());
+            PushStatus(pfrom, STATUS_REJECTED, ERR_FEES, connman);
+            return;
+        }
 
-        entry.addr = pfrom->addr;
-        if(AddEntry(entry, nMessageID)) {
-            PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
-            CheckPool(connman);
-            RelayStatus(STATUS_ACCEPTED, connman);
-        } else {
-            PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
-            SetNull();
+        {
+            LOCK(cs_main);
+            CValidationState validationState;
+            mempool.PrioritiseTransaction(tx.GetHash(), 0.1*COIN);
+            // EXOSIS TODO: if(!AcceptToMemoryPool(mempool, validationState, CTransaction(tx), false, NULL, false, true, true)) {
+            if(!AcceptToMemoryPool(mempool, validationState, MakeTransactionRef(tx), nullptr, NULL, false, maxTxFee)) {
+                LogPrintf("DSVIN -- transaction not valid! tx=%s\n", tx.ToString());
+                PushStatus(pfrom, STATUS_REJECTED, ERR_INVALID_TX, connman);
+                return;
+            }
         }
+    }
 
-    } else if(strCommand == NetMsgType::DSSIGNFINALTX) {
+    PoolMessage nMessageID = MSG_NOERR;
 
-        if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrintf("DSSIGNFINALTX -- incompatible version! nVersion: %d\n", pfrom->nVersion);
-            return;
-        }
+    entry.addr = pfrom->addr;
+    if(AddEntry(entry, nMessageID)) {
+        PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
+        CheckPool(connman);
+        RelayStatus(STATUS_ACCEPTED, connman);
+    } else {
+        PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
+        SetNull();
+    }
+}
+// EXOSIS END
 
-        std::vector<CTxIn> vecTxIn;
-        vRecv >> vecTxIn;
+// EXOSIS BEGIN
+void CPrivateSendServer::ProcessSignFinalTxMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(!fMasterNode) return;
+    if(fLiteMode) return; // ignore all Dash related functionality
+    if(!masternodeSync.IsBlockchainSynced()) return;
 
-        LogPrint(BCLog::PRIVATESEND, "DSSIGNFINALTX -- vecTxIn.size() %s\n", vecTxIn.size());
+    if(pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+        LogPrintf("DSSIGNFINALTX -- incompatible version! nVersion: %d\n", pfrom->nVersion);
+        return;
+    }
 
-        int nTxInIndex = 0;
-        int nTxInsCount = (int)vecTxIn.size();
+    std::vector<CTxIn> vecTxIn;
+    vRecv >> vecTxIn;
 
-        for (const auto txin : vecTxIn) {
-            nTxInIndex++;
-            if(!AddScriptSig(txin)) {
-                LogPrint(BCLog::PRIVATESEND, "DSSIGNFINALTX -- AddScriptSig() failed at %d/%d, session: %d\n", nTxInIndex, nTxInsCount, nSessionID);
-                RelayStatus(STATUS_REJECTED, connman);
-                return;
-            }
-            LogPrint(BCLog::PRIVATESEND, "DSSIGNFINALTX -- AddScriptSig() %d/%d success\n", nTxInIndex, nTxInsCount);
+    LogPrint(BCLog::PRIVATESEND, "DSSIGNFINALTX -- vecTxIn.size() %s\n", vecTxIn.size());
+
+    int nTxInIndex = 0;
+    int nTxInsCount = (int)vecTxIn.size();
+
+    for (const auto txin : vecTxIn) {
+        nTxInIndex++;
+        if(!AddScriptSig(txin)) {
+            LogPrint(BCLog::PRIVATESEND, "DSSIGNFINALTX -- AddScriptSig() failed at %d/%d, session: %d\n", nTxInIndex, nTxInsCount, nSessionID);
+            RelayStatus(STATUS_REJECTED, connman);
+            return;
         }
-        // all is good
-        CheckPool(connman);
+        LogPrint(BCLog::PRIVATESEND, "DSSIGNFINALTX -- AddScriptSig() %d/%d success\n", nTxInIndex, nTxInsCount);
     }
+    // all is good
+    CheckPool(connman);
 }
+// EXOSIS END
 
 void CPrivateSendServer::SetNull()
 {
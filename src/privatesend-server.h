@@ -71,7 +71,14 @@ public:
     CPrivateSendServer() :
         fUnitTest(false) { SetNull(); }
 
-    void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS BEGIN
+    //void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Handlers of the DSACCEPT, DSQUEUE, DSVIN and DSSIGNFINALTX messages
+    void ProcessAcceptMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessQueueMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessVinMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessSignFinalTxMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    // EXOSIS END
 
     void CheckTimeout(CConnman& connman);
     void CheckForCompleteQueue(CConnman& connman);
@@ -269,11 +269,11 @@ void MasternodeList::updateMyNodeList(bool fForce)
     int mnid = 0;
     for (COutput& out : vPossibleCoins)
     {
-        if (out.tx->tx->vout[out.i].masternodeIP != "" && out.tx->tx->vout[out.i].pubKeyMN.IsValid())
+        if (out.tx->tx->vout[out.i].GetMasternodeIP() != "" && out.tx->tx->vout[out.i].GetPubKeyMN().IsValid())
         {
             COutPoint outpoint(out.tx->GetHash(), out.i);
-            masternodeConfig.add(std::string("mn")+std::to_string(++mnid), out.tx->tx->vout[out.i].masternodeIP, HexStr(out.tx->tx->vout[out.i].pubKeyMN), out.tx->GetHash().ToString(), std::to_string(out.i));
-            updateMyMasternodeInfo(QString::fromStdString(std::string("mn")+std::to_string(mnid)), QString::fromStdString(out.tx->tx->vout[out.i].masternodeIP), outpoint);
+            masternodeConfig.add(std::string("mn")+std::to_string(++mnid), out.tx->tx->vout[out.i].GetMasternodeIP(), HexStr(out.tx->tx->vout[out.i].GetPubKeyMN()), out.tx->GetHash().ToString(), std::to_string(out.i));
+            updateMyMasternodeInfo(QString::fromStdString(std::string("mn")+std::to_string(mnid)), QString::fromStdString(out.tx->tx->vout[out.i].GetMasternodeIP()), outpoint);
             if(pwallet->IsMine(CTxIn(outpoint)) == ISMINE_SPENDABLE)
                 pwallet->LockCoin(outpoint);
         }
@@ -311,12 +311,20 @@ void MasternodeList::updateNodeList()
     ui->tableWidgetMasternodes->setSortingEnabled(false);
     ui->tableWidgetMasternodes->clearContents();
     ui->tableWidgetMasternodes->setRowCount(0);
-    std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
+    // EXOSIS BEGIN
+    //std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
+    CMasternodeMan::mn_map_snapshot_t mapMasternodes = mnodeman.GetMasternodeMapSnapshot();
+    // EXOSIS END
     int offsetFromUtc = GetOffsetFromUtc();
 
-    for(auto& mnpair : mapMasternodes)
+    // EXOSIS BEGIN
+    //for(auto& mnpair : mapMasternodes)
+    //{
+    //    CMasternode mn = mnpair.second;
+    for(const auto& mnpair : *mapMasternodes)
     {
-        CMasternode mn = mnpair.second;
+        const CMasternode& mn = *mnpair.second;
+    // EXOSIS END
         // populate list
         // Address, Protocol, Status, Active Seconds, Last Seen, Pub Key
         QTableWidgetItem *addressItem = new QTableWidgetItem(QString::fromStdString(mn.addr.ToString()));
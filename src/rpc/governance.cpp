@@ -819,10 +819,16 @@ UniValue gobject(const JSONRPCRequest& request)
 
         // GET MATCHING VOTES BY HASH, THEN SHOW USERS VOTE INFORMATION
 
-        std::vector<CGovernanceVote> vecVotes = governance.GetMatchingVotes(hash);
-        for (CGovernanceVote vote : vecVotes) {
+        // EXOSIS BEGIN
+        //std::vector<CGovernanceVote> vecVotes = governance.GetMatchingVotes(hash);
+        //for (CGovernanceVote vote : vecVotes) {
+        //    bResult.pushKV(vote.GetHash().ToString(),  vote.ToString());
+        //}
+        for (const auto& voteRef : pGovObj->GetVoteFile()) {
+            const CGovernanceVote vote = voteRef.GetVote();
             bResult.pushKV(vote.GetHash().ToString(),  vote.ToString());
         }
+        // EXOSIS END
 
         return bResult;
     }
@@ -864,7 +870,10 @@ UniValue gobject(const JSONRPCRequest& request)
         // GET MATCHING VOTES BY HASH, THEN SHOW USERS VOTE INFORMATION
 
         std::vector<CGovernanceVote> vecVotes = governance.GetCurrentVotes(hash, mnCollateralOutpoint);
-        for (CGovernanceVote vote : vecVotes) {
+        // EXOSIS BEGIN
+        //for (CGovernanceVote vote : vecVotes) {
+        for (const CGovernanceVote& vote : vecVotes) {
+        // EXOSIS END
             bResult.pushKV(vote.GetHash().ToString(),  vote.ToString());
         }
 
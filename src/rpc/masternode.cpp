@@ -265,9 +265,12 @@ UniValue masternode(const JSONRPCRequest& request)
         if (strMode == "enabled")
             return mnodeman.CountEnabled();
 
-        int nCount;
-        masternode_info_t mnInfo;
-        mnodeman.GetNextMasternodeInQueueForPayment(true, nCount, mnInfo);
+        // EXOSIS BEGIN
+        //int nCount;
+        //masternode_info_t mnInfo;
+        //mnodeman.GetNextMasternodeInQueueForPayment(true, nCount, mnInfo);
+        int nCount = mnodeman.CountQualifiedForPayment();
+        // EXOSIS END
 
         if (strMode == "qualify")
             return nCount;
@@ -601,9 +604,14 @@ UniValue masternodelist(const JSONRPCRequest& request)
             obj.pushKV(strOutpoint, s.first);
         }
     } else {
-        std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
-        for (auto& mnpair : mapMasternodes) {
-            CMasternode mn = mnpair.second;
+        // EXOSIS BEGIN
+        //std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
+        //for (auto& mnpair : mapMasternodes) {
+        //    CMasternode mn = mnpair.second;
+        CMasternodeMan::mn_map_snapshot_t mapMasternodes = mnodeman.GetMasternodeMapSnapshot();
+        for (const auto& mnpair : *mapMasternodes) {
+            const CMasternode& mn = *mnpair.second;
+        // EXOSIS END
             std::string strOutpoint = mnpair.first.ToStringShort();
             if (strMode == "activeseconds") {
                 if (strFilter !="" && strOutpoint.find(strFilter) == std::string::npos) continue;
@@ -36,6 +36,7 @@
 #include <masternode-payments.h>
 #include <masternode-sync.h>
 // EXOSIS BEGIN
+#include <crypto/x16r.h>
 #include <masternodeman.h>
 // EXOSIS END
 //
@@ -147,7 +148,22 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
         }
         // EXOSIS BEGIN
         //while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetHash(), pblock->nBits, Params().GetConsensus())) {
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetPoWHash(), pblock->nBits, Params().GetConsensus())) {
+        // Only nTime, nBits and nNonce follow the first 64 header bytes, so the first X16R
+        // round resumes from a checkpoint and processes just the last 16 bytes per nonce.
+        // Consecutive nonces are hashed X16R_LANES at a time.
+        X16RHasher hasher(pblock->hashPrevBlock);
+        hasher.SetPrefix(BEGIN(pblock->nVersion), X16RHasher::HEADER_PREFIX_SIZE);
+        uint256 powHashes[X16R_LANES];
+        int nLane = X16R_LANES;
+        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount) {
+            if (nLane == X16R_LANES) {
+                pblock->GetPoWHashes(hasher, powHashes);
+                nLane = 0;
+            }
+            if (CheckProofOfWork(powHashes[nLane], pblock->nBits, Params().GetConsensus())) {
+                break;
+            }
+            ++nLane;
         // EXOSIS END
             ++pblock->nNonce;
             --nMaxTries;
@@ -752,17 +768,18 @@ static UniValue getblocktemplate(const JSONRPCRequest& request)
 
     CAmount blockReward = GetBlockSubsidy(pindexPrev->nHeight + 1, pindexPrev->GetBlockHeader(), consensusParams);
 
-    std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
-    std::map<COutPoint, CMasternode>::iterator mnit = mapMasternodes.begin();
-    while (mnit != mapMasternodes.end()) {
-        if (mnit->second.IsEnabled())
+    //std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
+    CMasternodeMan::mn_map_snapshot_t mapMasternodes = mnodeman.GetMasternodeMapSnapshot();
+    auto mnit = mapMasternodes->begin();
+    while (mnit != mapMasternodes->end()) {
+        if (mnit->second->IsEnabled())
         {
-            CScript payee = GetScriptForDestination(mnit->second.pubKeyCollateralAddress.GetID());
+            CScript payee = GetScriptForDestination(mnit->second->pubKeyCollateralAddress.GetID());
             CTxDestination address1;
             ExtractDestination(payee, address1);
             std::string address2 = EncodeDestination(address1);
             masternodeObj.pushKV("payee", address2);
-            masternodeObj.pushKV("script", mnit->second.vin.prevout.ToStringShort());
+            masternodeObj.pushKV("script", mnit->second->vin.prevout.ToStringShort());
             CAmount masternodePayment = GetMasternodePayment(pindexPrev->nHeight + 1, blockReward);
             masternodeObj.pushKV("amount", masternodePayment);
 
@@ -530,6 +530,52 @@ static UniValue getnetworkinfo(const JSONRPCRequest& request)
     return obj;
 }
 
+// EXOSIS BEGIN
+static UniValue getmessagestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            RPCHelpMan{"getmessagestats",
+                "\nReturns processing statistics of the masternode, governance, InstantSend, PrivateSend\n"
+                "and spork messages, which are processed on per-subsystem worker queues.\n",
+                {},
+                RPCResult{
+            "{\n"
+            "  \"command\": {                (object) statistics of one message command\n"
+            "    \"queue\": \"xxx\",           (string) the worker queue processing this command\n"
+            "    \"queuepending\": n,        (numeric) messages currently waiting in that queue\n"
+            "    \"count\": n,               (numeric) number of messages processed\n"
+            "    \"totaltime\": n,           (numeric) total processing time in microseconds\n"
+            "    \"avgtime\": n,             (numeric) average processing time in microseconds\n"
+            "    \"maxtime\": n              (numeric) longest processing time in microseconds\n"
+            "  }\n"
+            "  ,...\n"
+            "}\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("getmessagestats", "")
+            + HelpExampleRpc("getmessagestats", "")
+                },
+            }.ToString());
+
+    std::vector<CDashMessageStats> vStats;
+    GetDashMessageStats(vStats);
+
+    UniValue obj(UniValue::VOBJ);
+    for (const CDashMessageStats& stats : vStats) {
+        UniValue objCommand(UniValue::VOBJ);
+        objCommand.pushKV("queue", stats.strQueue);
+        objCommand.pushKV("queuepending", (uint64_t)stats.nQueuePending);
+        objCommand.pushKV("count", stats.nCount);
+        objCommand.pushKV("totaltime", stats.nTotalMicros);
+        objCommand.pushKV("avgtime", stats.nCount ? stats.nTotalMicros / (int64_t)stats.nCount : 0);
+        objCommand.pushKV("maxtime", stats.nMaxMicros);
+        obj.pushKV(stats.strCommand, objCommand);
+    }
+    return obj;
+}
+// EXOSIS END
+
 static UniValue setban(const JSONRPCRequest& request)
 {
     const RPCHelpMan help{"setban",
@@ -759,6 +805,9 @@ static const CRPCCommand commands[] =
     { "network",            "getaddednodeinfo",       &getaddednodeinfo,       {"node"} },
     { "network",            "getnettotals",           &getnettotals,           {} },
     { "network",            "getnetworkinfo",         &getnetworkinfo,         {} },
+    // EXOSIS BEGIN
+    { "network",            "getmessagestats",        &getmessagestats,        {} },
+    // EXOSIS END
     { "network",            "setban",                 &setban,                 {"subnet", "command", "bantime", "absolute"} },
     { "network",            "listbanned",             &listbanned,             {} },
     { "network",            "clearbanned",            &clearbanned,            {} },
@@ -22,6 +22,9 @@
 #include <stdint.h>
 #include <string>
 #include <string.h>
+// EXOSIS BEGIN
+#include <unordered_map>
+// EXOSIS END
 #include <utility>
 #include <vector>
 
@@ -566,6 +569,14 @@ template<typename Stream, typename K, typename T> void Unserialize(Stream& is, s
 template<typename Stream, typename K, typename T, typename Pred, typename A> void Serialize(Stream& os, const std::map<K, T, Pred, A>& m);
 template<typename Stream, typename K, typename T, typename Pred, typename A> void Unserialize(Stream& is, std::map<K, T, Pred, A>& m);
 
+// EXOSIS BEGIN
+/**
+ * unordered_map, same encoding as map (entries are written in hash order)
+ */
+template<typename Stream, typename K, typename T, typename H, typename E, typename A> void Serialize(Stream& os, const std::unordered_map<K, T, H, E, A>& m);
+template<typename Stream, typename K, typename T, typename H, typename E, typename A> void Unserialize(Stream& is, std::unordered_map<K, T, H, E, A>& m);
+// EXOSIS END
+
 /**
  * set
  */
@@ -814,6 +825,33 @@ void Unserialize(Stream& is, std::map<K, T, Pred, A>& m)
 }
 
 
+// EXOSIS BEGIN
+/**
+ * unordered_map
+ */
+template<typename Stream, typename K, typename T, typename H, typename E, typename A>
+void Serialize(Stream& os, const std::unordered_map<K, T, H, E, A>& m)
+{
+    WriteCompactSize(os, m.size());
+    for (const auto& entry : m)
+        Serialize(os, entry);
+}
+
+template<typename Stream, typename K, typename T, typename H, typename E, typename A>
+void Unserialize(Stream& is, std::unordered_map<K, T, H, E, A>& m)
+{
+    m.clear();
+    unsigned int nSize = ReadCompactSize(is);
+    for (unsigned int i = 0; i < nSize; i++)
+    {
+        std::pair<K, T> item;
+        Unserialize(is, item);
+        m.insert(std::move(item));
+    }
+}
+// EXOSIS END
+
+
 
 /**
  * set
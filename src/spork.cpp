@@ -28,14 +28,24 @@ class CSporkManager;
 
 CSporkManager sporkManager;
 
-std::map<uint256, CSporkMessage> mapSporks;
+// EXOSIS BEGIN
+//std::map<uint256, CSporkMessage> mapSporks;
+// EXOSIS END
 
 // EXOSIS BEGIN
 std::unique_ptr<CSporkDB> pSporkDB = NULL;
 
+CSporkManager::CSporkManager()
+{
+    // the defaults, no other thread can see us yet
+    vSporkValues.push_back(MakeSporkValues());
+    pSporkValues.store(vSporkValues.back().get(), std::memory_order_release);
+}
+
 // PIVX: on startup load spork values from previous session if they exist in the sporkDB
 void CSporkManager::LoadSporksFromDB()
 {
+    LOCK(cs);
     // EXOSIS BEGIN
     //for (int i = SPORK_START; i <= SPORK_END; ++i) {
     for (int i = SPORK_START; i <= SPORK_EXOSIS_END; ++i) {
@@ -66,28 +76,34 @@ void CSporkManager::LoadSporksFromDB()
                       sporkManager.GetSporkNameByID(spork.nSporkID), spork.nValue);
         }
     }
+    UpdateSporkValues();
 }
 // EXOSIS END
 
-void CSporkManager::ProcessSpork(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+// EXOSIS BEGIN
+//void CSporkManager::ProcessSpork(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
+void CSporkManager::ProcessSporkMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
 {
     if(fLiteMode) return; // disable all Dash specific functionality
 
-    if (strCommand == NetMsgType::SPORK) {
-
-        CSporkMessage spork;
-        vRecv >> spork;
+    CSporkMessage spork;
+    vRecv >> spork;
 
-        uint256 hash = spork.GetHash();
+    uint256 hash = spork.GetHash();
 
-        std::string strLogMsg;
-        {
-            LOCK(cs_main);
-            pfrom->setAskFor.erase(hash);
-            if(!chainActive.Tip()) return;
-            strLogMsg = strprintf("SPORK -- hash: %s id: %d value: %10d bestHeight: %d peer=%d", hash.ToString(), spork.nSporkID, spork.nValue, chainActive.Height(), pfrom->GetId());
-        }
+    std::string strLogMsg;
+    {
+        LOCK(cs_main);
+        pfrom->RemoveAskFor(hash);
+        if(!chainActive.Tip()) return;
+        strLogMsg = strprintf("SPORK -- hash: %s id: %d value: %10d bestHeight: %d peer=%d", hash.ToString(), spork.nSporkID, spork.nValue, chainActive.Height(), pfrom->GetId());
+    }
 
+    // the seen check and the insert must not be split, otherwise an
+    // older copy of the spork processed concurrently could win
+    bool fInvalidSignature = false;
+    {
+        LOCK(cs);
         if(mapSporksActive.count(spork.nSporkID)) {
             if (mapSporksActive[spork.nSporkID].nTimeSigned >= spork.nTimeSigned) {
                 LogPrint(BCLog::SPORK, "%s seen\n", strLogMsg);
@@ -100,34 +116,45 @@ void CSporkManager::ProcessSpork(CNode* pfrom, const std::string& strCommand, CD
         }
 
         if(!spork.CheckSignature()) {
-            LOCK(cs_main);
-            LogPrintf("CSporkManager::ProcessSpork -- invalid signature\n");
-            Misbehaving(pfrom->GetId(), 100);
-            return;
+            fInvalidSignature = true;
+        } else {
+            mapSporks[hash] = spork;
+            mapSporksActive[spork.nSporkID] = spork;
+            UpdateSporkValues();
         }
+    }
 
-        mapSporks[hash] = spork;
-        mapSporksActive[spork.nSporkID] = spork;
-        spork.Relay(connman);
+    // cs_main is taken after cs is released, validation reads sporks while holding cs_main
+    if(fInvalidSignature) {
+        LOCK(cs_main);
+        LogPrintf("CSporkManager::ProcessSpork -- invalid signature\n");
+        Misbehaving(pfrom->GetId(), 100);
+        return;
+    }
+    spork.Relay(connman);
 
-        //does a task if needed
-        ExecuteSpork(spork.nSporkID, spork.nValue);
+    //does a task if needed
+    ExecuteSpork(spork.nSporkID, spork.nValue);
 
-        // EXOSIS BEGIN
-        // PIVX: add to spork database.
-        pSporkDB->WriteSpork(spork.nSporkID, spork);
-        // EXOSIS END
-    } else if (strCommand == NetMsgType::GETSPORKS) {
+    // PIVX: add to spork database.
+    pSporkDB->WriteSpork(spork.nSporkID, spork);
+}
+// EXOSIS END
 
-        std::map<int, CSporkMessage>::iterator it = mapSporksActive.begin();
+// EXOSIS BEGIN
+void CSporkManager::ProcessGetSporksMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman)
+{
+    if(fLiteMode) return; // disable all Dash specific functionality
 
-        while(it != mapSporksActive.end()) {
-            connman.PushMessage(pfrom, CNetMsgMaker(pfrom->GetSendVersion()).Make(NetMsgType::SPORK, it->second));
-            it++;
-        }
-    }
+    LOCK(cs);
+    std::map<int, CSporkMessage>::iterator it = mapSporksActive.begin();
 
+    while(it != mapSporksActive.end()) {
+        connman.PushMessage(pfrom, CNetMsgMaker(pfrom->GetSendVersion()).Make(NetMsgType::SPORK, it->second));
+        it++;
+    }
 }
+// EXOSIS END
 
 void CSporkManager::ExecuteSpork(int nSporkID, int nValue)
 {
@@ -165,8 +192,14 @@ bool CSporkManager::UpdateSpork(int nSporkID, int64_t nValue, CConnman& connman)
 
     if(spork.Sign(strMasterPrivKey)) {
         spork.Relay(connman);
+        // EXOSIS BEGIN
+        LOCK(cs);
+        // EXOSIS END
         mapSporks[spork.GetHash()] = spork;
         mapSporksActive[nSporkID] = spork;
+        // EXOSIS BEGIN
+        UpdateSporkValues();
+        // EXOSIS END
         return true;
     }
 
@@ -178,48 +211,12 @@ bool CSporkManager::IsSporkActive(int nSporkID)
 {
     int64_t r = -1;
 
-    if(mapSporksActive.count(nSporkID)){
-        r = mapSporksActive[nSporkID].nValue;
-    } else {
-        switch (nSporkID) {
-            case SPORK_2_INSTANTSEND_ENABLED:               r = SPORK_2_INSTANTSEND_ENABLED_DEFAULT; break;
-            case SPORK_3_INSTANTSEND_BLOCK_FILTERING:       r = SPORK_3_INSTANTSEND_BLOCK_FILTERING_DEFAULT; break;
-            case SPORK_5_INSTANTSEND_MAX_VALUE:             r = SPORK_5_INSTANTSEND_MAX_VALUE_DEFAULT; break;
-            case SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT:    r = SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT_DEFAULT; break;
-            case SPORK_9_SUPERBLOCKS_ENABLED:               r = SPORK_9_SUPERBLOCKS_ENABLED_DEFAULT; break;
-            case SPORK_10_MASTERNODE_PAY_UPDATED_NODES:     r = SPORK_10_MASTERNODE_PAY_UPDATED_NODES_DEFAULT; break;
-            case SPORK_12_RECONSIDER_BLOCKS:                r = SPORK_12_RECONSIDER_BLOCKS_DEFAULT; break;
-            case SPORK_13_OLD_SUPERBLOCK_FLAG:              r = SPORK_13_OLD_SUPERBLOCK_FLAG_DEFAULT; break;
-            case SPORK_14_REQUIRE_SENTINEL_FLAG:            r = SPORK_14_REQUIRE_SENTINEL_FLAG_DEFAULT; break;
-            // EXOSIS BEGIN
-            case SPORK_EXOSIS_01_HANDBRAKE_HEIGHT :           r = SPORK_EXOSIS_01_HANDBRAKE_HEIGHT_DEFAULT; break;
-            case SPORK_EXOSIS_01_HANDBRAKE_FORCE_EXOSIS:      r = SPORK_EXOSIS_01_HANDBRAKE_FORCE_EXOSIS_DEFAULT; break;
-            case SPORK_EXOSIS_01_HANDBRAKE_FORCE_X16R:        r = SPORK_EXOSIS_01_HANDBRAKE_FORCE_X16R_DEFAULT; break;
-
-            case SPORK_EXOSIS_02_IGNORE_SLIGHTLY_HIGHER_COINBASE:     r = SPORK_EXOSIS_02_IGNORE_SLIGHTLY_HIGHER_COINBASE_DEFAULT; break;
-            case SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_CHECK:         r = SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_CHECK_DEFAULT; break;
-            case SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_VALUE:         r = SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_VALUE_DEFAULT; break;
-            case SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_VALUE:      r = SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_VALUE_DEFAULT; break;
-            case SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_PAYEE:      r = SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_PAYEE_DEFAULT; break;
-
-            case SPORK_EXOSIS_03_BLOCK_REWARD_SMOOTH_HALVING_START:   r = SPORK_EXOSIS_03_BLOCK_REWARD_SMOOTH_HALVING_START_DEFAULT; break;
-
-#ifdef EXPERIMENTAL_SPORKS
-            case SPORK_EXOSIS_04_CHECKPOINT_HEIGHT:             r = SPORK_EXOSIS_04_CHECKPOINT_HEIGHT_DEFAULT; break;
-            case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_0_63:      r = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_0_63_DEFAULT; break;
-            case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_64_127:    r = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_64_127_DEFAULT; break;
-            case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_128_191:   r = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_128_191_DEFAULT; break;
-            case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_192_255:   r = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_192_255_DEFAULT; break;
-#endif
-
-            case SPORK_EXOSIS_05_FIX_HEIGHT:                    r = SPORK_EXOSIS_05_FIX_HEIGHT_DEFAULT; break;
-            // EXOSIS END
-            default:
-                LogPrint(BCLog::SPORK, "CSporkManager::IsSporkActive -- Unknown Spork ID %d\n", nSporkID);
-                r = 4070908800ULL; // 2099-1-1 i.e. off by default
-                break;
-        }
+    // EXOSIS BEGIN
+    if (!GetSporkValue(nSporkID, r)) {
+        LogPrint(BCLog::SPORK, "CSporkManager::IsSporkActive -- Unknown Spork ID %d\n", nSporkID);
+        r = 4070908800ULL; // 2099-1-1 i.e. off by default
     }
+    // EXOSIS END
 
     return r < GetAdjustedTime();
 }
@@ -227,49 +224,123 @@ bool CSporkManager::IsSporkActive(int nSporkID)
 // grab the value of the spork on the network, or the default
 int64_t CSporkManager::GetSporkValue(int nSporkID)
 {
-    if (mapSporksActive.count(nSporkID))
-        return mapSporksActive[nSporkID].nValue;
+    // EXOSIS BEGIN
+    int64_t nValue;
+    if (!GetSporkValue(nSporkID, nValue)) {
+        LogPrint(BCLog::SPORK, "CSporkManager::GetSporkValue -- Unknown Spork ID %d\n", nSporkID);
+        return -1;
+    }
+    return nValue;
+    // EXOSIS END
+}
+
+// EXOSIS BEGIN
+int CSporkManager::GetSporkIndex(int nSporkID)
+{
+    if (nSporkID >= SPORK_START && nSporkID <= SPORK_END)
+        return nSporkID - SPORK_START;
+    if (nSporkID >= SPORK_EXOSIS_START && nSporkID <= SPORK_EXOSIS_END)
+        return (SPORK_END - SPORK_START + 1) + nSporkID - SPORK_EXOSIS_START;
+    return -1;
+}
 
+bool CSporkManager::GetSporkDefaultValue(int nSporkID, int64_t& nValueRet)
+{
     switch (nSporkID) {
-        case SPORK_2_INSTANTSEND_ENABLED:               return SPORK_2_INSTANTSEND_ENABLED_DEFAULT;
-        case SPORK_3_INSTANTSEND_BLOCK_FILTERING:       return SPORK_3_INSTANTSEND_BLOCK_FILTERING_DEFAULT;
-        case SPORK_5_INSTANTSEND_MAX_VALUE:             return SPORK_5_INSTANTSEND_MAX_VALUE_DEFAULT;
-        case SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT:    return SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT_DEFAULT;
-        case SPORK_9_SUPERBLOCKS_ENABLED:               return SPORK_9_SUPERBLOCKS_ENABLED_DEFAULT;
-        case SPORK_10_MASTERNODE_PAY_UPDATED_NODES:     return SPORK_10_MASTERNODE_PAY_UPDATED_NODES_DEFAULT;
-        case SPORK_12_RECONSIDER_BLOCKS:                return SPORK_12_RECONSIDER_BLOCKS_DEFAULT;
-        case SPORK_13_OLD_SUPERBLOCK_FLAG:              return SPORK_13_OLD_SUPERBLOCK_FLAG_DEFAULT;
-        case SPORK_14_REQUIRE_SENTINEL_FLAG:            return SPORK_14_REQUIRE_SENTINEL_FLAG_DEFAULT;
+        case SPORK_2_INSTANTSEND_ENABLED:               nValueRet = SPORK_2_INSTANTSEND_ENABLED_DEFAULT; return true;
+        case SPORK_3_INSTANTSEND_BLOCK_FILTERING:       nValueRet = SPORK_3_INSTANTSEND_BLOCK_FILTERING_DEFAULT; return true;
+        case SPORK_5_INSTANTSEND_MAX_VALUE:             nValueRet = SPORK_5_INSTANTSEND_MAX_VALUE_DEFAULT; return true;
+        case SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT:    nValueRet = SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT_DEFAULT; return true;
+        case SPORK_9_SUPERBLOCKS_ENABLED:               nValueRet = SPORK_9_SUPERBLOCKS_ENABLED_DEFAULT; return true;
+        case SPORK_10_MASTERNODE_PAY_UPDATED_NODES:     nValueRet = SPORK_10_MASTERNODE_PAY_UPDATED_NODES_DEFAULT; return true;
+        case SPORK_12_RECONSIDER_BLOCKS:                nValueRet = SPORK_12_RECONSIDER_BLOCKS_DEFAULT; return true;
+        case SPORK_13_OLD_SUPERBLOCK_FLAG:              nValueRet = SPORK_13_OLD_SUPERBLOCK_FLAG_DEFAULT; return true;
+        case SPORK_14_REQUIRE_SENTINEL_FLAG:            nValueRet = SPORK_14_REQUIRE_SENTINEL_FLAG_DEFAULT; return true;
         // EXOSIS BEGIN
-        case SPORK_EXOSIS_01_HANDBRAKE_HEIGHT:            return SPORK_EXOSIS_01_HANDBRAKE_HEIGHT_DEFAULT;
-        case SPORK_EXOSIS_01_HANDBRAKE_FORCE_EXOSIS:      return SPORK_EXOSIS_01_HANDBRAKE_FORCE_EXOSIS_DEFAULT;
-        case SPORK_EXOSIS_01_HANDBRAKE_FORCE_X16R:        return SPORK_EXOSIS_01_HANDBRAKE_FORCE_X16R_DEFAULT;
+        case SPORK_EXOSIS_01_HANDBRAKE_HEIGHT:            nValueRet = SPORK_EXOSIS_01_HANDBRAKE_HEIGHT_DEFAULT; return true;
+        case SPORK_EXOSIS_01_HANDBRAKE_FORCE_EXOSIS:      nValueRet = SPORK_EXOSIS_01_HANDBRAKE_FORCE_EXOSIS_DEFAULT; return true;
+        case SPORK_EXOSIS_01_HANDBRAKE_FORCE_X16R:        nValueRet = SPORK_EXOSIS_01_HANDBRAKE_FORCE_X16R_DEFAULT; return true;
 
-        case SPORK_EXOSIS_02_IGNORE_SLIGHTLY_HIGHER_COINBASE:     return SPORK_EXOSIS_02_IGNORE_SLIGHTLY_HIGHER_COINBASE_DEFAULT;
-        case SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_CHECK:         return SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_CHECK_DEFAULT;
-        case SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_VALUE:         return SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_VALUE_DEFAULT;
-        case SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_VALUE:      return SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_VALUE_DEFAULT;
-        case SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_PAYEE:      return SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_PAYEE_DEFAULT;
+        case SPORK_EXOSIS_02_IGNORE_SLIGHTLY_HIGHER_COINBASE:     nValueRet = SPORK_EXOSIS_02_IGNORE_SLIGHTLY_HIGHER_COINBASE_DEFAULT; return true;
+        case SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_CHECK:         nValueRet = SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_CHECK_DEFAULT; return true;
+        case SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_VALUE:         nValueRet = SPORK_EXOSIS_02_IGNORE_FOUNDER_REWARD_VALUE_DEFAULT; return true;
+        case SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_VALUE:      nValueRet = SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_VALUE_DEFAULT; return true;
+        case SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_PAYEE:      nValueRet = SPORK_EXOSIS_02_IGNORE_MASTERNODE_REWARD_PAYEE_DEFAULT; return true;
 
-        case SPORK_EXOSIS_03_BLOCK_REWARD_SMOOTH_HALVING_START:   return SPORK_EXOSIS_03_BLOCK_REWARD_SMOOTH_HALVING_START_DEFAULT;
+        case SPORK_EXOSIS_03_BLOCK_REWARD_SMOOTH_HALVING_START:   nValueRet = SPORK_EXOSIS_03_BLOCK_REWARD_SMOOTH_HALVING_START_DEFAULT; return true;
 
 #ifdef EXPERIMENTAL_SPORKS
-        case SPORK_EXOSIS_04_CHECKPOINT_HEIGHT:             return SPORK_EXOSIS_04_CHECKPOINT_HEIGHT_DEFAULT;
-        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_0_63:      return SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_0_63_DEFAULT;
-        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_64_127:    return SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_64_127_DEFAULT;
-        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_128_191:   return SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_128_191_DEFAULT;
-        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_192_255:   return SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_192_255_DEFAULT;
+        case SPORK_EXOSIS_04_CHECKPOINT_HEIGHT:             nValueRet = SPORK_EXOSIS_04_CHECKPOINT_HEIGHT_DEFAULT; return true;
+        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_0_63:      nValueRet = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_0_63_DEFAULT; return true;
+        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_64_127:    nValueRet = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_64_127_DEFAULT; return true;
+        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_128_191:   nValueRet = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_128_191_DEFAULT; return true;
+        case SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_192_255:   nValueRet = SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_192_255_DEFAULT; return true;
 #endif
 
-        case SPORK_EXOSIS_05_FIX_HEIGHT:                    return SPORK_EXOSIS_05_FIX_HEIGHT_DEFAULT;
+        case SPORK_EXOSIS_05_FIX_HEIGHT:                    nValueRet = SPORK_EXOSIS_05_FIX_HEIGHT_DEFAULT; return true;
         // EXOSIS END
         default:
-            LogPrint(BCLog::SPORK, "CSporkManager::GetSporkValue -- Unknown Spork ID %d\n", nSporkID);
-            return -1;
+            return false;
+    }
+}
+
+std::unique_ptr<const CSporkValues> CSporkManager::MakeSporkValues() const
+{
+    std::unique_ptr<CSporkValues> pValues(new CSporkValues());
+    for (int nIndex = 0; nIndex < CSporkValues::SIZE; nIndex++) {
+        const int nSporkID = nIndex <= SPORK_END - SPORK_START ? SPORK_START + nIndex : SPORK_EXOSIS_START + nIndex - (SPORK_END - SPORK_START + 1);
+        auto it = mapSporksActive.find(nSporkID);
+        if (it != mapSporksActive.end()) {
+            pValues->nValue[nIndex] = it->second.nValue;
+            pValues->fDefined[nIndex] = true;
+        } else {
+            pValues->fDefined[nIndex] = GetSporkDefaultValue(nSporkID, pValues->nValue[nIndex]);
+        }
+    }
+
+    return pValues;
+}
+
+void CSporkManager::UpdateSporkValues()
+{
+    AssertLockHeld(cs);
+    vSporkValues.push_back(MakeSporkValues());
+    pSporkValues.store(vSporkValues.back().get(), std::memory_order_release);
+}
+
+bool CSporkManager::GetSporkValue(int nSporkID, int64_t& nValueRet)
+{
+    const int nIndex = GetSporkIndex(nSporkID);
+    if (nIndex >= 0) {
+        const CSporkValues* pValues = pSporkValues.load(std::memory_order_acquire);
+        nValueRet = pValues->nValue[nIndex];
+        return pValues->fDefined[nIndex];
     }
 
+    // spork IDs outside of the known ranges are only ever set by a message
+    LOCK(cs);
+    auto it = mapSporksActive.find(nSporkID);
+    if (it == mapSporksActive.end()) return false;
+    nValueRet = it->second.nValue;
+    return true;
 }
 
+bool CSporkManager::HasSpork(const uint256& hash) const
+{
+    LOCK(cs);
+    return mapSporks.count(hash);
+}
+
+bool CSporkManager::GetSporkByHash(const uint256& hash, CSporkMessage& sporkRet) const
+{
+    LOCK(cs);
+    auto it = mapSporks.find(hash);
+    if (it == mapSporks.end()) return false;
+    sporkRet = it->second;
+    return true;
+}
+// EXOSIS END
+
 int CSporkManager::GetSporkIDByName(std::string strName)
 {
     if (strName == "SPORK_2_INSTANTSEND_ENABLED")               return SPORK_2_INSTANTSEND_ENABLED;
@@ -10,8 +10,14 @@
 
 #include <hash.h>
 #include <net.h>
+#include <sync.h>
 #include <util/strencodings.h>
 
+// EXOSIS BEGIN
+#include <atomic>
+#include <memory>
+// EXOSIS END
+
 // EXOSIS BEGIN
 class CSporkDB;
 
@@ -99,9 +105,23 @@ static const int64_t SPORK_EXOSIS_04_CHECKPOINT_HASHBITS_192_255_DEFAULT = 0;
 static const int64_t SPORK_EXOSIS_05_FIX_HEIGHT_DEFAULT                  = 105000;
 // EXOSIS END
 
-extern std::map<uint256, CSporkMessage> mapSporks;
+// EXOSIS BEGIN
+//extern std::map<uint256, CSporkMessage> mapSporks;
+// EXOSIS END
 extern CSporkManager sporkManager;
 
+// EXOSIS BEGIN
+/** Value of every spork, indexed by CSporkManager::GetSporkIndex() */
+struct CSporkValues
+{
+    static const int SIZE = (SPORK_END - SPORK_START + 1) + (SPORK_EXOSIS_END - SPORK_EXOSIS_START + 1);
+
+    int64_t nValue[SIZE];
+    // false for the unused spork IDs we have neither a default nor a message for
+    bool fDefined[SIZE];
+};
+// EXOSIS END
+
 //
 // Spork classes
 // Keep track of all of the network spork settings
@@ -160,21 +180,49 @@ class CSporkManager
 private:
     std::vector<unsigned char> vchSig;
     std::string strMasterPrivKey;
+    // EXOSIS BEGIN
+    mutable CCriticalSection cs;
+    std::map<uint256, CSporkMessage> mapSporks;
+    // EXOSIS END
     std::map<int, CSporkMessage> mapSporksActive;
+    // EXOSIS BEGIN
+    // Immutable snapshot of all spork values, replaced whenever a spork
+    // changes so that readers need neither cs nor a map lookup. Replaced
+    // snapshots are never freed, a reader may still be indexing one; sporks
+    // change rarely enough for that to stay small.
+    std::atomic<const CSporkValues*> pSporkValues;
+    std::vector<std::unique_ptr<const CSporkValues>> vSporkValues;
+
+    static int GetSporkIndex(int nSporkID);
+    static bool GetSporkDefaultValue(int nSporkID, int64_t& nValueRet);
+    std::unique_ptr<const CSporkValues> MakeSporkValues() const;
+    /** Publish a new snapshot of mapSporksActive, cs must be held */
+    void UpdateSporkValues();
+    bool GetSporkValue(int nSporkID, int64_t& nValueRet);
+    // EXOSIS END
 
 public:
 
-    CSporkManager() {}
+    // EXOSIS BEGIN
+    //CSporkManager() {}
+    CSporkManager();
+    // EXOSIS END
 
     // EXOSIS BEGIN
     void LoadSporksFromDB();
+    //void ProcessSpork(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    void ProcessSporkMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
+    void ProcessGetSporksMessage(CNode* pfrom, CDataStream& vRecv, CConnman& connman);
     // EXOSIS END
-    void ProcessSpork(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
     void ExecuteSpork(int nSporkID, int nValue);
     bool UpdateSpork(int nSporkID, int64_t nValue, CConnman& connman);
 
     bool IsSporkActive(int nSporkID);
     int64_t GetSporkValue(int nSporkID);
+    // EXOSIS BEGIN
+    bool HasSpork(const uint256& hash) const;
+    bool GetSporkByHash(const uint256& hash, CSporkMessage& sporkRet) const;
+    // EXOSIS END
     int GetSporkIDByName(std::string strName);
     std::string GetSporkNameByID(int nSporkID);
 
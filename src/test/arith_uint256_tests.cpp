@@ -359,6 +359,14 @@ BOOST_AUTO_TEST_CASE( divide )
     BOOST_CHECK(R2L / MaxL == ZeroL);
     BOOST_CHECK(MaxL / R2L == 1);
     BOOST_CHECK_THROW(R2L / ZeroL, uint_error);
+    // EXOSIS BEGIN
+    // single word divisors
+    arith_uint256 D3L("ECD75171");
+    BOOST_CHECK((R1L / D3L).ToString() == "00000000873ce8f0232c78cb02ea3cb01923abec87a015433f2339690c131cd2");
+    BOOST_CHECK((R2L / 576).ToString() == "005fc7e8506add5de7c0d2beb60faddc7a8e18459f73211b9f391365e6e1d416");
+    BOOST_CHECK((R1L / 0xffffffff).ToString() == "000000007d1de5eb76cf3cc0a8d82cf45e82ae173154e3748f670c9fa178636f");
+    BOOST_CHECK(OneL / 2 == ZeroL);
+    // EXOSIS END
 }
 
 
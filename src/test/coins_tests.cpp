@@ -858,4 +858,54 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+// EXOSIS BEGIN
+BOOST_AUTO_TEST_CASE(ccoins_undo_masternode_collateral)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    const CScript script = GetScriptForDestination(key.GetPubKey().GetID());
+
+    // A masternode collateral and a plain output of the same value
+    CMutableTransaction mprevtx;
+    mprevtx.vin.emplace_back(COutPoint(InsecureRand256(), 0));
+    mprevtx.vout.emplace_back(100000 * COIN, script, "1.2.3.4", key.GetPubKey());
+    mprevtx.vout.emplace_back(100000 * COIN, script);
+    const CTransaction prevtx(mprevtx);
+
+    CCoinsView base;
+    CCoinsViewCache view(&base);
+    AddCoins(view, prevtx, 1);
+
+    CMutableTransaction mtx;
+    mtx.vin.emplace_back(COutPoint(prevtx.GetHash(), 0));
+    mtx.vin.emplace_back(COutPoint(prevtx.GetHash(), 1));
+    mtx.vout.emplace_back(200000 * COIN, script);
+    const CTransaction tx(mtx);
+
+    // The undo data is read back from its disk serialization, as DisconnectBlock does
+    CTxUndo txundo;
+    UpdateCoins(tx, view, txundo, 2);
+    CDataStream ss(SER_DISK, 0);
+    ss << txundo;
+    CTxUndo txundoRead;
+    ss >> txundoRead;
+    BOOST_CHECK(ss.empty());
+    BOOST_REQUIRE_EQUAL(txundoRead.vprevout.size(), tx.vin.size());
+
+    // Each spent output matches the one the previous transaction lookup used to return
+    for (unsigned int j = tx.vin.size(); j-- > 0;) {
+        const COutPoint& out = tx.vin[j].prevout;
+        const CTxOut& txoutBaseline = prevtx.vout[out.n];
+        const CTxOut& txout = txundoRead.vprevout[j].out;
+        BOOST_CHECK(txout == txoutBaseline);
+        BOOST_CHECK_EQUAL(txout.GetMasternodeIP(), txoutBaseline.GetMasternodeIP());
+        BOOST_CHECK(txout.GetPubKeyMN() == txoutBaseline.GetPubKeyMN());
+        BOOST_CHECK_EQUAL(txout.nValue == 100000 * COIN && txout.GetMasternodeIP() != "", out.n == 0);
+
+        ApplyTxInUndo(std::move(txundoRead.vprevout[j]), view, out);
+        BOOST_CHECK(view.AccessCoin(out).out == txoutBaseline);
+    }
+}
+// EXOSIS END
+
 BOOST_AUTO_TEST_SUITE_END()
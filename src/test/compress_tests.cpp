@@ -5,6 +5,12 @@
 #include <compressor.h>
 #include <util/system.h>
 #include <test/test_bitcoin.h>
+// EXOSIS BEGIN
+#include <core_memusage.h>
+#include <key.h>
+#include <script/standard.h>
+#include <streams.h>
+// EXOSIS END
 
 #include <stdint.h>
 
@@ -62,4 +68,48 @@ BOOST_AUTO_TEST_CASE(compress_amounts)
         BOOST_CHECK(TestDecode(i));
 }
 
+// EXOSIS BEGIN
+BOOST_AUTO_TEST_CASE(compress_masternode_collateral)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    const CScript script = GetScriptForDestination(key.GetPubKey().GetID());
+
+    const CTxOut collateral(100000 * COIN, script, "1.2.3.4", key.GetPubKey());
+    const CTxOut plain(100000 * COIN, script);
+    BOOST_CHECK(collateral.GetExtension() != nullptr);
+    BOOST_CHECK(plain.GetExtension() == nullptr);
+    BOOST_CHECK(RecursiveDynamicUsage(collateral) > RecursiveDynamicUsage(plain));
+
+    CTxOut copy(collateral);
+    BOOST_CHECK(copy == collateral);
+    copy = plain;
+    BOOST_CHECK(copy == plain && copy.GetExtension() == nullptr);
+
+    // the one script whose 100000 coin outputs are serialized without masternode data
+    const std::vector<unsigned char> vchExcluded = ParseHex("76a9142512f68cb0d161dee3c70f66caf6ba3ce8bb4e2788ac");
+    const CScript scriptExcluded(vchExcluded.begin(), vchExcluded.end());
+    BOOST_CHECK(CTxOut::HasMasternodeData(100000 * COIN, script));
+    BOOST_CHECK(!CTxOut::HasMasternodeData(100000 * COIN, scriptExcluded));
+    BOOST_CHECK(!CTxOut::HasMasternodeData(100000 * COIN - 1, script));
+
+    // the masternode data survives both serializations, and is only allocated when present
+    for (const CTxOut& txout : {collateral, plain}) {
+        CDataStream ss(SER_DISK, 0);
+        ss << txout;
+        ss << CTxOutCompressor(REF(txout));
+
+        CTxOut txout2, txout3;
+        ss >> txout2;
+        ss >> REF(CTxOutCompressor(txout3));
+        BOOST_CHECK(ss.empty());
+        for (const CTxOut& txoutRead : {txout2, txout3}) {
+            BOOST_CHECK(txoutRead == txout);
+            BOOST_CHECK_EQUAL(txoutRead.GetMasternodeIP(), txout.GetMasternodeIP());
+            BOOST_CHECK((txoutRead.GetExtension() == nullptr) == (txout.GetExtension() == nullptr));
+        }
+    }
+}
+// EXOSIS END
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,258 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <hash.h>
+#include <net.h>
+#include <net_processing.h>
+#include <netmessagemaker.h>
+#include <random.h>
+#include <rpc/server.h>
+#include <spork.h>
+#include <streams.h>
+#include <validation.h>
+
+#include <test/test_bitcoin.h>
+
+#include <atomic>
+#include <map>
+#include <string.h>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <univalue.h>
+
+namespace {
+
+/** Hand a message to the peer the way the socket handler does */
+void ReceiveMessage(CNode& node, CSerializedNetMsg&& msg)
+{
+    CMessageHeader hdr(Params().MessageStart(), msg.command.c_str(), msg.data.size());
+    uint256 hash = Hash(msg.data.data(), msg.data.data() + msg.data.size());
+    memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
+
+    std::vector<unsigned char> vBytes;
+    CVectorWriter{SER_NETWORK, INIT_PROTO_VERSION, vBytes, 0, hdr};
+    vBytes.insert(vBytes.end(), msg.data.begin(), msg.data.end());
+
+    CNetMessage netmsg(Params().MessageStart(), SER_NETWORK, INIT_PROTO_VERSION);
+    const char* pch = reinterpret_cast<const char*>(vBytes.data());
+    const int nHandled = netmsg.readHeader(pch, vBytes.size());
+    BOOST_REQUIRE(nHandled > 0);
+    BOOST_REQUIRE(netmsg.readData(pch + nHandled, vBytes.size() - nHandled) >= 0);
+    BOOST_REQUIRE(netmsg.complete());
+
+    LOCK(node.cs_vProcessMsg);
+    node.nProcessQueueSize += netmsg.vRecv.size() + CMessageHeader::HEADER_SIZE;
+    node.vProcessMsg.push_back(std::move(netmsg));
+}
+
+uint64_t GetProcessedCount(const std::string& strCommand)
+{
+    std::vector<CDashMessageStats> vStats;
+    GetDashMessageStats(vStats);
+    for (const CDashMessageStats& stats : vStats) {
+        if (stats.strCommand == strCommand) return stats.nCount;
+    }
+    return 0;
+}
+
+UniValue GetMessageStatsRPC()
+{
+    JSONRPCRequest request;
+    request.strMethod = "getmessagestats";
+    request.params = UniValue(UniValue::VARR);
+    request.fHelp = false;
+    BOOST_REQUIRE(tableRPC["getmessagestats"]);
+    return tableRPC["getmessagestats"]->actor(request);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(dashmessage_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(dashmessage_queue_concurrent)
+{
+    auto peerLogic = MakeUnique<PeerLogicValidation>(g_connman.get(), nullptr, scheduler, false);
+
+    CAddress addr(CService(CNetAddr(), Params().GetDefaultPort()), NODE_NONE);
+    CNode node(0, NODE_NETWORK, 0, INVALID_SOCKET, addr, 0, 0, CAddress(), "", true);
+    node.SetSendVersion(PROTOCOL_VERSION);
+    peerLogic->InitializeNode(&node);
+    node.nVersion = 1;
+    node.fSuccessfullyConnected = true;
+
+    const uint64_t nProcessedBefore = GetProcessedCount(NetMsgType::SPORK);
+    StartDashMessageQueues();
+
+    // More messages than a peer may have waiting in one queue, so the
+    // handler also has to hold messages back until the worker catches up
+    const int nMessages = 500;
+    std::vector<uint256> vHashes;
+    for (int i = 0; i < nMessages; i++) {
+        // not signed, the worker clears the request and then rejects it
+        CSporkMessage spork(SPORK_5_INSTANTSEND_MAX_VALUE, i, GetTime());
+        vHashes.push_back(spork.GetHash());
+        {
+            LOCK(cs_main);
+            node.AskFor(CInv(MSG_SPORK, spork.GetHash()));
+        }
+        ReceiveMessage(node, CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::SPORK, spork));
+    }
+
+    // Act as the message handler thread: keep requesting other items from
+    // the peer while the worker clears the spork requests
+    std::atomic<bool> interrupt(false);
+    const int64_t nStart = GetTimeMillis();
+    while (GetProcessedCount(NetMsgType::SPORK) - nProcessedBefore < (uint64_t)nMessages) {
+        {
+            LOCK(cs_main);
+            node.AskFor(CInv(MSG_TX, GetRandHash()));
+        }
+        peerLogic->ProcessMessages(&node, interrupt);
+        BOOST_REQUIRE(GetTimeMillis() - nStart < 60 * 1000);
+    }
+
+    StopDashMessageQueues();
+
+    {
+        LOCK(node.cs_vProcessMsg);
+        BOOST_CHECK(node.vProcessMsg.empty());
+    }
+    {
+        LOCK(node.cs_askfor);
+        for (const uint256& hash : vHashes) {
+            BOOST_CHECK(!node.setAskFor.count(hash));
+        }
+    }
+    BOOST_CHECK(node.GetAskForCount() > 0);
+
+    bool dummy;
+    peerLogic->FinalizeNode(node.GetId(), dummy);
+}
+
+BOOST_AUTO_TEST_CASE(dashmessage_queue_peer_order)
+{
+    auto peerLogic = MakeUnique<PeerLogicValidation>(g_connman.get(), nullptr, scheduler, false);
+
+    CAddress addr(CService(CNetAddr(), Params().GetDefaultPort()), NODE_NONE);
+    CNode node(2, NODE_NETWORK, 0, INVALID_SOCKET, addr, 2, 2, CAddress(), "", true);
+    node.SetSendVersion(PROTOCOL_VERSION);
+    peerLogic->InitializeNode(&node);
+    node.nVersion = 1;
+    node.fSuccessfullyConnected = true;
+
+    const uint64_t nSporksBefore = GetProcessedCount(NetMsgType::SPORK);
+    const uint64_t nSyncBefore = GetProcessedCount(NetMsgType::SYNCSTATUSCOUNT);
+    StartDashMessageQueues();
+
+    // sporks, a message for another queue, then more sporks
+    const int nMessages = 150;
+    for (int i = 0; i < 2 * nMessages + 1; i++) {
+        if (i == nMessages) {
+            ReceiveMessage(node, CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::SYNCSTATUSCOUNT, 0, 0));
+        } else {
+            ReceiveMessage(node, CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::SPORK, CSporkMessage(SPORK_5_INSTANTSEND_MAX_VALUE, i, GetTime())));
+        }
+    }
+
+    std::atomic<bool> interrupt(false);
+    const int64_t nStart = GetTimeMillis();
+    while (true) {
+        // the counters are read around each other as the workers keep running; a message is
+        // counted as processed before it stops counting towards the receive flood size
+        size_t nQueueSize;
+        {
+            LOCK(node.cs_vProcessMsg);
+            nQueueSize = node.nProcessQueueSize;
+        }
+        const uint64_t nSyncFirst = GetProcessedCount(NetMsgType::SYNCSTATUSCOUNT) - nSyncBefore;
+        const uint64_t nSporks = GetProcessedCount(NetMsgType::SPORK) - nSporksBefore;
+        const uint64_t nSync = GetProcessedCount(NetMsgType::SYNCSTATUSCOUNT) - nSyncBefore;
+        // the message for the other queue runs after the sporks ahead of it and before the ones behind it
+        BOOST_REQUIRE(nSyncFirst == 0 || nSporks >= (uint64_t)nMessages);
+        BOOST_REQUIRE(nSporks <= (uint64_t)nMessages || nSync == 1);
+        if (nSporks == 2 * (uint64_t)nMessages && nSync == 1) break;
+        // queued messages still count towards the receive flood size
+        BOOST_REQUIRE(nQueueSize > 0);
+        peerLogic->ProcessMessages(&node, interrupt);
+        BOOST_REQUIRE(GetTimeMillis() - nStart < 60 * 1000);
+    }
+
+    StopDashMessageQueues();
+
+    {
+        LOCK(node.cs_vProcessMsg);
+        BOOST_CHECK(node.vProcessMsg.empty());
+        BOOST_CHECK_EQUAL(node.nProcessQueueSize, 0U);
+        BOOST_CHECK(!node.fPauseRecv);
+    }
+
+    bool dummy;
+    peerLogic->FinalizeNode(node.GetId(), dummy);
+}
+
+BOOST_AUTO_TEST_CASE(dashmessage_stats)
+{
+    const std::map<std::string, std::string> mapQueues = {
+        {NetMsgType::DSACCEPT, "dsqueue"}, {NetMsgType::DSVIN, "dsqueue"}, {NetMsgType::DSQUEUE, "dsqueue"},
+        {NetMsgType::DSSIGNFINALTX, "dsqueue"}, {NetMsgType::DSCOMPLETE, "dsqueue"}, {NetMsgType::DSFINALTX, "dsqueue"},
+        {NetMsgType::DSSTATUSUPDATE, "dsqueue"},
+        {NetMsgType::MNANNOUNCE, "mnqueue"}, {NetMsgType::MNPING, "mnqueue"}, {NetMsgType::DSEG, "mnqueue"},
+        {NetMsgType::MNVERIFY, "mnqueue"},
+        {NetMsgType::MASTERNODEPAYMENTSYNC, "mnpqueue"}, {NetMsgType::MASTERNODEPAYMENTVOTE, "mnpqueue"},
+        {NetMsgType::TXLOCKVOTE, "isqueue"},
+        {NetMsgType::SPORK, "sporkqueue"}, {NetMsgType::GETSPORKS, "sporkqueue"},
+        {NetMsgType::SYNCSTATUSCOUNT, "mnsqueue"},
+        {NetMsgType::MNGOVERNANCEOBJECT, "govqueue"}, {NetMsgType::MNGOVERNANCEOBJECTVOTE, "govqueue"},
+        {NetMsgType::MNGOVERNANCESYNC, "govqueue"},
+    };
+
+    // every command has exactly one handler
+    const UniValue statsBefore = GetMessageStatsRPC();
+    BOOST_REQUIRE(statsBefore.isObject());
+    BOOST_CHECK_EQUAL(statsBefore.size(), mapQueues.size());
+    for (const auto& pair : mapQueues) {
+        const UniValue& objCommand = find_value(statsBefore, pair.first);
+        BOOST_REQUIRE(objCommand.isObject());
+        BOOST_CHECK_EQUAL(find_value(objCommand, "queue").get_str(), pair.second);
+        BOOST_CHECK_EQUAL(find_value(objCommand, "queuepending").get_int64(), 0);
+        BOOST_CHECK(find_value(objCommand, "maxtime").get_int64() <= find_value(objCommand, "totaltime").get_int64());
+    }
+
+    auto peerLogic = MakeUnique<PeerLogicValidation>(g_connman.get(), nullptr, scheduler, false);
+
+    CAddress addr(CService(CNetAddr(), Params().GetDefaultPort()), NODE_NONE);
+    CNode node(1, NODE_NETWORK, 0, INVALID_SOCKET, addr, 1, 1, CAddress(), "", true);
+    node.SetSendVersion(PROTOCOL_VERSION);
+    peerLogic->InitializeNode(&node);
+    node.nVersion = 1;
+    node.fSuccessfullyConnected = true;
+
+    StartDashMessageQueues();
+    ReceiveMessage(node, CNetMsgMaker(PROTOCOL_VERSION).Make(NetMsgType::GETSPORKS));
+    std::atomic<bool> interrupt(false);
+    const uint64_t nGetSporksBefore = find_value(find_value(statsBefore, NetMsgType::GETSPORKS), "count").get_int64();
+    const int64_t nStart = GetTimeMillis();
+    while (GetProcessedCount(NetMsgType::GETSPORKS) == nGetSporksBefore) {
+        peerLogic->ProcessMessages(&node, interrupt);
+        BOOST_REQUIRE(GetTimeMillis() - nStart < 60 * 1000);
+    }
+    StopDashMessageQueues();
+
+    // only the handler of the received command ran
+    const UniValue statsAfter = GetMessageStatsRPC();
+    for (const auto& pair : mapQueues) {
+        const int64_t nCountBefore = find_value(find_value(statsBefore, pair.first), "count").get_int64();
+        const UniValue& objCommand = find_value(statsAfter, pair.first);
+        BOOST_CHECK_EQUAL(find_value(objCommand, "count").get_int64(), nCountBefore + (pair.first == NetMsgType::GETSPORKS ? 1 : 0));
+        BOOST_CHECK(find_value(objCommand, "avgtime").get_int64() <= find_value(objCommand, "maxtime").get_int64());
+    }
+
+    bool dummy;
+    peerLogic->FinalizeNode(node.GetId(), dummy);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
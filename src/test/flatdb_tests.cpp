@@ -0,0 +1,128 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <flat-database.h>
+#include <random.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+struct CTestCache
+{
+    std::vector<uint256> vHashes;
+    int nCheckAndRemoveCalls = 0;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(vHashes);
+    }
+
+    void Clear() { vHashes.clear(); }
+    void CheckAndRemove() { ++nCheckAndRemoveCalls; }
+    std::string ToString() const { return strprintf("Hashes: %d", vHashes.size()); }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(flatdb_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(flatdb_roundtrip)
+{
+    const fs::path pathDataDir = SetDataDir("flatdb_roundtrip");
+    ClearDatadirCache();
+
+    // More than two chunks worth of data
+    CTestCache cacheOut;
+    for (size_t i = 0; i < (2 * FLATDB_CHUNK_SIZE) / sizeof(uint256) + 100; i++) {
+        cacheOut.vHashes.push_back(InsecureRand256());
+    }
+
+    CFlatDB<CTestCache> flatdb("test.dat", "magicTestCache");
+    BOOST_CHECK(flatdb.Dump(cacheOut));
+    BOOST_CHECK(!fs::exists(pathDataDir / "test.dat.new"));
+
+    CTestCache cacheIn;
+    BOOST_CHECK(flatdb.Load(cacheIn));
+    BOOST_CHECK(cacheIn.vHashes == cacheOut.vHashes);
+    BOOST_CHECK_EQUAL(cacheIn.nCheckAndRemoveCalls, 1);
+
+    // A file written for another object type is refused
+    CFlatDB<CTestCache> flatdbOther("test.dat", "magicOtherCache");
+    CTestCache cacheOther;
+    BOOST_CHECK(!flatdbOther.Load(cacheOther));
+
+    // Flip one byte in the last chunk
+    const uint64_t nFileSize = fs::file_size(pathDataDir / "test.dat");
+    FILE* file = fsbridge::fopen(pathDataDir / "test.dat", "rb+");
+    BOOST_REQUIRE(file);
+    BOOST_REQUIRE_EQUAL(fseek(file, nFileSize - 10, SEEK_SET), 0);
+    int nByte = fgetc(file);
+    BOOST_REQUIRE_EQUAL(fseek(file, nFileSize - 10, SEEK_SET), 0);
+    fputc(nByte ^ 0xff, file);
+    fclose(file);
+
+    CTestCache cacheCorrupted;
+    BOOST_CHECK(!flatdb.Load(cacheCorrupted));
+    BOOST_CHECK(cacheCorrupted.vHashes.empty());
+
+    // The next dump does not read the old file, it replaces it
+    BOOST_CHECK(flatdb.Dump(cacheOut));
+    BOOST_CHECK_EQUAL(fs::file_size(pathDataDir / "test.dat"), nFileSize);
+    CTestCache cacheRewritten;
+    BOOST_CHECK(flatdb.Load(cacheRewritten));
+    BOOST_CHECK(cacheRewritten.vHashes == cacheOut.vHashes);
+
+    // A truncated file is refused
+    fs::resize_file(pathDataDir / "test.dat", nFileSize - 1);
+    CTestCache cacheTruncated;
+    BOOST_CHECK(!flatdb.Load(cacheTruncated));
+    BOOST_CHECK(cacheTruncated.vHashes.empty());
+
+    // A missing file is recreated
+    fs::remove(pathDataDir / "test.dat");
+    CTestCache cacheMissing;
+    BOOST_CHECK(flatdb.Load(cacheMissing));
+    BOOST_CHECK(cacheMissing.vHashes.empty());
+    BOOST_CHECK_EQUAL(cacheMissing.nCheckAndRemoveCalls, 0);
+}
+
+BOOST_AUTO_TEST_CASE(flatdb_legacy_format)
+{
+    const fs::path pathDataDir = SetDataDir("flatdb_legacy_format");
+    ClearDatadirCache();
+
+    CTestCache cacheOut;
+    for (int i = 0; i < 100; i++) {
+        cacheOut.vHashes.push_back(InsecureRand256());
+    }
+
+    // magic message, network magic, object, hash of all of the above
+    CDataStream ssObj(SER_DISK, CLIENT_VERSION);
+    ssObj << std::string("magicTestCache") << Params().MessageStart() << cacheOut;
+    uint256 hash = Hash(ssObj.begin(), ssObj.end());
+    ssObj << hash;
+    {
+        CAutoFile fileout(fsbridge::fopen(pathDataDir / "legacy.dat", "wb"), SER_DISK, CLIENT_VERSION);
+        BOOST_REQUIRE(!fileout.IsNull());
+        fileout << ssObj;
+    }
+
+    CFlatDB<CTestCache> flatdb("legacy.dat", "magicTestCache");
+    CTestCache cacheIn;
+    BOOST_CHECK(flatdb.Load(cacheIn));
+    BOOST_CHECK(cacheIn.vHashes == cacheOut.vHashes);
+
+    // The next dump replaces it with the chunked format
+    BOOST_CHECK(flatdb.Dump(cacheIn));
+    CTestCache cacheReloaded;
+    BOOST_CHECK(flatdb.Load(cacheReloaded));
+    BOOST_CHECK(cacheReloaded.vHashes == cacheOut.vHashes);
+    BOOST_CHECK(fs::file_size(pathDataDir / "legacy.dat") != ssObj.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,205 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governance-votedb.h>
+#include <streams.h>
+#include <test/test_bitcoin.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+CGovernanceVote MakeVote(const COutPoint& outpointMasternode, const uint256& nParentHash, vote_outcome_enum_t eOutcome, int64_t nTime, size_t nSigSize)
+{
+    CGovernanceVote vote(outpointMasternode, nParentHash, VOTE_SIGNAL_FUNDING, eOutcome);
+    vote.SetTime(nTime);
+    std::vector<unsigned char> vchSig(nSigSize);
+    for (unsigned char& ch : vchSig) {
+        ch = InsecureRandBits(8);
+    }
+    vote.SetSignature(vchSig);
+    return vote;
+}
+
+void CheckVote(const CGovernanceObjectVoteFile& file, const CGovernanceVote& vote)
+{
+    BOOST_CHECK(file.HasVote(vote.GetHash()));
+    CGovernanceVote voteRet;
+    BOOST_REQUIRE(file.GetVote(vote.GetHash(), voteRet));
+    BOOST_CHECK(voteRet == vote);
+    BOOST_CHECK(voteRet.GetHash() == vote.GetHash());
+    BOOST_CHECK(voteRet.GetMasternodeOutpoint() == vote.GetMasternodeOutpoint());
+    BOOST_CHECK(voteRet.GetSignature() == vote.GetSignature());
+}
+
+/** Votes as returned by GetVotes, newest first */
+void CheckVotes(const CGovernanceObjectVoteFile& file, const std::vector<CGovernanceVote>& vecVotesNewestFirst)
+{
+    BOOST_CHECK_EQUAL(file.GetVoteCount(), (int)vecVotesNewestFirst.size());
+    std::vector<CGovernanceVote> vecVotes = file.GetVotes();
+    BOOST_REQUIRE_EQUAL(vecVotes.size(), vecVotesNewestFirst.size());
+    for (size_t i = 0; i < vecVotes.size(); i++) {
+        BOOST_CHECK(vecVotes[i] == vecVotesNewestFirst[i]);
+        BOOST_CHECK(vecVotes[i].GetSignature() == vecVotesNewestFirst[i].GetSignature());
+        CheckVote(file, vecVotesNewestFirst[i]);
+    }
+}
+
+CGovernanceObjectVoteFile RoundTrip(const CGovernanceObjectVoteFile& file)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << file;
+    CGovernanceObjectVoteFile fileRet;
+    ss >> fileRet;
+    BOOST_CHECK(ss.empty());
+    return fileRet;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(governance_votedb_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(votedb_roundtrip)
+{
+    const uint256 nParentHash = InsecureRand256();
+    const COutPoint outpoint1(InsecureRand256(), 0);
+    const COutPoint outpoint2(InsecureRand256(), 1);
+
+    CGovernanceObjectVoteFile file;
+    std::vector<CGovernanceVote> vecVotes;
+    vecVotes.push_back(MakeVote(outpoint1, nParentHash, VOTE_OUTCOME_YES, 1000, 65));
+    vecVotes.push_back(MakeVote(outpoint2, nParentHash, VOTE_OUTCOME_NO, 1001, 65));
+    vecVotes.push_back(MakeVote(outpoint1, nParentHash, VOTE_OUTCOME_ABSTAIN, 1002, 70));
+    vecVotes.push_back(MakeVote(outpoint2, nParentHash, VOTE_OUTCOME_YES, 1003, 0));
+    for (const CGovernanceVote& vote : vecVotes) {
+        file.AddVote(vote);
+    }
+    const std::vector<CGovernanceVote> vecNewestFirst(vecVotes.rbegin(), vecVotes.rend());
+
+    CheckVotes(file, vecNewestFirst);
+    BOOST_CHECK(!file.HasVote(InsecureRand256()));
+
+    CGovernanceObjectVoteFile fileLoaded = RoundTrip(file);
+    CheckVotes(fileLoaded, vecNewestFirst);
+
+    // iteration matches GetVotes
+    size_t i = 0;
+    for (const CGovernanceObjectVoteFile::CVoteRef& vote : fileLoaded) {
+        BOOST_REQUIRE(i < vecNewestFirst.size());
+        BOOST_CHECK(vote.GetHash() == vecNewestFirst[i].GetHash());
+        BOOST_CHECK(vote.GetMasternodeOutpoint() == vecNewestFirst[i].GetMasternodeOutpoint());
+        BOOST_CHECK_EQUAL(vote.GetTimestamp(), vecNewestFirst[i].GetTimestamp());
+        i++;
+    }
+    BOOST_CHECK_EQUAL(i, vecNewestFirst.size());
+}
+
+BOOST_AUTO_TEST_CASE(votedb_rebuild_index_drops_duplicates)
+{
+    const uint256 nParentHash = InsecureRand256();
+    const COutPoint outpoint1(InsecureRand256(), 0);
+    const COutPoint outpoint2(InsecureRand256(), 0);
+
+    CGovernanceVote vote1 = MakeVote(outpoint1, nParentHash, VOTE_OUTCOME_YES, 1000, 65);
+    CGovernanceVote vote2 = MakeVote(outpoint2, nParentHash, VOTE_OUTCOME_NO, 1001, 65);
+    CGovernanceVote vote3 = MakeVote(outpoint2, nParentHash, VOTE_OUTCOME_YES, 1002, 65);
+
+    CGovernanceObjectVoteFile file;
+    file.AddVote(vote1);
+    file.AddVote(vote2);
+    file.AddVote(vote1);
+    file.AddVote(vote3);
+    BOOST_CHECK_EQUAL(file.GetVoteCount(), 4);
+
+    // the first copy of a vote is kept
+    CGovernanceObjectVoteFile fileLoaded = RoundTrip(file);
+    CheckVotes(fileLoaded, {vote3, vote2, vote1});
+
+    // the signature of the dropped copy is reclaimed by the next compaction
+    fileLoaded.RemoveVotesFromMasternode(outpoint1);
+    CheckVotes(fileLoaded, {vote3, vote2});
+    CGovernanceObjectVoteFile fileCompacted = RoundTrip(fileLoaded);
+    CheckVotes(fileCompacted, {vote3, vote2});
+}
+
+BOOST_AUTO_TEST_CASE(votedb_rebuild_index_rejects_invalid_records)
+{
+    const COutPoint outpoint(InsecureRand256(), 0);
+    CGovernanceObjectVoteFile::CVoteRecord record1{0, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES, 65, 65, 1000};
+    CGovernanceObjectVoteFile::CVoteRecord record2{0, VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_NO, 65, 0, 1001};
+
+    // signatures out of record order
+    {
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss << InsecureRand256() << std::vector<COutPoint>{outpoint} << std::vector<CGovernanceObjectVoteFile::CVoteRecord>{record1, record2} << std::vector<unsigned char>(130);
+        CGovernanceObjectVoteFile file;
+        BOOST_CHECK_THROW(ss >> file, std::ios_base::failure);
+    }
+
+    // signature past the end of the buffer
+    {
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss << InsecureRand256() << std::vector<COutPoint>{outpoint} << std::vector<CGovernanceObjectVoteFile::CVoteRecord>{record1} << std::vector<unsigned char>(100);
+        CGovernanceObjectVoteFile file;
+        BOOST_CHECK_THROW(ss >> file, std::ios_base::failure);
+    }
+
+    // unknown masternode
+    {
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss << InsecureRand256() << std::vector<COutPoint>{} << std::vector<CGovernanceObjectVoteFile::CVoteRecord>{record2} << std::vector<unsigned char>(65);
+        CGovernanceObjectVoteFile file;
+        BOOST_CHECK_THROW(ss >> file, std::ios_base::failure);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(votedb_remove_masternode)
+{
+    const uint256 nParentHash = InsecureRand256();
+    const COutPoint outpoint1(InsecureRand256(), 0);
+    const COutPoint outpoint2(InsecureRand256(), 0);
+    const COutPoint outpoint3(InsecureRand256(), 0);
+
+    CGovernanceVote vote1a = MakeVote(outpoint1, nParentHash, VOTE_OUTCOME_YES, 1000, 65);
+    CGovernanceVote vote2a = MakeVote(outpoint2, nParentHash, VOTE_OUTCOME_YES, 1001, 66);
+    CGovernanceVote vote3a = MakeVote(outpoint3, nParentHash, VOTE_OUTCOME_NO, 1002, 67);
+    CGovernanceVote vote2b = MakeVote(outpoint2, nParentHash, VOTE_OUTCOME_NO, 1003, 68);
+    CGovernanceVote vote3b = MakeVote(outpoint3, nParentHash, VOTE_OUTCOME_YES, 1004, 69);
+
+    CGovernanceObjectVoteFile file;
+    for (const CGovernanceVote& vote : {vote1a, vote2a, vote3a, vote2b, vote3b}) {
+        file.AddVote(vote);
+    }
+
+    // unknown masternode is a no-op
+    file.RemoveVotesFromMasternode(COutPoint(InsecureRand256(), 0));
+    CheckVotes(file, {vote3b, vote2b, vote3a, vote2a, vote1a});
+
+    // the votes of the later masternode move down to the removed one's index
+    file.RemoveVotesFromMasternode(outpoint2);
+    BOOST_CHECK(!file.HasVote(vote2a.GetHash()));
+    BOOST_CHECK(!file.HasVote(vote2b.GetHash()));
+    CheckVotes(file, {vote3b, vote3a, vote1a});
+
+    // the remapped masternode index is used for new votes
+    CGovernanceVote vote3c = MakeVote(outpoint3, nParentHash, VOTE_OUTCOME_ABSTAIN, 1005, 70);
+    CGovernanceVote vote2c = MakeVote(outpoint2, nParentHash, VOTE_OUTCOME_ABSTAIN, 1006, 71);
+    file.AddVote(vote3c);
+    file.AddVote(vote2c);
+    CheckVotes(file, {vote2c, vote3c, vote3b, vote3a, vote1a});
+    CheckVotes(RoundTrip(file), {vote2c, vote3c, vote3b, vote3a, vote1a});
+
+    file.RemoveVotesFromMasternode(outpoint1);
+    file.RemoveVotesFromMasternode(outpoint3);
+    CheckVotes(file, {vote2c});
+    CheckVotes(RoundTrip(file), {vote2c});
+
+    file.RemoveVotesFromMasternode(outpoint2);
+    CheckVotes(file, {});
+    BOOST_CHECK(file.begin() == file.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,11 +2,15 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <crypto/hashblock.h>
 #include <crypto/siphash.h>
+#include <crypto/x16r.h>
 #include <hash.h>
+#include <primitives/block.h>
 #include <util/strencodings.h>
 #include <test/test_bitcoin.h>
 
+#include <algorithm>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -148,4 +152,152 @@ BOOST_AUTO_TEST_CASE(siphash)
     }
 }
 
+BOOST_AUTO_TEST_CASE(timetravel_permutation)
+{
+    // The direct unranking must reproduce the std::next_permutation sequence for every step
+    uint32_t expected[HASH_FUNC_COUNT];
+    for (uint32_t i = 0; i < HASH_FUNC_COUNT; i++) {
+        expected[i] = i;
+    }
+    uint32_t permutation[HASH_FUNC_COUNT];
+    for (uint32_t step = 0; step < HASH_FUNC_COUNT_PERMUTATIONS; step++) {
+        GetTimeTravelPermutation(HASH_FUNC_BASE_TIMESTAMP + step, permutation);
+        BOOST_CHECK(std::equal(permutation, permutation + HASH_FUNC_COUNT, expected));
+        // Same order again one full cycle later
+        GetTimeTravelPermutation(HASH_FUNC_BASE_TIMESTAMP + HASH_FUNC_COUNT_PERMUTATIONS + step, permutation);
+        BOOST_CHECK(std::equal(permutation, permutation + HASH_FUNC_COUNT, expected));
+        std::next_permutation(expected, expected + HASH_FUNC_COUNT);
+    }
+
+    // Timestamps before the base timestamp wrap around as unsigned arithmetic
+    uint32_t steps = (uint32_t(HASH_FUNC_BASE_TIMESTAMP - 1) - HASH_FUNC_BASE_TIMESTAMP) % HASH_FUNC_COUNT_PERMUTATIONS;
+    for (uint32_t i = 0; i < HASH_FUNC_COUNT; i++) {
+        expected[i] = i;
+    }
+    for (uint32_t i = 0; i < steps; i++) {
+        std::next_permutation(expected, expected + HASH_FUNC_COUNT);
+    }
+    GetTimeTravelPermutation(HASH_FUNC_BASE_TIMESTAMP - 1, permutation);
+    BOOST_CHECK(std::equal(permutation, permutation + HASH_FUNC_COUNT, expected));
+}
+
+BOOST_AUTO_TEST_CASE(blockheader_hash_cache)
+{
+    CBlockHeader header;
+    header.nVersion = ALGO_EXOSIS;
+    header.hashPrevBlock = InsecureRand256();
+    header.hashMerkleRoot = InsecureRand256();
+    header.nTime = HASH_FUNC_BASE_TIMESTAMP + 12345;
+    header.nBits = 0x1e0ffff0;
+    header.nNonce = 42;
+
+    const uint256 hash = HashTimeTravel(BEGIN(header.nVersion), END(header.nNonce), header.nTime);
+    BOOST_CHECK(header.GetHash() == hash);
+    BOOST_CHECK(header.GetHash() == hash);
+
+    // Copies keep the cached hash valid
+    CBlock block(header);
+    BOOST_CHECK(block.GetHash() == hash);
+    BOOST_CHECK(block.GetBlockHeader().GetHash() == hash);
+
+    // Any change to a hashed field must not return the stale hash
+    header.nNonce++;
+    BOOST_CHECK(header.GetHash() == HashTimeTravel(BEGIN(header.nVersion), END(header.nNonce), header.nTime));
+    BOOST_CHECK(header.GetHash() != hash);
+    header.nNonce--;
+    header.nTime++;
+    BOOST_CHECK(header.GetHash() == HashTimeTravel(BEGIN(header.nVersion), END(header.nNonce), header.nTime));
+    block.hashMerkleRoot = InsecureRand256();
+    BOOST_CHECK(block.GetHash() == HashTimeTravel(BEGIN(block.nVersion), END(block.nNonce), block.nTime));
+
+    // nMoneySupply is not part of the hash
+    header.nTime--;
+    header.nMoneySupply = 1;
+    BOOST_CHECK(header.GetHash() == hash);
+}
+
+BOOST_AUTO_TEST_CASE(x16r_hasher)
+{
+    const uint256 hashPrev = uint256S("0123456789abcdeffedcba98765432100000000000000000000000000000000");
+    std::vector<unsigned char> data(80);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i;
+    }
+
+    // One hasher is reused across inputs building on the same previous block
+    const X16RHasher hasher(hashPrev);
+    BOOST_CHECK_EQUAL(hasher.Hash(data.begin(), data.end()).GetHex(), "be687a5cbd13df5e4533170912370041e1bc422e1717ab3170eb99b4b6f9b660");
+    data[79] = 0xff;
+    BOOST_CHECK_EQUAL(hasher.Hash(data.begin(), data.end()).GetHex(), "126c8c8a530a340435de71960bcf9b72b6f6fae324c3008323af785436bd792d");
+    BOOST_CHECK_EQUAL(HashX16R(data.begin(), data.end(), hashPrev).GetHex(), "126c8c8a530a340435de71960bcf9b72b6f6fae324c3008323af785436bd792d");
+    std::vector<unsigned char> empty;
+    BOOST_CHECK_EQUAL(hasher.Hash(empty.begin(), empty.end()).GetHex(), "bfe0053bd371e4fd7a659a9565bff8a609a770818335a97e9b75711d006613f0");
+
+    CBlockHeader header;
+    header.nVersion = ALGO_X16R;
+    header.hashPrevBlock = hashPrev;
+    header.nNonce = 7;
+    const X16RHasher headerHasher(header.hashPrevBlock);
+    BOOST_CHECK(header.GetPoWHash(headerHasher) == header.GetPoWHash());
+    BOOST_CHECK(header.GetPoWHash() == HashX16R(BEGIN(header.nVersion), END(header.nNonce), hashPrev));
+
+    // Grinding from a checkpointed header prefix gives the same hashes for every first round algorithm
+    for (int i = 0; i < 16; i++) {
+        do {
+            header.hashPrevBlock = InsecureRand256();
+        } while (GetHashSelection(header.hashPrevBlock, 0) != i);
+        header.hashMerkleRoot = InsecureRand256();
+        X16RHasher grinder(header.hashPrevBlock);
+        grinder.SetPrefix(BEGIN(header.nVersion), X16RHasher::HEADER_PREFIX_SIZE);
+        for (header.nNonce = 0; header.nNonce < 4; header.nNonce++) {
+            BOOST_CHECK(header.GetPoWHash(grinder) == HashX16R(BEGIN(header.nVersion), END(header.nNonce), header.hashPrevBlock));
+        }
+        // Inputs not starting with the prefix fall back to the full first round
+        header.hashMerkleRoot = InsecureRand256();
+        BOOST_CHECK(header.GetPoWHash(grinder) == HashX16R(BEGIN(header.nVersion), END(header.nNonce), header.hashPrevBlock));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(x16r_lanes)
+{
+    // Accelerated implementations match the sph ones bit for bit
+    std::vector<unsigned char> in, out(X16R_LANES * 64);
+    unsigned char expected[64];
+    for (int i = 0; i < 16; i++) {
+        for (int iter = 0; iter < 32; iter++) {
+            in = g_insecure_rand_ctx.randbytes(X16R_LANES * 64);
+            if (X16RHash64[i]) {
+                X16RHash64[i](out.data(), in.data());
+                X16RHash64Generic(i, expected, in.data());
+                BOOST_CHECK(std::equal(expected, expected + 64, out.begin()));
+            }
+            if (X16RHash64Lanes[i]) {
+                X16RHash64Lanes[i](out.data(), in.data());
+                for (int lane = 0; lane < X16R_LANES; lane++) {
+                    X16RHash64Generic(i, expected, &in[lane * 64]);
+                    BOOST_CHECK(std::equal(expected, expected + 64, out.begin() + lane * 64));
+                }
+            }
+        }
+    }
+
+    // Hashing consecutive nonces together gives the same hashes as one at a time
+    CBlockHeader header;
+    header.nVersion = ALGO_X16R;
+    for (int i = 0; i < 64; i++) {
+        header.hashPrevBlock = InsecureRand256();
+        header.hashMerkleRoot = InsecureRand256();
+        header.nNonce = InsecureRand32();
+        X16RHasher hasher(header.hashPrevBlock);
+        if (i & 1) hasher.SetPrefix(BEGIN(header.nVersion), X16RHasher::HEADER_PREFIX_SIZE);
+        uint256 powHashes[X16R_LANES];
+        header.GetPoWHashes(hasher, powHashes);
+        CBlockHeader next(header);
+        for (int lane = 0; lane < X16R_LANES; lane++) {
+            next.nNonce = header.nNonce + lane;
+            BOOST_CHECK(powHashes[lane] == next.GetPoWHash());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
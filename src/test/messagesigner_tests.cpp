@@ -0,0 +1,107 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <messagesigner.h>
+#include <test/test_bitcoin.h>
+#include <validation.h>
+
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+
+namespace {
+
+void CheckBatch(size_t nChecks)
+{
+    std::vector<CKey> vKeys(nChecks);
+    std::vector<uint256> vHashes(nChecks);
+    std::vector<std::vector<unsigned char> > vSigs(nChecks);
+    for (size_t i = 0; i < nChecks; i++) {
+        vKeys[i].MakeNewKey(true);
+        vHashes[i] = InsecureRand256();
+        BOOST_REQUIRE(CHashSigner::SignHash(vHashes[i], vKeys[i], vSigs[i]));
+    }
+    // one signature of another hash
+    const size_t nBad = nChecks / 2;
+    BOOST_REQUIRE(CHashSigner::SignHash(InsecureRand256(), vKeys[nBad], vSigs[nBad]));
+
+    std::unique_ptr<bool[]> pfValid(new bool[nChecks]);
+    std::vector<CHashSignatureCheck> vChecks;
+    for (size_t i = 0; i < nChecks; i++) {
+        pfValid[i] = (i == nBad);
+        vChecks.emplace_back(vHashes[i], vKeys[i].GetPubKey(), vSigs[i], &pfValid[i]);
+    }
+    CHashSigner::VerifyHashes(vChecks);
+
+    for (size_t i = 0; i < nChecks; i++) {
+        BOOST_CHECK_EQUAL(pfValid[i], i != nBad);
+        BOOST_CHECK_EQUAL(CHashSigner::IsSignatureCached(vHashes[i], vKeys[i].GetPubKey(), vSigs[i]), i != nBad);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(messagesigner_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(messagesigner_cache_hit_miss)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CKey keyOther;
+    keyOther.MakeNewKey(true);
+    const uint256 hash = InsecureRand256();
+    std::vector<unsigned char> vchSig;
+    BOOST_REQUIRE(CHashSigner::SignHash(hash, key, vchSig));
+    std::string strError;
+
+    // miss, then hit
+    BOOST_CHECK(!CHashSigner::IsSignatureCached(hash, key.GetPubKey(), vchSig));
+    BOOST_CHECK(CHashSigner::VerifyHash(hash, key.GetPubKey(), vchSig, strError));
+    BOOST_CHECK(CHashSigner::IsSignatureCached(hash, key.GetPubKey(), vchSig));
+    BOOST_CHECK(CHashSigner::VerifyHash(hash, key.GetPubKey(), vchSig, strError));
+
+    // the cached entry does not cover another key, hash or signature
+    BOOST_CHECK(!CHashSigner::VerifyHash(hash, keyOther.GetPubKey(), vchSig, strError));
+    BOOST_CHECK(!CHashSigner::IsSignatureCached(hash, keyOther.GetPubKey(), vchSig));
+    const uint256 hashOther = InsecureRand256();
+    BOOST_CHECK(!CHashSigner::VerifyHash(hashOther, key.GetPubKey(), vchSig, strError));
+    BOOST_CHECK(!CHashSigner::IsSignatureCached(hashOther, key.GetPubKey(), vchSig));
+    std::vector<unsigned char> vchSigBad(vchSig);
+    vchSigBad[10] ^= 0x01;
+    BOOST_CHECK(!CHashSigner::VerifyHash(hash, key.GetPubKey(), vchSigBad, strError));
+    BOOST_CHECK(!CHashSigner::IsSignatureCached(hash, key.GetPubKey(), vchSigBad));
+
+    // messages are cached under their message hash
+    const std::string strMessage = "messagesigner_cache_hit_miss";
+    std::vector<unsigned char> vchMessageSig;
+    BOOST_REQUIRE(CMessageSigner::SignMessage(strMessage, vchMessageSig, key));
+    BOOST_CHECK(!CHashSigner::IsSignatureCached(CMessageSigner::GetMessageHash(strMessage), key.GetPubKey(), vchMessageSig));
+    BOOST_CHECK(CMessageSigner::VerifyMessage(key.GetPubKey(), vchMessageSig, strMessage, strError));
+    BOOST_CHECK(CHashSigner::IsSignatureCached(CMessageSigner::GetMessageHash(strMessage), key.GetPubKey(), vchMessageSig));
+}
+
+BOOST_AUTO_TEST_CASE(messagesigner_verify_hashes)
+{
+    const int nScriptCheckThreadsOld = nScriptCheckThreads;
+
+    // on the calling thread only
+    nScriptCheckThreads = 0;
+    CheckBatch(16);
+
+    // on the signature check threads
+    nScriptCheckThreads = 3;
+    boost::thread_group threadGroup;
+    for (int i = 0; i < nScriptCheckThreads - 1; i++) {
+        threadGroup.create_thread(&ThreadMessageSignatureCheck);
+    }
+    CheckBatch(16);
+    CheckBatch(1);
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+
+    nScriptCheckThreads = nScriptCheckThreadsOld;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -370,4 +370,30 @@ BOOST_AUTO_TEST_CASE(class_methods)
     BOOST_CHECK(methodtest3 == methodtest4);
 }
 
+BOOST_AUTO_TEST_CASE(unordered_map)
+{
+    std::unordered_map<int, std::string> mapIn;
+    for (int i = 0; i < 100; i++) {
+        mapIn.emplace(i * 7, std::to_string(i));
+    }
+
+    // Same encoding as std::map, so the two can read each other
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    ss << mapIn;
+    std::map<int, std::string> mapOrdered;
+    ss >> mapOrdered;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK_EQUAL(mapOrdered.size(), mapIn.size());
+    for (const auto& entry : mapOrdered) {
+        BOOST_CHECK(mapIn.at(entry.first) == entry.second);
+    }
+
+    ss << mapOrdered;
+    std::unordered_map<int, std::string> mapOut;
+    mapOut.emplace(-1, "stale");
+    ss >> mapOut;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(mapOut == mapIn);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
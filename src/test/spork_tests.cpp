@@ -0,0 +1,93 @@
+// Copyright (c) 2019 EXOSIS developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <spork.h>
+#include <sporkdb.h>
+#include <test/test_bitcoin.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(spork_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(spork_defaults)
+{
+    CSporkManager manager;
+
+    BOOST_CHECK_EQUAL(manager.GetSporkValue(SPORK_5_INSTANTSEND_MAX_VALUE), SPORK_5_INSTANTSEND_MAX_VALUE_DEFAULT);
+    BOOST_CHECK_EQUAL(manager.GetSporkValue(SPORK_EXOSIS_05_FIX_HEIGHT), SPORK_EXOSIS_05_FIX_HEIGHT_DEFAULT);
+    BOOST_CHECK(manager.IsSporkActive(SPORK_2_INSTANTSEND_ENABLED));
+    BOOST_CHECK(!manager.IsSporkActive(SPORK_8_MASTERNODE_PAYMENT_ENFORCEMENT));
+
+    // unused IDs inside and outside of the known ranges
+    BOOST_CHECK_EQUAL(manager.GetSporkValue(SPORK_START + 2), -1);
+    BOOST_CHECK_EQUAL(manager.GetSporkValue(SPORK_EXOSIS_END + 1), -1);
+    BOOST_CHECK(!manager.IsSporkActive(SPORK_EXOSIS_END + 1));
+}
+
+BOOST_AUTO_TEST_CASE(spork_snapshot_publish)
+{
+    pSporkDB.reset(new CSporkDB(0, true));
+
+    CSporkMessage spork(SPORK_5_INSTANTSEND_MAX_VALUE, 42, GetTime());
+    BOOST_CHECK(pSporkDB->WriteSpork(spork.nSporkID, spork));
+
+    CSporkManager manager;
+    BOOST_CHECK(!manager.HasSpork(spork.GetHash()));
+    manager.LoadSporksFromDB();
+
+    // the new value is published, the other sporks keep their defaults
+    BOOST_CHECK_EQUAL(manager.GetSporkValue(SPORK_5_INSTANTSEND_MAX_VALUE), 42);
+    BOOST_CHECK_EQUAL(manager.GetSporkValue(SPORK_EXOSIS_05_FIX_HEIGHT), SPORK_EXOSIS_05_FIX_HEIGHT_DEFAULT);
+
+    CSporkMessage sporkRet;
+    BOOST_CHECK(manager.HasSpork(spork.GetHash()));
+    BOOST_CHECK(manager.GetSporkByHash(spork.GetHash(), sporkRet));
+    BOOST_CHECK_EQUAL(sporkRet.nValue, 42);
+    BOOST_CHECK(!manager.GetSporkByHash(uint256(), sporkRet));
+
+    pSporkDB.reset();
+}
+
+BOOST_AUTO_TEST_CASE(spork_snapshot_concurrent_read)
+{
+    pSporkDB.reset(new CSporkDB(0, true));
+
+    CSporkManager manager;
+    std::atomic<bool> fStop(false);
+    std::atomic<int> nBadReads(0);
+
+    // readers only ever see the default or one of the published values
+    std::vector<std::thread> vReaders;
+    for (int i = 0; i < 3; i++) {
+        vReaders.emplace_back([&] {
+            while (!fStop) {
+                int64_t nValue = manager.GetSporkValue(SPORK_5_INSTANTSEND_MAX_VALUE);
+                if (nValue != SPORK_5_INSTANTSEND_MAX_VALUE_DEFAULT && (nValue < 1 || nValue > 100)) {
+                    ++nBadReads;
+                }
+            }
+        });
+    }
+
+    for (int64_t nValue = 1; nValue <= 100; nValue++) {
+        CSporkMessage spork(SPORK_5_INSTANTSEND_MAX_VALUE, nValue, GetTime() + nValue);
+        BOOST_CHECK(pSporkDB->WriteSpork(spork.nSporkID, spork));
+        manager.LoadSporksFromDB();
+        BOOST_CHECK_EQUAL(manager.GetSporkValue(SPORK_5_INSTANTSEND_MAX_VALUE), nValue);
+    }
+
+    fStop = true;
+    for (std::thread& thread : vReaders) {
+        thread.join();
+    }
+    BOOST_CHECK_EQUAL(nBadReads, 0);
+
+    pSporkDB.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
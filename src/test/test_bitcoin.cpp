@@ -10,6 +10,7 @@
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <crypto/sha256.h>
+#include <crypto/x16r.h>
 #include <miner.h>
 #include <net_processing.h>
 #include <noui.h>
@@ -35,6 +36,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
     : m_path_root(fs::temp_directory_path() / "test_bitcoin" / strprintf("%lu_%i", (unsigned long)GetTime(), (int)(InsecureRandRange(1 << 30))))
 {
     SHA256AutoDetect();
+    X16RAutoDetect();
     ECC_Start();
     SetupEnvironment();
     SetupNetworking();
@@ -149,7 +151,9 @@ TestChain100Setup::CreateAndProcessBlock(const std::vector<CMutableTransaction>&
 
     // EXOSIS BEGIN
     //while (!CheckProofOfWork(block.GetHash(), block.nBits, chainparams.GetConsensus())) ++block.nNonce;
-    while (!CheckProofOfWork(block.GetPoWHash(), block.nBits, chainparams.GetConsensus())) ++block.nNonce;
+    X16RHasher hasher(block.hashPrevBlock);
+    hasher.SetPrefix(BEGIN(block.nVersion), X16RHasher::HEADER_PREFIX_SIZE);
+    while (!CheckProofOfWork(block.GetPoWHash(hasher), block.nBits, chainparams.GetConsensus())) ++block.nNonce;
     // EXOSIS END
 
     std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(block);
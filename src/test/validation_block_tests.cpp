@@ -13,6 +13,7 @@
 #include <pow.h>
 #include <random.h>
 #include <test/test_bitcoin.h>
+#include <txdb.h>
 #include <validation.h>
 #include <validationinterface.h>
 
@@ -186,4 +187,106 @@ BOOST_AUTO_TEST_CASE(processnewblock_signals_ordering)
     BOOST_CHECK_EQUAL(sub.m_expected_tip, chainActive.Tip()->GetBlockHash());*/
 }
 
+// EXOSIS BEGIN
+BOOST_AUTO_TEST_CASE(processnewblockheaders_precheck)
+{
+    const CBlockHeader genesis = Params().GenesisBlock().GetBlockHeader();
+
+    // A header whose proof of work cannot meet its own target
+    CBlockHeader bad = genesis;
+    bad.hashPrevBlock = genesis.GetHash();
+    bad.nTime = genesis.nTime + 1;
+    bad.nBits = 0x03000001;
+
+    // Known headers are accepted without being checked again
+    CValidationState state;
+    const CBlockIndex* pindex = nullptr;
+    BOOST_CHECK(ProcessNewBlockHeaders({genesis, genesis}, state, Params(), &pindex));
+    BOOST_CHECK(pindex != nullptr && pindex->GetBlockHash() == genesis.GetHash());
+
+    // The failed pre-check is reported the same way as before, on the first invalid header
+    CBlockHeader first_invalid;
+    BOOST_CHECK(!ProcessNewBlockHeaders({genesis, bad, genesis}, state, Params(), &pindex, &first_invalid));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+    BOOST_CHECK_EQUAL(first_invalid.GetHash(), bad.GetHash());
+
+    // Hashing stops early on a long batch, the rejection stays on the first invalid header
+    std::vector<CBlockHeader> headers{genesis, bad};
+    for (int i = 0; i < 300; i++) {
+        CBlockHeader next = headers.back();
+        next.hashPrevBlock = headers.back().GetHash();
+        next.nTime++;
+        headers.push_back(next);
+    }
+    BOOST_CHECK(!ProcessNewBlockHeaders(headers, state, Params(), &pindex, &first_invalid));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+    BOOST_CHECK_EQUAL(first_invalid.GetHash(), bad.GetHash());
+    BOOST_CHECK(LookupBlockIndex(headers.back().GetHash()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(loadblockindex_pow_verified)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    // An accepted header is flagged, in agreement with a full proof-of-work check
+    CBlockHeader good = Block(Params().GenesisBlock().GetHash())->GetBlockHeader();
+    {
+        LOCK(cs_main);
+        good.nBits = GetNextWorkRequired(chainActive.Tip(), &good, consensusParams);
+    }
+    while (!CheckProofOfWork(good.GetPoWHash(), good.nBits, consensusParams)) {
+        ++good.nNonce;
+    }
+    CValidationState state;
+    const CBlockIndex* pindex = nullptr;
+    BOOST_CHECK(ProcessNewBlockHeaders({good}, state, Params(), &pindex));
+    BOOST_CHECK(pindex != nullptr && (pindex->nStatus & BLOCK_POW_VERIFIED));
+    BOOST_CHECK(CheckProofOfWork(pindex->GetBlockPoWHash(), pindex->nBits, consensusParams));
+
+    // A block index with an unflagged valid header and a flagged header failing its proof of work
+    CBlockHeader bad = good;
+    bad.hashPrevBlock = good.GetHash();
+    bad.nTime++;
+    bad.nBits = 0x03000001;
+    const uint256 hash_good = good.GetHash();
+    const uint256 hash_bad = bad.GetHash();
+    CBlockIndex index_good(good);
+    index_good.phashBlock = &hash_good;
+    index_good.pprev = pindex->pprev;
+    index_good.nHeight = 1;
+    index_good.nStatus = BLOCK_VALID_TREE;
+    CBlockIndex index_bad(bad);
+    index_bad.phashBlock = &hash_bad;
+    index_bad.pprev = &index_good;
+    index_bad.nHeight = 2;
+    index_bad.nStatus = BLOCK_VALID_TREE | BLOCK_POW_VERIFIED;
+
+    CBlockTreeDB db(1 << 20, true);
+    BOOST_CHECK(db.WriteBatchSync({}, 0, {&index_good, &index_bad}));
+
+    std::map<uint256, std::unique_ptr<CBlockIndex>> loaded;
+    auto insertBlockIndex = [&loaded](const uint256& hash) -> CBlockIndex* {
+        if (hash.IsNull()) return nullptr;
+        auto it = loaded.emplace(hash, nullptr).first;
+        if (!it->second) {
+            it->second.reset(new CBlockIndex());
+            it->second->phashBlock = &it->first;
+        }
+        return it->second.get();
+    };
+
+    // Only the unflagged header has its proof of work computed again
+    std::vector<CBlockIndex*> vPoWVerified;
+    BOOST_CHECK(db.LoadBlockIndexGuts(consensusParams, insertBlockIndex, false, vPoWVerified));
+    BOOST_CHECK_EQUAL(vPoWVerified.size(), 1U);
+    BOOST_CHECK(vPoWVerified.size() == 1 && vPoWVerified[0]->GetBlockHash() == hash_good);
+
+    // -checkblockindexpow gives the baseline result, which checked every header
+    loaded.clear();
+    vPoWVerified.clear();
+    BOOST_CHECK(!db.LoadBlockIndexGuts(consensusParams, insertBlockIndex, true, vPoWVerified));
+    BOOST_CHECK_EQUAL(vPoWVerified.size(), 2U);
+}
+// EXOSIS END
+
 BOOST_AUTO_TEST_SUITE_END()
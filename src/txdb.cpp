@@ -16,6 +16,9 @@
 
 #include <stdint.h>
 
+#include <atomic>
+#include <thread>
+
 #include <boost/thread.hpp>
 
 static const char DB_COIN = 'C';
@@ -246,7 +249,48 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
-bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
+// EXOSIS BEGIN
+/** Verify the proof-of-work of block index entries on all cores.
+ *  Returns the position in vIndex of the first entry that fails, or vIndex.size() if all pass.
+ */
+static size_t CheckBlockIndexPoW(const std::vector<CBlockIndex*>& vIndex, const Consensus::Params& consensusParams)
+{
+    static const size_t BATCH_SIZE = 256;
+
+    // Batches are claimed in order, and a batch is only skipped when it starts beyond an
+    // already found failure, so every entry before the reported one has been checked.
+    std::atomic<size_t> nNext(0);
+    std::atomic<size_t> nFirstFailed(vIndex.size());
+    auto worker = [&]() {
+        while (true) {
+            const size_t nStart = nNext.fetch_add(BATCH_SIZE);
+            if (nStart >= nFirstFailed.load()) return;
+            const size_t nEnd = std::min(nStart + BATCH_SIZE, vIndex.size());
+            for (size_t i = nStart; i < nEnd; i++) {
+                if (!CheckProofOfWork(vIndex[i]->GetBlockPoWHash(), vIndex[i]->nBits, consensusParams)) {
+                    size_t nFailed = nFirstFailed.load();
+                    while (i < nFailed && !nFirstFailed.compare_exchange_weak(nFailed, i)) {}
+                    break;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> vThreads;
+    const size_t nThreads = std::min<size_t>(std::max(GetNumCores(), 1), (vIndex.size() + BATCH_SIZE - 1) / BATCH_SIZE);
+    for (size_t i = 1; i < nThreads; i++) {
+        vThreads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : vThreads) {
+        thread.join();
+    }
+
+    return nFirstFailed.load();
+}
+// EXOSIS END
+
+bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool fCheckAllPoW, std::vector<CBlockIndex*>& vPoWVerified)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
@@ -278,10 +322,12 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 // EXOSIS END
 
                 // Exosis BEGIN
-                if (pindexNew->nHeight > consensusParams.nlastValidPowHashHeight)
+                // Headers already verified when they were accepted (or on an earlier load) are
+                // trusted unless -checkblockindexpow asks for full re-verification. The others
+                // are verified in parallel once the scan is complete.
+                if (pindexNew->nHeight > consensusParams.nlastValidPowHashHeight && (fCheckAllPoW || !(pindexNew->nStatus & BLOCK_POW_VERIFIED)))
+                    vPoWVerified.push_back(pindexNew);
                 // EXOSIS END
-                if (!CheckProofOfWork(pindexNew->GetBlockPoWHash(), pindexNew->nBits, consensusParams))
-                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
 
                 pcursor->Next();
             } else {
@@ -292,6 +338,13 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         }
     }
 
+    // EXOSIS BEGIN
+    // Every entry is linked to its parent now, so the headers can be rebuilt concurrently
+    const size_t nFailed = CheckBlockIndexPoW(vPoWVerified, consensusParams);
+    if (nFailed < vPoWVerified.size())
+        return error("%s: CheckProofOfWork failed: %s", __func__, vPoWVerified[nFailed]->ToString());
+    // EXOSIS END
+
     return true;
 }
 
@@ -95,7 +95,10 @@ public:
     void ReadReindexing(bool &fReindexing);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    // EXOSIS BEGIN
+    //! Entries whose proof-of-work had to be verified during the load are appended to vPoWVerified
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, bool fCheckAllPoW, std::vector<CBlockIndex*>& vPoWVerified);
+    // EXOSIS END
 };
 
 #endif // BITCOIN_TXDB_H
@@ -24,6 +24,9 @@
 #include <primitives/transaction.h>
 #include <sync.h>
 #include <random.h>
+// EXOSIS BEGIN
+#include <util/hasher.h>
+// EXOSIS END
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -370,19 +373,21 @@ enum class MemPoolRemovalReason {
     REPLACED,    //!< Removed for replacement
 };
 
-class SaltedTxidHasher
-{
-private:
-    /** Salt */
-    const uint64_t k0, k1;
-
-public:
-    SaltedTxidHasher();
-
-    size_t operator()(const uint256& txid) const {
-        return SipHashUint256(k0, k1, txid);
-    }
-};
+// EXOSIS BEGIN
+//class SaltedTxidHasher
+//{
+//private:
+//    /** Salt */
+//    const uint64_t k0, k1;
+//
+//public:
+//    SaltedTxidHasher();
+//
+//    size_t operator()(const uint256& txid) const {
+//        return SipHashUint256(k0, k1, txid);
+//    }
+//};
+// EXOSIS END
 
 /**
  * CTxMemPool stores valid-according-to-the-current-best-chain transactions
@@ -1279,6 +1279,32 @@ int GetNumCores()
     return std::thread::hardware_concurrency();
 }
 
+// EXOSIS BEGIN
+void ParallelForEach(size_t nCount, size_t nBatchSize, const std::function<void(size_t)>& func)
+{
+    std::atomic<size_t> nNext(0);
+    auto worker = [&]() {
+        size_t nStart;
+        while ((nStart = nNext.fetch_add(nBatchSize)) < nCount) {
+            const size_t nEnd = std::min(nStart + nBatchSize, nCount);
+            for (size_t i = nStart; i < nEnd; i++) {
+                func(i);
+            }
+        }
+    };
+
+    std::vector<std::thread> vThreads;
+    const size_t nThreads = std::min<size_t>(std::max(GetNumCores(), 1), (nCount + nBatchSize - 1) / nBatchSize);
+    for (size_t i = 1; i < nThreads; i++) {
+        vThreads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : vThreads) {
+        thread.join();
+    }
+}
+// EXOSIS END
+
 std::string CopyrightHolders(const std::string& strPrefix)
 {
     // EXOSIS BEGIN
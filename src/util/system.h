@@ -29,6 +29,9 @@
 
 #include <atomic>
 #include <exception>
+// EXOSIS BEGIN
+#include <functional>
+// EXOSIS END
 #include <map>
 #include <set>
 #include <stdint.h>
@@ -360,6 +363,11 @@ std::string HelpMessageOpt(const std::string& option, const std::string& message
  */
 int GetNumCores();
 
+// EXOSIS BEGIN
+/** Run func(i) for every i in [0, nCount) on up to GetNumCores() threads, in batches of nBatchSize. */
+void ParallelForEach(size_t nCount, size_t nBatchSize, const std::function<void(size_t)>& func);
+// EXOSIS END
+
 void RenameThread(const char* name);
 
 /**
@@ -57,6 +57,7 @@
 #include <masternode-sync.h>
 #include <masternode-payments.h>
 
+#include <deque>
 #include <future>
 #include <sstream>
 
@@ -179,8 +180,9 @@ public:
     /**
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to mapBlockIndex.
+     * fPoWChecked skips the proof-of-work check when the caller has already done it.
      */
-    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fPoWChecked = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Block (dis)connection on a given view:
@@ -259,6 +261,9 @@ bool fPruneMode = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
+// EXOSIS BEGIN
+bool fCheckBlockIndexPoW = DEFAULT_CHECKBLOCKINDEXPOW;
+// EXOSIS END
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
@@ -1710,6 +1715,11 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         return DISCONNECT_FAILED;
     }
 
+    // EXOSIS BEGIN
+    // Masternode collaterals spent by each transaction, taken from the undo data (in reverse input order)
+    std::vector<std::vector<std::pair<COutPoint, CTxOut> > > vSpentCollaterals(block.vtx.size());
+    // EXOSIS END
+
     // undo transactions in reverse order
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction &tx = *(block.vtx[i]);
@@ -1738,6 +1748,11 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
             }
             for (unsigned int j = tx.vin.size(); j-- > 0;) {
                 const COutPoint &out = tx.vin[j].prevout;
+                // EXOSIS BEGIN
+                const CTxOut& txout = txundo.vprevout[j].out;
+                if (txout.nValue == 100000 * COIN && txout.GetMasternodeIP() != "")
+                    vSpentCollaterals[i].emplace_back(out, txout);
+                // EXOSIS END
                 int res = ApplyTxInUndo(std::move(txundo.vprevout[j]), view, out);
                 if (res == DISCONNECT_FAILED) return DISCONNECT_FAILED;
                 fClean = fClean && res != DISCONNECT_UNCLEAN;
@@ -1755,24 +1770,16 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         const CTransaction &tx = *(block.vtx[i]);
         if (!tx.IsCoinBase())
         {
-            for (unsigned int o = 0; o < tx.vin.size(); o++)
+            // spent collaterals come from the undo data, no need to look the previous transactions up
+            for (auto it = vSpentCollaterals[i].rbegin(); it != vSpentCollaterals[i].rend(); ++it)
             {
-                const COutPoint outpoint = tx.vin[o].prevout;
-                CTransactionRef prevtxref;
-                uint256 prevhash;
-                if (GetTransaction(outpoint.hash, prevtxref, Params().GetConsensus(), prevhash))
+                const COutPoint& outpoint = it->first;
+                const CTxOut& txout = it->second;
+                CService service(LookupNumeric(txout.GetMasternodeIP().c_str(), Params().GetDefaultPort()));
+                if (CAddress(service, NODE_NETWORK).IsRoutable())
                 {
-                    const CTransaction &prevtx = *(prevtxref);
-                    const CTxOut txout = prevtx.vout[outpoint.n];
-                    if (txout.nValue == 100000 * COIN && txout.masternodeIP != "")
-                    {
-                        CService service(LookupNumeric(txout.masternodeIP.c_str(), Params().GetDefaultPort()));
-                        if (CAddress(service, NODE_NETWORK).IsRoutable())
-                        {
-                            CMasternode mn(service, outpoint, txout.pubKeyMN, txout.pubKeyMN, PROTOCOL_VERSION);
-                            mnodeman.Add(mn);
-                        }
-                    }
+                    CMasternode mn(service, outpoint, txout.GetPubKeyMN(), txout.GetPubKeyMN(), PROTOCOL_VERSION);
+                    mnodeman.Add(mn);
                 }
             }
             for (unsigned int o = 0; o < tx.vout.size(); o++)
@@ -2225,19 +2232,11 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     if (pindex->nHeight == 1)
         mnodeman.Clear(); // Clear masternode list on reindex
 
-    std::map<COutPoint, CMasternode> mapMasternodes = mnodeman.GetFullMasternodeMap();
+    // masternodes already matched to an output, to not validate same MN multiple times
+    std::set<COutPoint> setPaidMasternodes;
 
-    int nNoMasternodes = 0;
-    {
-        std::map<COutPoint, CMasternode>::iterator mnit = mapMasternodes.begin();
-        while (mnit != mapMasternodes.end()) {
-            if (mnit->second.IsEnabled())
-            {
-                nNoMasternodes++;
-            }
-            ++mnit;
-        }
-    }
+    // all enabled masternodes, whatever their protocol version
+    int nNoMasternodes = mnodeman.CountEnabled(0);
 
     // check all coinbase txs
     CAmount minerReward = 0;
@@ -2262,33 +2261,22 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
                 if (tx.vout[i].nValue == masternodePayment)
                 {
-                    //if (!masternodeSync.IsSynced())
+                    // check in masternode list, the first not yet paid masternode with this payee decides
+                    masternode_info_t mnInfo;
+                    if (mnodeman.GetMasternodeInfo(tx.vout[i].scriptPubKey, setPaidMasternodes, mnInfo))
                     {
-                        // masternode list not synced yet, let's assume it is masternode payment because of correct value
-                    //    fMasternode = true;
-                    //} else {
-                        // check in masternode list
-                        std::map<COutPoint, CMasternode>::iterator mnit = mapMasternodes.begin();
-                        while (!fMasternode && mnit != mapMasternodes.end()) {
-                            if (tx.vout[i].scriptPubKey == GetScriptForDestination(mnit->second.pubKeyCollateralAddress.GetID()))
-                            {
-                                if (mnit->second.IsEnabled())
-                                {
-                                    fMasternode = true;
-
-                                    // remove from list to not validate same MN multiple times
-                                    mapMasternodes.erase(mnit++);
-
-                                    //passed collateral check
-                                    LogPrint(BCLog::ALL, "Validation pass: tx.vout[%d].scriptPubKey.ToString() = %s\n", i, addressOutput);
-                                } else {
-                                    //failed collateral check
-                                    LogPrint(BCLog::ALL, "Validation fail: tx.vout[%d].scriptPubKey.ToString() = %s\n", i, addressOutput);
-                                    return state.DoS(100, error("%s: coinbase pays invalid masternode %s", __func__, addressOutput), REJECT_INVALID, "bad-masternode-cb-invalid");
-                                }
-                            } else {
-                                ++mnit;
-                            }
+                        if (mnInfo.nActiveState == CMasternode::MASTERNODE_ENABLED)
+                        {
+                            fMasternode = true;
+
+                            setPaidMasternodes.insert(mnInfo.vin.prevout);
+
+                            //passed collateral check
+                            LogPrint(BCLog::ALL, "Validation pass: tx.vout[%d].scriptPubKey.ToString() = %s\n", i, addressOutput);
+                        } else {
+                            //failed collateral check
+                            LogPrint(BCLog::ALL, "Validation fail: tx.vout[%d].scriptPubKey.ToString() = %s\n", i, addressOutput);
+                            return state.DoS(100, error("%s: coinbase pays invalid masternode %s", __func__, addressOutput), REJECT_INVALID, "bad-masternode-cb-invalid");
                         }
                     }
                 }
@@ -2358,12 +2346,12 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
             {
                 const COutPoint outpoint(tx.GetHash(), o);
                 const CTxOut txout = tx.vout[o];
-                if (txout.nValue == 100000 * COIN && txout.masternodeIP != "")
+                if (txout.nValue == 100000 * COIN && txout.GetMasternodeIP() != "")
                 {
-                    CService service(LookupNumeric(txout.masternodeIP.c_str(), Params().GetDefaultPort()));
+                    CService service(LookupNumeric(txout.GetMasternodeIP().c_str(), Params().GetDefaultPort()));
                     if (CAddress(service, NODE_NETWORK).IsRoutable())
                     {
-                        CMasternode mn(service, outpoint, txout.pubKeyMN, txout.pubKeyMN, PROTOCOL_VERSION);
+                        CMasternode mn(service, outpoint, txout.GetPubKeyMN(), txout.GetPubKeyMN(), PROTOCOL_VERSION);
                         mnodeman.Add(mn);
                     }
                 }
@@ -3315,6 +3303,10 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
     pindexNew->nChainWorkX16R = (pindexNew->pprev ? pindexNew->pprev->nChainWorkX16R : 0) + (((pindexNew->nVersion & ALGO_VERSION_MASK) == ALGO_X16R) ? GetBlockProof(*pindexNew) : 0);
     // EXOSIS END
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);
+    // EXOSIS BEGIN
+    // Callers checked the header's proof-of-work before adding it
+    pindexNew->nStatus |= BLOCK_POW_VERIFIED;
+    // EXOSIS END
     if (pindexBestHeader == nullptr || pindexBestHeader->nChainWork < pindexNew->nChainWork)
         pindexBestHeader = pindexNew;
 
@@ -3737,7 +3729,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fPoWChecked)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3755,7 +3747,10 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        // EXOSIS BEGIN
+        //if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), !fPoWChecked))
+        // EXOSIS END
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3822,15 +3817,100 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
     return true;
 }
 
+// EXOSIS BEGIN
+/**
+ * Pre-check a headers batch, taking cs_main only for the index lookups and the contextual
+ * checks. The cheap checks (linkage to the previous header, difficulty bits, timestamps)
+ * run first; proof of work is only hashed for headers that passed them, in chunks that
+ * double in size so that a bad header early in the batch stops the hashing soon. The result
+ * tells, per header, whether its proof of work has been verified; everything from the first
+ * failing header on is left for AcceptBlockHeader to reject.
+ */
+static std::vector<unsigned char> PreCheckBlockHeaders(const std::vector<CBlockHeader>& headers, const CChainParams& chainparams) LOCKS_EXCLUDED(cs_main)
+{
+    static const size_t BATCH_SIZE = 16;
+    static const size_t MAX_CHUNK_SIZE = 256;
+
+    // Not a vector<bool>: the workers write neighbouring entries concurrently
+    std::vector<unsigned char> vPoWChecked(headers.size(), false);
+
+    // Index entries of the unknown headers, chained like AcceptBlockHeader would chain them
+    // so the contextual checks can run before anything is accepted. They never enter
+    // mapBlockIndex; a deque keeps them at stable addresses for pprev.
+    std::deque<CBlockIndex> vPending;
+    CBlockIndex* pindexPrev = nullptr;
+
+    bool fFailed = false;
+    for (size_t nBegin = 0, nChunk = 1; nBegin < headers.size() && !fFailed; nBegin += nChunk, nChunk = std::min(nChunk * 2, MAX_CHUNK_SIZE)) {
+        const size_t nEnd = std::min(nBegin + nChunk, headers.size());
+        ParallelForEach(nEnd - nBegin, BATCH_SIZE, [&](size_t i) { headers[nBegin + i].GetHash(); });
+
+        std::vector<size_t> vUnknown;
+        {
+            LOCK(cs_main);
+            const int64_t nAdjustedTime = GetAdjustedTime();
+            for (size_t i = nBegin; i < nEnd && !fFailed; i++) {
+                const CBlockHeader& header = headers[i];
+                if (i > 0 && header.hashPrevBlock != headers[i - 1].GetHash()) {
+                    fFailed = true;
+                    break;
+                }
+
+                CBlockIndex* pindex = LookupBlockIndex(header.GetHash());
+                if (pindex) {
+                    fFailed = pindex->nStatus & BLOCK_FAILED_MASK;
+                    pindexPrev = pindex;
+                    continue;
+                }
+
+                if (pindexPrev == nullptr)
+                    pindexPrev = LookupBlockIndex(header.hashPrevBlock);
+                CValidationState dummy;
+                if (pindexPrev == nullptr || (pindexPrev->nStatus & BLOCK_FAILED_MASK) ||
+                    !ContextualCheckBlockHeader(header, dummy, chainparams, pindexPrev, nAdjustedTime)) {
+                    fFailed = true;
+                    break;
+                }
+
+                vPending.emplace_back(header);
+                pindex = &vPending.back();
+                pindex->pprev = pindexPrev;
+                pindex->nHeight = pindexPrev->nHeight + 1;
+                pindexPrev = pindex;
+                vUnknown.push_back(i);
+            }
+        }
+
+        ParallelForEach(vUnknown.size(), BATCH_SIZE, [&](size_t i) {
+            const CBlockHeader& header = headers[vUnknown[i]];
+            vPoWChecked[vUnknown[i]] = CheckProofOfWork(header.GetPoWHash(), header.nBits, chainparams.GetConsensus());
+        });
+        for (size_t i : vUnknown)
+            fFailed = fFailed || !vPoWChecked[i];
+    }
+    return vPoWChecked;
+}
+// EXOSIS END
+
 // Exposed wrapper for AcceptBlockHeader
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+    // EXOSIS BEGIN
+    const std::vector<unsigned char> vPoWChecked = PreCheckBlockHeaders(headers, chainparams);
+    // EXOSIS END
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        // EXOSIS BEGIN
+        //for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
+        // EXOSIS END
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            // EXOSIS BEGIN
+            //if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex, vPoWChecked[i])) {
+            // EXOSIS END
                 if (first_invalid) *first_invalid = header;
                 return false;
             }
@@ -4296,9 +4376,23 @@ CBlockIndex * CChainState::InsertBlockIndex(const uint256& hash)
 
 bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlockTreeDB& blocktree)
 {
-    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }))
+    // EXOSIS BEGIN
+    std::vector<CBlockIndex*> vPoWVerified;
+    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, fCheckBlockIndexPoW, vPoWVerified))
         return false;
 
+    // Remember verified proof-of-work so the next startup can skip it. This also
+    // upgrades databases written before BLOCK_POW_VERIFIED existed.
+    for (CBlockIndex* pindex : vPoWVerified) {
+        if (!(pindex->nStatus & BLOCK_POW_VERIFIED)) {
+            pindex->nStatus |= BLOCK_POW_VERIFIED;
+            setDirtyBlockIndex.insert(pindex);
+        }
+    }
+    if (!vPoWVerified.empty())
+        LogPrintf("%s: verified proof-of-work of %u block index entries\n", __func__, vPoWVerified.size());
+    // EXOSIS END
+
     // Calculate nChainWork
     std::vector<std::pair<int, CBlockIndex*> > vSortedByHeight;
     vSortedByHeight.reserve(mapBlockIndex.size());
@@ -168,6 +168,9 @@ extern int nScriptCheckThreads;
 extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
+// EXOSIS BEGIN
+extern bool fCheckBlockIndexPoW;
+// EXOSIS END
 extern bool fCheckpointsEnabled;
 extern size_t nCoinCacheUsage;
 /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
@@ -211,6 +214,10 @@ static const unsigned int NODE_NETWORK_LIMITED_MIN_BLOCKS = 288;
 
 static const signed int DEFAULT_CHECKBLOCKS = 6;
 static const unsigned int DEFAULT_CHECKLEVEL = 3;
+// EXOSIS BEGIN
+/** Default for -checkblockindexpow, re-verify every header's proof-of-work when loading the block index */
+static const bool DEFAULT_CHECKBLOCKINDEXPOW = false;
+// EXOSIS END
 
 // Require that user allocate at least 550 MiB for block & undo files (blk???.dat and rev???.dat)
 // At 1MB per block, 288 blocks = 288MB.